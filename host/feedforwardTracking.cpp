@@ -0,0 +1,211 @@
+/**
+ * Compares how closely the drivetrain follows a motion profile with the motors' internal velocity
+ * controllers and with FeedforwardSkidSteerModel, in a simulated drivetrain on the desktop.
+ *
+ * This file is not part of the robot build (the PROS Makefile only builds src/). Build it with:
+ *
+ * g++ -std=gnu++17 -O2 -pthread -DTHREADS_STD -iquote include -iquote include/okapi/squiggles \
+ *   host/feedforwardTracking.cpp \
+ *   src/spooder/api/chassis/model/feedforwardSkidSteerModel.cpp \
+ *   src/spooder/api/control/feedforward/feedforwardVelocityController.cpp \
+ *   src/spooder/api/control/util/systemCharacterizer.cpp \
+ *   src/spooder/api/control/util/drivetrainSimulator.cpp \
+ *   src/spooder/api/device/motor/simulatedMotor.cpp \
+ *   src/spooder/api/device/rotarysensor/simulatedEncoder.cpp \
+ *   src/spooder/api/util/simulatedTime.cpp src/spooder/api/util/telemetry.cpp \
+ *   $(find $OKAPI/src/api -name '*.cpp') -o feedforwardTracking
+ *
+ * Usage: ./feedforwardTracking [kP kI]
+ *
+ * The drivetrain is first characterized with SystemCharacterizer, the same way as on the robot.
+ * Each profile is then followed the way AsyncMotionProfileController follows it: a new velocity
+ * for each side every 10 ms through ChassisModel::left() and right(). kP and kI are the trim
+ * gains in volts per motor RPM.
+ */
+#include "okapi/api/chassis/model/skidSteerModel.hpp"
+#include "spooder/api/chassis/model/feedforwardSkidSteerModel.hpp"
+#include "spooder/api/control/util/drivetrainSimulator.hpp"
+#include "spooder/api/control/util/systemCharacterizer.hpp"
+#include "spooder/api/device/motor/simulatedMotor.hpp"
+#include "spooder/api/util/simulatedTime.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace okapi;
+using namespace spooder;
+
+namespace {
+const QTime period = 10_ms;
+
+/**
+ * A trapezoidal velocity profile for one side, in motor RPM.
+ */
+struct Profile {
+  const char *name;
+  double distance;     // motor degrees each side travels
+  double velocity;     // RPM
+  double acceleration; // RPM per second
+  bool turn;
+};
+
+struct Result {
+  double rmsError{0}; // RPM
+  double maxError{0}; // RPM
+  double endError{0}; // motor degrees, after the robot comes to rest
+};
+
+/**
+ * @return The profile's velocity ``t`` seconds in, and its acceleration through ``iaccel``.
+ */
+double profileVelocity(const Profile &iprofile, const double t, double &iaccel) {
+  const double d = iprofile.distance / 6; // degrees to motor revolutions * 60 (RPM seconds)
+  const double a = iprofile.acceleration;
+  const double vMax = std::min(iprofile.velocity, std::sqrt(d * a));
+  const double ramp = vMax / a;
+  const double cruise = d / vMax - ramp;
+
+  if (t < ramp) {
+    iaccel = a;
+    return a * t;
+  } else if (t < ramp + cruise) {
+    iaccel = 0;
+    return vMax;
+  } else if (t < 2 * ramp + cruise) {
+    iaccel = -a;
+    return vMax - a * (t - ramp - cruise);
+  }
+
+  iaccel = 0;
+  return 0;
+}
+
+double profileDuration(const Profile &iprofile) {
+  const double d = iprofile.distance / 6;
+  const double vMax = std::min(iprofile.velocity, std::sqrt(d * iprofile.acceleration));
+  return d / vMax + vMax / iprofile.acceleration;
+}
+
+Result follow(DrivetrainSimulator &isimulator,
+              SimulatedMotor &ileft,
+              SimulatedMotor &iright,
+              ChassisModel &imodel,
+              const Profile &iprofile) {
+  isimulator.reset();
+  ileft.tarePosition();
+  iright.tarePosition();
+
+  const double maxVelocity = imodel.getMaxVelocity();
+  const double duration = profileDuration(iprofile);
+  const double turn = iprofile.turn ? -1 : 1;
+
+  Result result;
+  std::size_t ticks = 0;
+  for (double t = 0; t < duration; t += period.convert(second)) {
+    double accel;
+    const double target = profileVelocity(iprofile, t, accel);
+    imodel.left(target / maxVelocity);
+    imodel.right(turn * target / maxVelocity);
+    isimulator.step(period);
+
+    // Compared with where the profile is at the end of the period
+    const double next = profileVelocity(iprofile, t + period.convert(second), accel);
+    for (const double error :
+         {next - ileft.getActualVelocity(), turn * next - iright.getActualVelocity()}) {
+      result.rmsError += error * error;
+      result.maxError = std::max(result.maxError, std::abs(error));
+    }
+    ticks += 2;
+  }
+
+  imodel.stop();
+  isimulator.step(500_ms);
+
+  result.rmsError = std::sqrt(result.rmsError / ticks);
+  result.endError = (std::abs(iprofile.distance - ileft.getPosition()) +
+                     std::abs(turn * iprofile.distance - iright.getPosition())) /
+                    2;
+  return result;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc != 1 && argc != 3) {
+    fprintf(stderr, "usage: %s [kP kI]\n", argv[0]);
+    return 1;
+  }
+
+  VelocityTrimGains trim;
+  trim.kP = (argc == 3) ? std::atof(argv[1]) : 0.05;
+  trim.kI = (argc == 3) ? std::atof(argv[2]) : 0.5;
+
+  auto simulator = std::make_shared<DrivetrainSimulator>();
+  auto left = std::make_shared<SimulatedMotor>(simulator, std::vector<std::size_t>{0, 1, 2});
+  auto right = std::make_shared<SimulatedMotor>(simulator, std::vector<std::size_t>{3, 4, 5});
+  const auto timeUtil = createSimulatedTimeUtil(simulator);
+
+  SystemCharacterizer characterizer({left, right}, timeUtil);
+  characterizer.runQuasistatic();
+  characterizer.runDynamic();
+  const auto constants = characterizer.fit();
+  for (std::size_t i = 0; i < 2; i++) {
+    printf("%s: kS %.3f V, kV %.5f V/RPM, kA %.5f V/(RPM/s)\n",
+           i == 0 ? "left" : "right",
+           constants[i].kS,
+           constants[i].kV,
+           constants[i].kA);
+  }
+
+  const double maxVelocity = toUnderlyingType(AbstractMotor::gearset::green);
+  SkidSteerModel velocityModel(
+    left, right, left->getEncoder(), right->getEncoder(), maxVelocity, 12000);
+  FeedforwardSkidSteerModel feedforwardModel(left,
+                                             right,
+                                             left->getEncoder(),
+                                             right->getEncoder(),
+                                             maxVelocity,
+                                             12000,
+                                             constants[0],
+                                             constants[1],
+                                             {},
+                                             timeUtil);
+  FeedforwardSkidSteerModel trimmedModel(left,
+                                         right,
+                                         left->getEncoder(),
+                                         right->getEncoder(),
+                                         maxVelocity,
+                                         12000,
+                                         constants[0],
+                                         constants[1],
+                                         trim,
+                                         timeUtil);
+
+  // 48 in and a 90 degree turn on 3.25 in wheels, at 0.7 m/s and 2 m/s^2 at the wheels
+  const double wheelCircumference = (3.25_in).convert(meter) * pi;
+  const double rpm = 60 / wheelCircumference;
+  const double turnDegrees = 90 * (11.5 / 3.25);
+  const std::vector<Profile> profiles{
+    {"drive 48 in", 48 / 3.25 / pi * 360, 0.7 * rpm, 2 * rpm, false},
+    {"turn 90 deg", turnDegrees, 0.5 * rpm, 1.5 * rpm, true}};
+
+  printf("\n%-12s %-20s %10s %10s %12s\n", "profile", "mode", "rms RPM", "max RPM", "end deg");
+  for (const auto &profile : profiles) {
+    const std::pair<const char *, ChassisModel *> modes[] = {
+      {"velocity (internal)", &velocityModel},
+      {"feedforward", &feedforwardModel},
+      {"feedforward + trim", &trimmedModel}};
+    for (const auto &[name, model] : modes) {
+      const auto result = follow(*simulator, *left, *right, *model, profile);
+      printf("%-12s %-20s %10.2f %10.2f %12.1f\n",
+             profile.name,
+             name,
+             result.rmsError,
+             result.maxError,
+             result.endError);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,91 @@
+/**
+ * Times a KalmanFilter predict and update on the desktop for state sizes 2 through 6, with a
+ * single measurement and with every state measured, and checks that a constant velocity filter
+ * follows a ramp.
+ *
+ * This file is not part of the robot build (the PROS Makefile only builds src/). Build it with:
+ *
+ * g++ -std=gnu++17 -O2 -iquote include host/kalmanFilterBench.cpp -o kalmanFilterBench
+ *
+ * Usage: ./kalmanFilterBench [iterations]
+ */
+#include "spooder/api/filter/kalmanFilter.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace spooder;
+
+template <std::size_t N, std::size_t M>
+double nanosPerStep(KalmanFilter<N, M> &ifilter, const std::vector<Vector<M>> &imeasurements) {
+  const auto start = std::chrono::steady_clock::now();
+  for (const auto &z : imeasurements) {
+    ifilter.predict();
+    ifilter.update(z);
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() / imeasurements.size();
+}
+
+/**
+ * One noisy measurement of the first state, like a flywheel's velocity.
+ */
+template <std::size_t N> double oneMeasurement(const std::size_t icount) {
+  Matrix<1, N> H;
+  H(0, 0) = 1;
+  KalmanFilter<N, 1> filter(kinematicModel<N>(0.01), H, Matrix<N, N>::identity() * 0.01, {4.0});
+
+  std::mt19937 rng(2);
+  std::normal_distribution<double> noise(0, 2);
+  std::vector<Vector<1>> measurements(icount);
+  for (auto &z : measurements) {
+    z[0] = 100 + noise(rng);
+  }
+
+  return nanosPerStep(filter, measurements);
+}
+
+/**
+ * Every state measured.
+ */
+template <std::size_t N> double allMeasured(const std::size_t icount) {
+  KalmanFilter<N, N> filter(kinematicModel<N>(0.01),
+                            Matrix<N, N>::identity(),
+                            Matrix<N, N>::identity() * 0.01,
+                            Matrix<N, N>::identity());
+
+  Vector<N> z;
+  z[0] = 1;
+  const std::vector<Vector<N>> measurements(icount, z);
+
+  return nanosPerStep(filter, measurements);
+}
+
+template <std::size_t N> void run(const std::size_t icount) {
+  const double one = oneMeasurement<N>(icount);
+  const double all = allMeasured<N>(icount);
+  printf("N=%zu predict+update: M=1 %7.1f ns  M=%zu %7.1f ns\n", N, one, N, all);
+}
+
+int main(int argc, char **argv) {
+  const std::size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+
+  run<2>(count);
+  run<3>(count);
+  run<4>(count);
+  run<5>(count);
+  run<6>(count);
+
+  // A speed ramping up at 50 per second, measured every 10 ms
+  KalmanFilter<2, 1> ramp(kinematicModel<2>(0.01), {1, 0}, {0.01, 0, 0, 10}, {25});
+  for (int i = 0; i < 500; i++) {
+    ramp.predict();
+    ramp.update({50 * i * 0.01});
+  }
+  printf("ramp: speed %.2f (expected 249.5), acceleration %.2f (expected 50)\n",
+         ramp.getState()[0],
+         ramp.getState()[1]);
+  return 0;
+}
@@ -0,0 +1,92 @@
+/**
+ * Checks that RunningMedianFilter returns the same values as okapi::MedianFilter, and times a
+ * reading through each of them for a range of window sizes on the desktop.
+ *
+ * This file is not part of the robot build (the PROS Makefile only builds src/). OkapiLib ships
+ * to the robot as a prebuilt archive, so the desktop build also needs OkapiLib's own api sources
+ * from a checkout of the matching release (``$OKAPI`` below). Build it with:
+ *
+ * g++ -std=gnu++17 -O2 -pthread -DTHREADS_STD -iquote include -iquote include/okapi/squiggles \
+ *   host/medianFilterBench.cpp $(find $OKAPI/src/api -name '*.cpp') -o medianFilterBench
+ *
+ * Usage: ./medianFilterBench [readings]
+ *
+ * A window of 2 is left out: okapi::MedianFilter<2> overruns its own stack, so there is nothing
+ * to compare against.
+ */
+#include "okapi/api/filter/medianFilter.hpp"
+#include "spooder/api/filter/runningMedianFilter.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace spooder;
+
+template <std::size_t n> bool compare(const std::vector<double> &ireadings) {
+  okapi::MedianFilter<n> okapiFilter;
+  RunningMedianFilter<n> runningFilter;
+
+  for (std::size_t i = 0; i < ireadings.size(); i++) {
+    const double expected = okapiFilter.filter(ireadings[i]);
+    const double actual = runningFilter.filter(ireadings[i]);
+    if (expected != actual) {
+      printf("n=%3zu differs at reading %zu: okapi %f, running %f\n", n, i, expected, actual);
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename F> double nanosPerReading(const std::vector<double> &ireadings) {
+  F filter;
+  volatile double sink = 0;
+
+  const auto start = std::chrono::steady_clock::now();
+  for (const double reading : ireadings) {
+    sink = filter.filter(reading);
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  (void)sink;
+  return std::chrono::duration<double, std::nano>(end - start).count() / ireadings.size();
+}
+
+template <std::size_t n> void run(const std::vector<double> &ireadings) {
+  // Compare on a shorter run with repeated values, which exercise the ties between the two heaps
+  std::vector<double> checked(ireadings.begin(),
+                              ireadings.begin() + std::min<std::size_t>(ireadings.size(), 100000));
+  for (std::size_t i = 0; i < checked.size(); i += 7) {
+    checked[i] = 5;
+  }
+  const bool same = compare<n>(checked);
+
+  printf("n=%3zu okapi %7.1f ns  running %7.1f ns  %s\n",
+         n,
+         nanosPerReading<okapi::MedianFilter<n>>(ireadings),
+         nanosPerReading<RunningMedianFilter<n>>(ireadings),
+         same ? "same output" : "OUTPUT DIFFERS");
+}
+
+int main(int argc, char **argv) {
+  const std::size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<double> dist(-100, 100);
+  std::vector<double> readings(count);
+  for (auto &reading : readings) {
+    reading = dist(rng);
+  }
+
+  run<1>(readings);
+  run<3>(readings);
+  run<4>(readings);
+  run<5>(readings);
+  run<8>(readings);
+  run<15>(readings);
+  run<31>(readings);
+  run<64>(readings);
+  run<101>(readings);
+  return 0;
+}
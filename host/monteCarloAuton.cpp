@@ -0,0 +1,264 @@
+/**
+ * Runs the autonomous routine many times on the desktop in a simulated drivetrain with randomized
+ * physical parameters, and reports how much the end pose and run time vary. Trials run in
+ * parallel on every core.
+ *
+ * This file is not part of the robot build (the PROS Makefile only builds src/). OkapiLib ships
+ * to the robot as a prebuilt archive, so the desktop build also needs OkapiLib's own api sources
+ * from a checkout of the matching release (``$OKAPI`` below). Build it with:
+ *
+ * g++ -std=gnu++17 -O2 -pthread -DTHREADS_STD -iquote include -iquote include/okapi/squiggles \
+ *   host/monteCarloAuton.cpp src/routines.cpp src/spooder/api/chassis/controller/motionQueue.cpp \
+ *   src/spooder/api/control/util/drivetrainSimulator.cpp \
+ *   src/spooder/api/device/motor/simulatedMotor.cpp \
+ *   src/spooder/api/device/rotarysensor/simulatedEncoder.cpp \
+ *   src/spooder/api/util/simulatedTime.cpp \
+ *   $(find $OKAPI/src/api -name '*.cpp') -o monteCarloAuton
+ *
+ * Usage: ./monteCarloAuton [trials] [threads] [seed]
+ *
+ * Every trial uses the nominal robot dimensions in the controller, like the robot code does,
+ * while the simulated robot gets randomized traction, rolling and turning friction, mass, battery
+ * voltage, and wheel diameter. The end pose of each trial is compared with a trial on the nominal
+ * robot.
+ *
+ * The routine ends where it started, so if the nominal trial does not end within 2 in and 5 degrees
+ * of the start, the build or the harness is wrong rather than the robot, and nothing is reported.
+ */
+#include "okapi/api/chassis/controller/chassisControllerIntegrated.hpp"
+#include "okapi/api/chassis/controller/defaultOdomChassisController.hpp"
+#include "okapi/api/chassis/model/skidSteerModel.hpp"
+#include "okapi/api/control/async/asyncPosIntegratedController.hpp"
+#include "okapi/api/odometry/twoEncoderOdometry.hpp"
+#include "routines.h"
+#include "spooder/api/chassis/controller/motionQueue.hpp"
+#include "spooder/api/control/util/drivetrainSimulator.hpp"
+#include "spooder/api/device/motor/simulatedMotor.hpp"
+#include "spooder/api/util/parallel.hpp"
+#include "spooder/api/util/simulatedTime.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace okapi;
+using namespace spooder;
+
+namespace {
+// The dimensions the robot code is built with (see main.cpp)
+const AbstractMotor::GearsetRatioPair gearset{AbstractMotor::gearset::green};
+const QLength wheelDiameter = 3.25_in;
+const QLength trackWidth = 11.5_in;
+
+/**
+ * The simulator's clock, which also steps odometry every 10 ms of simulated time the way the
+ * odometry task does on the robot. The task itself is not started, since only one thread may step
+ * the simulation.
+ */
+class OdometryClock : public SimulationClock {
+  public:
+  explicit OdometryClock(std::shared_ptr<DrivetrainSimulator> isimulator)
+    : simulator(std::move(isimulator)), nextStep(simulator->getTime() + period) {
+  }
+
+  void setOdometry(std::shared_ptr<Odometry> iodometry) {
+    odometry = std::move(iodometry);
+  }
+
+  QTime getTime() const override {
+    return simulator->getTime();
+  }
+
+  void advanceTo(const QTime itime) override {
+    while (nextStep <= itime) {
+      simulator->advanceTo(nextStep);
+      if (odometry) {
+        odometry->step();
+      }
+      nextStep += period;
+    }
+    simulator->advanceTo(itime);
+  }
+
+  protected:
+  static constexpr QTime period = 10_ms;
+  std::shared_ptr<DrivetrainSimulator> simulator;
+  std::shared_ptr<Odometry> odometry;
+  QTime nextStep;
+};
+
+struct Trial {
+  DrivetrainSimulator::Parameters params;
+  OdomState pose;
+  double simSeconds{0};
+  double wallSeconds{0};
+};
+
+/**
+ * Runs the routine once on a simulated robot. Everything is local to the trial, so trials can run
+ * concurrently.
+ */
+void runTrial(Trial &itrial) {
+  const auto start = std::chrono::steady_clock::now();
+
+  auto simulator = std::make_shared<DrivetrainSimulator>(itrial.params);
+  auto clock = std::make_shared<OdometryClock>(simulator);
+  const auto timeUtil = createSimulatedTimeUtil(clock);
+  const auto logger = std::make_shared<Logger>();
+
+  auto left = std::make_shared<SimulatedMotor>(
+    simulator, std::vector<std::size_t>{0, 1, 2}, false, gearset.internalGearset);
+  auto right = std::make_shared<SimulatedMotor>(
+    simulator, std::vector<std::size_t>{3, 4, 5}, false, gearset.internalGearset);
+
+  // Built the same way ChassisControllerBuilder builds an integrated chassis with odometry
+  const double maxVelocity = toUnderlyingType(gearset.internalGearset);
+  const ChassisScales scales(
+    {wheelDiameter, trackWidth}, gearsetToTPR(gearset.internalGearset), logger);
+  auto model = std::make_shared<SkidSteerModel>(
+    left, right, left->getEncoder(), right->getEncoder(), maxVelocity, 12000);
+  auto integrated = std::make_shared<ChassisControllerIntegrated>(
+    timeUtil,
+    model,
+    std::make_unique<AsyncPosIntegratedController>(
+      left, gearset, static_cast<std::int32_t>(maxVelocity), timeUtil, logger),
+    std::make_unique<AsyncPosIntegratedController>(
+      right, gearset, static_cast<std::int32_t>(maxVelocity), timeUtil, logger),
+    gearset,
+    scales,
+    logger);
+  auto odometry = std::make_shared<TwoEncoderOdometry>(timeUtil, model, scales, logger);
+  clock->setOdometry(odometry);
+  auto chassis = std::make_shared<DefaultOdomChassisController>(
+    timeUtil, odometry, integrated, StateMode::FRAME_TRANSFORMATION, 0_mm, 0_deg, logger);
+
+  // The same queue and routine autonomous() runs
+  MotionQueue queue(timeUtil, chassis, MotionQueue::Gains{}, logger);
+  squareRoutine(queue);
+
+  itrial.pose = simulator->getPose();
+  itrial.simSeconds = simulator->getTime().convert(second);
+  itrial.wallSeconds =
+    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Prints the spread of a set of values.
+ */
+void printStats(const char *iname, std::vector<double> ivalues) {
+  std::sort(ivalues.begin(), ivalues.end());
+  const auto at = [&](const double ifraction) {
+    return ivalues[static_cast<std::size_t>(ifraction * (ivalues.size() - 1))];
+  };
+
+  double mean = 0;
+  for (const double value : ivalues) {
+    mean += value;
+  }
+  mean /= ivalues.size();
+
+  double variance = 0;
+  for (const double value : ivalues) {
+    variance += (value - mean) * (value - mean);
+  }
+  variance /= ivalues.size();
+
+  printf("%-22s mean %8.3f  sd %8.3f  p50 %8.3f  p90 %8.3f  p99 %8.3f  max %8.3f\n",
+         iname,
+         mean,
+         std::sqrt(variance),
+         at(0.5),
+         at(0.9),
+         at(0.99),
+         ivalues.back());
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  const std::size_t trials = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1000;
+  const std::size_t threads = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 0;
+  const unsigned seed = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : 0;
+  if (trials == 0) {
+    fprintf(stderr, "usage: %s [trials] [threads] [seed]\n", argv[0]);
+    return 1;
+  }
+
+  DrivetrainSimulator::Parameters nominal;
+  nominal.gearset = gearset;
+  nominal.wheelDiameter = wheelDiameter.convert(meter);
+  nominal.trackWidth = trackWidth.convert(meter);
+
+  Trial reference;
+  reference.params = nominal;
+  runTrial(reference);
+
+  const double nominalMiss =
+    std::hypot(reference.pose.x.convert(inch), reference.pose.y.convert(inch));
+  const double nominalTurn = std::abs(std::remainder(reference.pose.theta.convert(degree), 360));
+  if (nominalMiss > 2 || nominalTurn > 5) {
+    fprintf(stderr,
+            "nominal trial ended %.2f in and %.2f deg from the start: %s\n",
+            nominalMiss,
+            nominalTurn,
+            reference.pose.str(inch, degree).c_str());
+    return 1;
+  }
+
+  // Draw every trial's parameters up front so the results do not depend on the thread count
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<double> traction(0.7, 1.1);
+  std::uniform_real_distribution<double> rolling(0.02, 0.05);
+  std::uniform_real_distribution<double> scrub(0.2, 0.45);
+  std::uniform_real_distribution<double> mass(6.0, 7.5);
+  std::uniform_real_distribution<double> battery(10.5, 12);
+  std::normal_distribution<double> wheelError(0, 0.01);
+
+  std::vector<Trial> results(trials);
+  for (auto &trial : results) {
+    trial.params = nominal;
+    trial.params.muStatic = traction(gen);
+    trial.params.muKinetic = 0.8 * trial.params.muStatic;
+    trial.params.rollingFriction = rolling(gen);
+    trial.params.scrubFriction = scrub(gen);
+    trial.params.mass = mass(gen);
+    trial.params.supplyVoltage = battery(gen);
+    trial.params.wheelDiameter = nominal.wheelDiameter * (1 + wheelError(gen));
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  parallelFor(
+    trials, [&](const std::size_t i) { runTrial(results[i]); }, threads);
+  const double wall =
+    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::vector<double> positionError, headingError, runTime, trialWall;
+  for (const auto &trial : results) {
+    const double dx = (trial.pose.x - reference.pose.x).convert(inch);
+    const double dy = (trial.pose.y - reference.pose.y).convert(inch);
+    positionError.push_back(std::hypot(dx, dy));
+    headingError.push_back(
+      std::abs(std::remainder((trial.pose.theta - reference.pose.theta).convert(degree), 360)));
+    runTime.push_back(trial.simSeconds);
+    trialWall.push_back(trial.wallSeconds * 1000);
+  }
+
+  printf("nominal end pose %s after %.2f s\n",
+         reference.pose.str(inch, degree).c_str(),
+         reference.simSeconds);
+  printStats("position error (in)", positionError);
+  printStats("heading error (deg)", headingError);
+  printStats("routine time (s)", runTime);
+  printStats("wall per trial (ms)", trialWall);
+
+  const std::size_t cores = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+  printf("%zu trials on %zu threads in %.2f s (%.0f trials/s)\n",
+         trials,
+         cores,
+         wall,
+         trials / wall);
+  return 0;
+}
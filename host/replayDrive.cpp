@@ -0,0 +1,429 @@
+/**
+ * Replays a recorded driver session through the robot's driver control code in a simulated
+ * drivetrain on the desktop, and prints where the robot ends up. The same log always gives the
+ * same result, so two versions of the code can be compared on one session.
+ *
+ * This file is not part of the robot build (the PROS Makefile only builds src/). OkapiLib ships
+ * to the robot as a prebuilt archive, so the desktop build also needs OkapiLib's own api sources
+ * from a checkout of the matching release (``$OKAPI`` below). Build it with:
+ *
+ * g++ -std=gnu++17 -O2 -pthread -DTHREADS_STD -iquote include -iquote include/okapi/squiggles \
+ *   host/replayDrive.cpp src/driverControl.cpp $(find src/spooder/api -name '*.cpp') \
+ *   $(find $OKAPI/src/api -name '*.cpp') -o replayDrive
+ *
+ * Usage: ./replayDrive inputs000.bin
+ *
+ * The log is one of the ``/usd/inputsNNN.bin`` files opcontrol() records, a new one each time it
+ * starts. Copy it to ``/usd/replay.bin`` to replay it on the robot instead, with the replay armed
+ * from the brain's left button and no competition control connected.
+ *
+ * Each tick reads the frame through InputReplay, the same frames ReplayController hands
+ * opcontrol(), and runs DriverControl::step() as opcontrol() does. The drive motors go through the
+ * same MotorCommandBatch, VoltageCompensator and CurrentBudget as on the robot, and the intake,
+ * shot sequencer, disc counter, roller, goal tracker and odometry are stepped every 10 ms like
+ * their tasks. What the simulator does not model is stood in for: the intake, flywheel and roller
+ * motors reach whatever they are told at once, the camera never sees the goal, and the disc and
+ * color sensors never see anything. The motor health monitor is left out, since nothing heats.
+ */
+#include "driverControl.h"
+#include "okapi/api/chassis/model/skidSteerModel.hpp"
+#include "okapi/api/odometry/twoEncoderOdometry.hpp"
+#include "okapi/api/odometry/odomMath.hpp"
+#include "spooder/api/control/aim/goalTracker.hpp"
+#include "spooder/api/control/util/drivetrainSimulator.hpp"
+#include "spooder/api/device/motor/simulatedMotor.hpp"
+#include "spooder/api/device/motor/voltageCompensator.hpp"
+#include "spooder/api/filter/motorVelocityEstimator.hpp"
+#include "spooder/api/util/inputLog.hpp"
+#include "spooder/api/util/simulatedTime.hpp"
+#include <cstdio>
+#include <vector>
+
+using namespace okapi;
+using namespace spooder;
+
+namespace {
+const char *const buttonNames[InputFrame::buttons] = {
+  "L1", "L2", "R1", "R2", "up", "down", "left", "right", "X", "B", "Y", "A"};
+
+/**
+ * A motor that reaches the velocity it is told, or its free speed at the voltage it is told, at
+ * once. It stands in for the mechanisms the drivetrain simulator does not model, so the flywheel
+ * comes up to speed and the intake does not jam.
+ */
+class IdealMotor : public AbstractMotor {
+  public:
+  explicit IdealMotor(std::shared_ptr<SimulationClock> iclock)
+    : clock(std::move(iclock)), lastTime(clock->getTime()) {
+  }
+
+  std::int32_t moveAbsolute(double, std::int32_t) override {
+    return moveVelocity(0);
+  }
+
+  std::int32_t moveRelative(double, std::int32_t) override {
+    return moveVelocity(0);
+  }
+
+  std::int32_t moveVelocity(const std::int16_t ivelocity) override {
+    update();
+    targetVelocity = ivelocity;
+    velocity = ivelocity;
+    return 1;
+  }
+
+  std::int32_t moveVoltage(const std::int16_t ivoltage) override {
+    update();
+    targetVelocity = 0;
+    velocity = ivoltage / 12000.0 * toUnderlyingType(gearing);
+    return 1;
+  }
+
+  std::int32_t modifyProfiledVelocity(std::int32_t) override {
+    return 1;
+  }
+
+  double getTargetPosition() override {
+    return 0;
+  }
+
+  double getPosition() override {
+    update();
+    return position;
+  }
+
+  std::int32_t tarePosition() override {
+    update();
+    position = 0;
+    return 1;
+  }
+
+  std::int32_t getTargetVelocity() override {
+    return targetVelocity;
+  }
+
+  double getActualVelocity() override {
+    return velocity;
+  }
+
+  std::int32_t getCurrentDraw() override {
+    return 0;
+  }
+
+  std::int32_t getDirection() override {
+    return velocity < 0 ? -1 : 1;
+  }
+
+  double getEfficiency() override {
+    return 100;
+  }
+
+  std::int32_t isOverCurrent() override {
+    return 0;
+  }
+
+  std::int32_t isOverTemp() override {
+    return 0;
+  }
+
+  std::int32_t isStopped() override {
+    return velocity == 0;
+  }
+
+  std::int32_t getZeroPositionFlag() override {
+    return 0;
+  }
+
+  uint32_t getFaults() override {
+    return 0;
+  }
+
+  uint32_t getFlags() override {
+    return 0;
+  }
+
+  std::int32_t getRawPosition(std::uint32_t *timestamp) override {
+    update();
+    if (timestamp) {
+      *timestamp = static_cast<std::uint32_t>(lastTime.convert(millisecond));
+    }
+    return static_cast<std::int32_t>(position / 360 * gearsetToTPR(gearing));
+  }
+
+  double getPower() override {
+    return 0;
+  }
+
+  double getTemperature() override {
+    return 25;
+  }
+
+  double getTorque() override {
+    return 0;
+  }
+
+  std::int32_t getVoltage() override {
+    return static_cast<std::int32_t>(velocity / toUnderlyingType(gearing) * 12000);
+  }
+
+  std::int32_t setBrakeMode(const brakeMode imode) override {
+    brake = imode;
+    return 1;
+  }
+
+  brakeMode getBrakeMode() override {
+    return brake;
+  }
+
+  std::int32_t setCurrentLimit(const std::int32_t ilimit) override {
+    currentLimit = ilimit;
+    return 1;
+  }
+
+  std::int32_t getCurrentLimit() override {
+    return currentLimit;
+  }
+
+  std::int32_t setEncoderUnits(const encoderUnits iunits) override {
+    units = iunits;
+    return 1;
+  }
+
+  encoderUnits getEncoderUnits() override {
+    return units;
+  }
+
+  std::int32_t setGearing(const gearset igearset) override {
+    gearing = igearset;
+    return 1;
+  }
+
+  gearset getGearing() override {
+    return gearing;
+  }
+
+  std::int32_t setReversed(bool) override {
+    return 1;
+  }
+
+  std::int32_t setVoltageLimit(std::int32_t) override {
+    return 1;
+  }
+
+  std::shared_ptr<ContinuousRotarySensor> getEncoder() override {
+    return nullptr; // nothing the driver code drives reads a mechanism's encoder
+  }
+
+  void controllerSet(const double ivalue) override {
+    moveVelocity(static_cast<std::int16_t>(ivalue * toUnderlyingType(gearing)));
+  }
+
+  protected:
+  std::shared_ptr<SimulationClock> clock;
+  QTime lastTime;
+  double position{0}; // degrees
+  double velocity{0}; // RPM
+  std::int32_t targetVelocity{0};
+  brakeMode brake{brakeMode::coast};
+  std::int32_t currentLimit{2500};
+  encoderUnits units{encoderUnits::degrees};
+  gearset gearing{gearset::green};
+
+  void update() {
+    const QTime now = clock->getTime();
+    position += velocity * 6 * (now - lastTime).convert(second);
+    lastTime = now;
+  }
+};
+
+/**
+ * The battery, at the simulated supply voltage, drawn on by the drive motors.
+ */
+class SimulatedBattery : public AbstractBattery {
+  public:
+  explicit SimulatedBattery(std::shared_ptr<DrivetrainSimulator> isimulator)
+    : simulator(std::move(isimulator)) {
+  }
+
+  std::int32_t getVoltage() override {
+    return static_cast<std::int32_t>(simulator->getParameters().supplyVoltage * 1000);
+  }
+
+  std::int32_t getCurrent() override {
+    double current = 0;
+    for (std::size_t i = 0; i < simulator->getMotorCount(); i++) {
+      current += std::abs(simulator->getReading(i).current);
+    }
+    return static_cast<std::int32_t>(current * 1000);
+  }
+
+  protected:
+  std::shared_ptr<DrivetrainSimulator> simulator;
+};
+
+class BlindCamera : public AbstractGoalCamera {
+  public:
+  std::size_t getGoals(GoalDetection *, std::size_t) override {
+    return 0;
+  }
+};
+
+class BlindColorSensor : public AbstractColorSensor {
+  public:
+  double getHue() override {
+    return 0;
+  }
+
+  double getSaturation() override {
+    return 0;
+  }
+
+  std::int32_t getProximity() override {
+    return 0;
+  }
+};
+
+class FarDistanceSensor : public ControllerInput<double> {
+  public:
+  double controllerGet() override {
+    return 1000;
+  }
+};
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s inputs000.bin\n", argv[0]);
+    return 1;
+  }
+
+  const auto log = InputLog::load(argv[1]);
+  if (!log) {
+    fprintf(stderr, "%s is not an input log\n", argv[1]);
+    return 1;
+  }
+
+  InputReplay replay(log);
+
+  // The robot as main.cpp builds it
+  DrivetrainSimulator::Parameters params;
+  params.wheelDiameter = (3.25_in).convert(meter);
+  params.trackWidth = (11.5_in).convert(meter);
+  auto simulator = std::make_shared<DrivetrainSimulator>(params);
+  const auto timeUtil = createSimulatedTimeUtil(simulator);
+  auto battery = std::make_shared<SimulatedBattery>(simulator);
+
+  MotorCommandBatch motorBatch(500_ms);
+  VoltageCompensator voltageCompensator(battery, timeUtil);
+  auto leftDrive = std::make_shared<SimulatedMotor>(simulator, std::vector<std::size_t>{0, 1, 2});
+  auto rightDrive = std::make_shared<SimulatedMotor>(simulator, std::vector<std::size_t>{3, 4, 5});
+  auto model = std::make_shared<SkidSteerModel>(
+    voltageCompensator.compensate(motorBatch.add(leftDrive)),
+    voltageCompensator.compensate(motorBatch.add(rightDrive)),
+    leftDrive->getEncoder(),
+    rightDrive->getEncoder(),
+    toUnderlyingType(AbstractMotor::gearset::green),
+    12000);
+  auto odometry = std::make_shared<TwoEncoderOdometry>(
+    timeUtil, model, ChassisScales({3.25_in, 11.5_in}, imev5GreenTPR));
+
+  auto goalTracker = std::make_shared<GoalTracker>(
+    std::make_shared<BlindCamera>(), odometry, timeUtil, GoalTrackerParams{});
+  TurnToGoalController turnToGoal(timeUtil, model, goalTracker, TurnToGoalController::Gains{});
+
+  auto intake = voltageCompensator.compensate(
+    motorBatch.add(std::make_shared<IdealMotor>(simulator)));
+  intake->setGearing(AbstractMotor::gearset::blue);
+  IntakeController intakeController(intake, timeUtil, makeIntakeJamParams());
+  DiscCounter discCounter(
+    std::make_shared<FarDistanceSensor>(),
+    [&]() { return intakeController.getDirection(); },
+    timeUtil,
+    DiscCounterParams{});
+
+  auto flywheel = voltageCompensator.compensate(
+    motorBatch.add(std::make_shared<IdealMotor>(simulator)));
+  flywheel->setGearing(AbstractMotor::gearset::blue);
+  ShotSequencer shotSequencer(
+    std::make_shared<MotorVelocityEstimator<>>(flywheel),
+    [&](bool feed) { intakeController.setTarget(feed ? 12000 : 0); },
+    timeUtil,
+    ShotParams{});
+  auto flywheelTargeter = makeFlywheelTargeter(
+    [&]() { return OdomMath::computeDistanceToPoint(goal, odometry->getState()); });
+
+  RollerController rollerController(std::make_shared<IdealMotor>(simulator),
+                                    std::make_shared<BlindColorSensor>(),
+                                    timeUtil,
+                                    RollerParams{});
+
+  CurrentBudget currentBudget(battery, CurrentBudgetParams{16000});
+  currentBudget.add("drive", {leftDrive, rightDrive}, 2, 1000);
+  const std::size_t flywheelBudget = currentBudget.add("flywheel", {flywheel}, 1, 1000);
+  currentBudget.add("intake", {intake}, 0, 500);
+
+  std::size_t angleChanges = 0;
+  DriverControl driverControl(replay.getFrame(),
+                              {model,
+                               turnToGoal,
+                               shotSequencer,
+                               intakeController,
+                               discCounter,
+                               rollerController,
+                               flywheel,
+                               flywheelTargeter,
+                               currentBudget,
+                               flywheelBudget,
+                               motorBatch,
+                               [&](bool) { angleChanges++; }});
+
+  std::vector<InputFrameButton> buttons;
+  for (std::size_t i = 0; i < InputFrame::buttons; i++) {
+    buttons.emplace_back(replay.getFrame(), i);
+  }
+  std::vector<std::size_t> presses(InputFrame::buttons, 0);
+
+  const QTime taskPeriod = 10_ms;
+  double travel = 0;
+  driverControl.start();
+  while (replay.step()) {
+    // opcontrol()'s tick, then the tasks that run between ticks on the robot
+    driverControl.step();
+
+    for (std::size_t i = 0; i < InputFrame::buttons; i++) {
+      presses[i] += buttons[i].changedToPressed();
+    }
+
+    for (QTime t = 0_ms; t < log->tickPeriod; t += taskPeriod) {
+      currentBudget.step();
+      intakeController.step();
+      discCounter.step();
+      shotSequencer.step();
+      goalTracker->step();
+      rollerController.step();
+
+      simulator->step(taskPeriod);
+      odometry->step();
+      travel += std::abs(simulator->getLinearVelocity().convert(inch / second)) *
+                taskPeriod.convert(second);
+    }
+  }
+
+  printf("%zu ticks (%.1f s)\n",
+         log->frames.size(),
+         log->frames.size() * log->tickPeriod.convert(second));
+  printf("end pose %s, %.1f in driven\n", simulator->getPose().str(inch, degree).c_str(), travel);
+  printf("odometry %s\n", odometry->getState().str(inch, degree).c_str());
+  printf("%zu shots, %zu intake jams, %zu angle changes, %zu motor commands (%zu skipped)\n",
+         shotSequencer.getShotCount(),
+         intakeController.getJamCount(),
+         angleChanges,
+         motorBatch.getWritten(),
+         motorBatch.getSkipped());
+  for (std::size_t i = 0; i < InputFrame::buttons; i++) {
+    if (presses[i]) {
+      printf("%-5s pressed %zu times\n", buttonNames[i], presses[i]);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,63 @@
+/**
+ * Tunes position PID gains on the desktop against a motor model, using every core.
+ *
+ * This file is not part of the robot build (the PROS Makefile only builds src/). Build it with:
+ *
+ * g++ -std=gnu++17 -O2 -pthread -DTHREADS_STD -iquote include host/tunePid.cpp \
+ *   src/spooder/api/control/util/simulatedPlant.cpp \
+ *   src/spooder/api/control/util/simulatedPidTuner.cpp -o tunePid
+ *
+ * Usage: ./tunePid kS kV kA goal [kPMax kIMax kDMax]
+ *
+ * kS, kV and kA are the feedforward constants from characterizing the mechanism (in volts and the
+ * units of the goal), and goal is the step response target in the same units as the constants.
+ * The gains are searched between zero and the given maximums, and printed ready to paste into the
+ * robot code.
+ */
+#include "spooder/api/control/util/simulatedPidTuner.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace okapi;
+using namespace spooder;
+
+int main(int argc, char **argv) {
+  if (argc != 5 && argc != 8) {
+    fprintf(stderr, "usage: %s kS kV kA goal [kPMax kIMax kDMax]\n", argv[0]);
+    return 1;
+  }
+
+  const double kS = std::atof(argv[1]);
+  const double kV = std::atof(argv[2]);
+  const double kA = std::atof(argv[3]);
+  const double goal = std::atof(argv[4]);
+  const double kPMax = (argc == 8) ? std::atof(argv[5]) : 0.01;
+  const double kIMax = (argc == 8) ? std::atof(argv[6]) : 0.01;
+  const double kDMax = (argc == 8) ? std::atof(argv[7]) : 0.001;
+
+  SimulatedPIDTuner tuner([=]() { return std::make_unique<MotorModelPlant>(kS, kV, kA); },
+                          4 * second,
+                          goal,
+                          0,
+                          kPMax,
+                          0,
+                          kIMax,
+                          0,
+                          kDMax,
+                          50,
+                          256);
+
+  // Settle within 1% of the goal
+  tuner.setSettledParams(goal * 0.01, goal * 0.001, 250 * millisecond);
+
+  const auto start = std::chrono::steady_clock::now();
+  const auto gains = tuner.autotune();
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+
+  printf("cost %.1f, tuned in %.2f s\n",
+         tuner.getBestCost(),
+         std::chrono::duration<double>(elapsed).count());
+  printf("IterativePosPIDController::Gains{%.8f, %.8f, %.8f}\n", gains.kP, gains.kI, gains.kD);
+  return 0;
+}
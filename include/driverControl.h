@@ -0,0 +1,122 @@
+/**
+ * \file driverControl.h
+ *
+ * The driver control loop, one tick at a time. Like routines.h, it does not
+ * include main.h (and so PROS): it reads the driver's inputs from an
+ * InputFrame and commands the robot through spooder and okapi's api only, so
+ * the same code drives the robot in opcontrol() and a simulated robot on a
+ * desktop replaying a recorded session.
+ */
+
+#ifndef _DRIVER_CONTROL_H_
+#define _DRIVER_CONTROL_H_
+
+#include "okapi/api/chassis/model/chassisModel.hpp"
+#include "okapi/api/odometry/point.hpp"
+#include "spooder/api/chassis/controller/turnToGoalController.hpp"
+#include "spooder/api/control/intake/discCounter.hpp"
+#include "spooder/api/control/intake/intakeController.hpp"
+#include "spooder/api/control/roller/rollerController.hpp"
+#include "spooder/api/control/shooter/flywheelTargeter.hpp"
+#include "spooder/api/control/shooter/shotSequencer.hpp"
+#include "spooder/api/device/button/inputFrameButton.hpp"
+#include "spooder/api/device/motor/currentBudget.hpp"
+#include "spooder/api/device/motor/motorCommandBatch.hpp"
+#include "spooder/api/util/inputLog.hpp"
+#include <functional>
+#include <memory>
+
+/**
+ * The goal, in odometry coordinates from where the robot starts.
+ */
+const okapi::Point goal{10 * okapi::foot, 10 * okapi::foot};
+
+/**
+ * Makes the flywheel targeter with the speeds that score from each distance to
+ * the goal, with the angle changer down and up.
+ *
+ * \param distance
+ *        Returns the distance to the goal
+ */
+spooder::FlywheelTargeter<5> makeFlywheelTargeter(std::function<okapi::QLength()> distance);
+
+/**
+ * \return How the intake sees and backs out of a jam, for its blue cartridge
+ */
+spooder::IntakeJamParams makeIntakeJamParams();
+
+/**
+ * Everything the driver commands.
+ */
+struct DriverRobot
+{
+	std::shared_ptr<okapi::ChassisModel> drive;
+	spooder::TurnToGoalController &turnToGoal;
+	spooder::ShotSequencer &shotSequencer;
+	spooder::IntakeController &intakeController;
+	spooder::DiscCounter &discCounter;
+	spooder::RollerController &rollerController;
+	std::shared_ptr<okapi::AbstractMotor> flywheel;
+	spooder::FlywheelTargeter<5> &flywheelTargeter;
+	spooder::CurrentBudget &currentBudget;
+	const std::size_t &flywheelBudget; ///< The flywheel's subsystem, once it has been added
+	spooder::MotorCommandBatch &motorBatch;
+	std::function<void(bool)> angleChanger; ///< Raises (true) or lowers the angle changer
+};
+
+class DriverControl
+{
+	public:
+	/**
+	 * \param frame
+	 *        The driver's inputs for each tick, such as ReplayController::getFrame()
+	 *        on the robot or InputReplay::getFrame() on a desktop. Must outlive this.
+	 * \param robot
+	 *        What the driver commands
+	 */
+	DriverControl(const spooder::InputFrame &frame, DriverRobot robot);
+
+	/**
+	 * Starts a driver control session, at the top of opcontrol(). Shots taken
+	 * before this, such as in autonomous, are not taken off the disc count again.
+	 */
+	void start();
+
+	/**
+	 * Commands the robot from this tick's inputs and sends the motor commands
+	 * together at the end. Call once per tick, after the frame is read.
+	 */
+	void step();
+
+	/**
+	 * \return The flywheel velocity asked for, in RPM
+	 */
+	double getFlywheelTarget() const;
+
+	/**
+	 * \return Whether the angle changer is up
+	 */
+	bool isAngled() const;
+
+	protected:
+	const spooder::InputFrame &frame;
+	DriverRobot robot;
+
+	spooder::InputFrameButton intakeIn;
+	spooder::InputFrameButton intakeOut;
+	spooder::InputFrameButton fastFlywheel;
+	spooder::InputFrameButton slowFlywheel;
+	spooder::InputFrameButton flywheelStop;
+	spooder::InputFrameButton angleChange;
+	spooder::InputFrameButton fireButton;
+	spooder::InputFrameButton rapidFireButton;
+	spooder::InputFrameButton aimButton;
+	spooder::InputFrameButton rollerButton;
+
+	double target = 0.0;
+	bool targeting = false;
+	bool angled = false;
+	std::size_t countedShots = 0; // shots already taken off the disc count
+};
+
+#endif  // _DRIVER_CONTROL_H_
@@ -40,6 +40,7 @@
  * You should add more #includes here
  */
 #include "okapi/api.hpp"
+#include "spooder/api.hpp"
 //#include "pros/api_legacy.h"
 
 /**
@@ -53,6 +54,7 @@
 // using namespace pros;
 // using namespace pros::literals;
 using namespace okapi;
+using namespace spooder;
 
 /**
  * Prototypes for the competition control tasks are redefined here to ensure
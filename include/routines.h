@@ -0,0 +1,23 @@
+/**
+ * \file routines.h
+ *
+ * Autonomous routines, written against spooder's MotionQueue only. They do
+ * not include main.h (and so PROS), so the same routines run on the robot and
+ * in simulation on a desktop.
+ */
+
+#ifndef _ROUTINES_H_
+#define _ROUTINES_H_
+
+#include "spooder/api/chassis/controller/motionQueue.hpp"
+
+/**
+ * Drives a 12 inch square as one blended motion, ending where it started and
+ * only stopping at the end.
+ *
+ * \param queue
+ *        The motion queue to drive with
+ */
+void squareRoutine(spooder::MotionQueue &queue);
+
+#endif  // _ROUTINES_H_
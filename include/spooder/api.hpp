@@ -0,0 +1,63 @@
+#pragma once
+
+/**
+ * Team code built on top of OkapiLib. Like OkapiLib, headers under ``api`` do not depend on PROS
+ * and also build on a desktop with ``THREADS_STD`` defined, while headers under ``impl`` talk to
+ * the V5 hardware.
+ */
+
+#include "spooder/api/chassis/controller/motionQueue.hpp"
+#include "spooder/api/chassis/controller/turnToGoalController.hpp"
+#include "spooder/api/chassis/model/feedforwardSkidSteerModel.hpp"
+
+#include "spooder/api/command/command.hpp"
+#include "spooder/api/command/commandGroup.hpp"
+#include "spooder/api/command/commandScheduler.hpp"
+#include "spooder/api/command/commands.hpp"
+#include "spooder/api/command/routine.hpp"
+
+#include "spooder/api/control/aim/goalTracker.hpp"
+#include "spooder/api/control/feedforward/feedforwardVelocityController.hpp"
+#include "spooder/api/control/feedforward/simpleMotorFeedforward.hpp"
+#include "spooder/api/control/intake/discCounter.hpp"
+#include "spooder/api/control/intake/intakeController.hpp"
+#include "spooder/api/control/roller/rollerController.hpp"
+#include "spooder/api/control/shooter/flywheelTargeter.hpp"
+#include "spooder/api/control/shooter/rpmTable.hpp"
+#include "spooder/api/control/shooter/shotSequencer.hpp"
+#include "spooder/api/control/util/drivetrainSimulator.hpp"
+#include "spooder/api/control/util/notifyingSettledUtil.hpp"
+#include "spooder/api/control/util/simulatedPidTuner.hpp"
+#include "spooder/api/control/util/simulatedPlant.hpp"
+#include "spooder/api/control/util/systemCharacterizer.hpp"
+
+#include "spooder/api/device/battery/abstractBattery.hpp"
+#include "spooder/api/device/button/inputFrameButton.hpp"
+#include "spooder/api/device/motor/currentBudget.hpp"
+#include "spooder/api/device/motor/forwardingMotor.hpp"
+#include "spooder/api/device/motor/motorCommandBatch.hpp"
+#include "spooder/api/device/motor/motorHealthMonitor.hpp"
+#include "spooder/api/device/motor/simulatedMotor.hpp"
+#include "spooder/api/device/motor/voltageCompensator.hpp"
+#include "spooder/api/device/optical/abstractColorSensor.hpp"
+#include "spooder/api/device/rotarysensor/simulatedEncoder.hpp"
+#include "spooder/api/device/vision/abstractGoalCamera.hpp"
+
+#include "spooder/api/filter/filterPipeline.hpp"
+#include "spooder/api/filter/kalmanFilter.hpp"
+#include "spooder/api/filter/motorVelocityEstimator.hpp"
+#include "spooder/api/filter/runningMedianFilter.hpp"
+#include "spooder/api/filter/timestampedVelMath.hpp"
+
+#include "spooder/api/util/inputLog.hpp"
+#include "spooder/api/util/matrix.hpp"
+#include "spooder/api/util/parallel.hpp"
+#include "spooder/api/util/poseHistory.hpp"
+#include "spooder/api/util/settleEvent.hpp"
+#include "spooder/api/util/simulatedTime.hpp"
+#include "spooder/api/util/telemetry.hpp"
+#include "spooder/impl/device/battery/v5Battery.hpp"
+#include "spooder/impl/device/optical/opticalColorSensor.hpp"
+#include "spooder/impl/device/replayController.hpp"
+#include "spooder/impl/device/vision/v5GoalCamera.hpp"
+#include "spooder/impl/util/taskMonitor.hpp"
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "okapi/api/chassis/controller/odomChassisController.hpp"
+#include "okapi/api/odometry/point.hpp"
+#include "okapi/api/units/QAngle.hpp"
+#include "okapi/api/units/QLength.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include "spooder/api/util/settleEvent.hpp"
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace spooder {
+class MotionQueue {
+  public:
+  struct Gains {
+    double distanceKp{0.1};                         ///< forward output per inch of error
+    double angleKp{0.03};                           ///< turn output per degree of error
+    double maxForward{1.0};                         ///< largest forward output, ``[0, 1]``
+    double maxTurn{0.8};                            ///< largest turn output, ``[0, 1]``
+    double slewRate{8.0};                           ///< largest output change per second
+    okapi::QLength exitRadius{1 * okapi::inch};     ///< when to move on from a drive
+    okapi::QAngle exitAngle{3 * okapi::degree};     ///< when to move on from a turn
+    okapi::QLength settleRadius{0.5 * okapi::inch}; ///< how close the last drive must end
+    okapi::QAngle settleAngle{1.5 * okapi::degree}; ///< how close the last turn must end
+    okapi::QTime settleTime{100 * okapi::millisecond};
+    okapi::QTime segmentTimeout{4 * okapi::second}; ///< when to give up on one target
+  };
+
+  /**
+   * Runs a sequence of drive, turn, and point targets as one continuous motion. The chassis only
+   * stops at the last target: every other target is left as soon as the robot is within its exit
+   * radius (or exit angle for turns), and the next target starts from the current speed instead of
+   * zero. Drives that lead into other drives keep their speed through the corner, and a drive that
+   * leads into a turn slows down but starts turning before it has stopped.
+   *
+   * Targets are chained from where the previous target should have ended, not from where the
+   * robot actually was when it moved on, so leaving targets early does not add up to drift.
+   * Position comes from the chassis' odometry, and the chassis is driven open loop through
+   * ChassisModel::driveVector.
+   *
+   * @param itimeUtil The TimeUtil.
+   * @param ichassis The chassis to drive.
+   * @param igains The gains and tolerances.
+   * @param ilogger The logger this instance will log to.
+   */
+  MotionQueue(const okapi::TimeUtil &itimeUtil,
+              std::shared_ptr<okapi::OdomChassisController> ichassis,
+              const Gains &igains,
+              std::shared_ptr<okapi::Logger> ilogger = okapi::Logger::getDefaultLogger());
+
+  /**
+   * Queues a straight drive along the heading the previous target ends at.
+   *
+   * @param idistance The distance to drive, negative to drive backwards.
+   * @param iexitRadius How close to get before moving on, instead of the default.
+   * @return This queue.
+   */
+  MotionQueue &driveDistance(okapi::QLength idistance,
+                             std::optional<okapi::QLength> iexitRadius = std::nullopt);
+
+  /**
+   * Queues a drive to a point, turning to face it on the way.
+   *
+   * @param ipoint The point in the odometry frame.
+   * @param ibackwards Whether to drive there backwards.
+   * @param iexitRadius How close to get before moving on, instead of the default.
+   * @return This queue.
+   */
+  MotionQueue &driveToPoint(const okapi::Point &ipoint,
+                            bool ibackwards = false,
+                            std::optional<okapi::QLength> iexitRadius = std::nullopt);
+
+  /**
+   * Queues a turn in place, relative to the heading the previous target ends at.
+   *
+   * @param iangle The angle to turn, clockwise positive.
+   * @param iexitAngle How close to get before moving on, instead of the default.
+   * @return This queue.
+   */
+  MotionQueue &turnAngle(okapi::QAngle iangle,
+                         std::optional<okapi::QAngle> iexitAngle = std::nullopt);
+
+  /**
+   * Queues a turn in place to a heading in the odometry frame.
+   *
+   * @param iangle The heading to turn to.
+   * @param iexitAngle How close to get before moving on, instead of the default.
+   * @return This queue.
+   */
+  MotionQueue &turnToAngle(okapi::QAngle iangle,
+                           std::optional<okapi::QAngle> iexitAngle = std::nullopt);
+
+  /**
+   * Drives through every queued target, then stops the chassis and empties the queue. Blocks
+   * until the last target settles. The first target starts from the chassis' current pose.
+   */
+  void run();
+
+  /**
+   * The event run() sets once the last target settles, so another task can act the moment the
+   * chassis stops there. run() clears it when it starts, and leaves it clear if the last target
+   * times out instead.
+   *
+   * @return The event.
+   */
+  SettleEvent &getSettleEvent();
+
+  /**
+   * Removes every queued target.
+   */
+  void clear();
+
+  /**
+   * @return The number of queued targets.
+   */
+  std::size_t size() const;
+
+  protected:
+  enum class TargetType { distance, point, relativeAngle, absoluteAngle };
+
+  struct Target {
+    TargetType type{TargetType::distance};
+    okapi::QLength distance{0 * okapi::meter};
+    okapi::Point point{};
+    okapi::QAngle angle{0 * okapi::degree};
+    bool backwards{false};
+    std::optional<okapi::QLength> exitRadius;
+    std::optional<okapi::QAngle> exitAngle;
+  };
+
+  /**
+   * A target resolved against the pose the previous target ends at.
+   */
+  struct Segment {
+    bool turn{false};
+    okapi::QLength x{0 * okapi::meter};
+    okapi::QLength y{0 * okapi::meter};
+    okapi::QAngle heading{0 * okapi::degree};
+    bool backwards{false};
+    okapi::QLength length{0 * okapi::meter};
+    okapi::QLength carry{0 * okapi::meter}; ///< how much further the drive goes after this one
+    okapi::QLength exitRadius{0 * okapi::meter};
+    okapi::QAngle exitAngle{0 * okapi::degree};
+  };
+
+  okapi::TimeUtil timeUtil;
+  std::shared_ptr<okapi::OdomChassisController> chassis;
+  Gains gains;
+  std::shared_ptr<okapi::Logger> logger;
+  std::vector<Target> targets;
+  SettleEvent settled;
+
+  /**
+   * Turns the queued targets into segments, starting from ``istart``.
+   */
+  std::vector<Segment> resolve(const okapi::OdomState &istart) const;
+
+  /**
+   * @return The angle wrapped to ``[-180, 180]`` degrees.
+   */
+  static okapi::QAngle wrap(okapi::QAngle iangle);
+};
+} // namespace spooder
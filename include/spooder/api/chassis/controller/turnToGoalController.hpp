@@ -0,0 +1,86 @@
+#pragma once
+
+#include "okapi/api/chassis/model/chassisModel.hpp"
+#include "okapi/api/units/QAngle.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/abstractRate.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include "spooder/api/control/aim/goalTracker.hpp"
+#include <memory>
+#include <optional>
+
+namespace spooder {
+class TurnToGoalController {
+  public:
+  struct Gains {
+    double kP{0.02};                                ///< turn output per degree of error
+    double kD{0.001};                               ///< turn output per degree per second
+    double minTurn{0.06};                           ///< least output that still turns the robot
+    double maxTurn{0.6};                            ///< largest turn output, ``[0, 1]``
+    okapi::QAngle settleAngle{1 * okapi::degree};   ///< how close counts as aimed
+    okapi::QTime settleTime{100 * okapi::millisecond};
+  };
+
+  /**
+   * Turns the chassis in place to face the goal a GoalTracker sees. The turn is a PD loop on the
+   * tracker's heading error, driven open loop through ChassisModel::rotate, with a minimum output
+   * outside the settle angle so the last few degrees are not lost to friction. Without a goal the
+   * chassis is stopped.
+   *
+   * Call step() from a control loop, such as while a button is held, or turnToGoal() to aim and
+   * wait from an autonomous routine.
+   *
+   * @param itimeUtil The TimeUtil.
+   * @param imodel The chassis to turn.
+   * @param itracker The goal tracker, stepped by its own thread.
+   * @param igains The gains and tolerances.
+   * @param ilogger The logger this instance will log to.
+   */
+  TurnToGoalController(const okapi::TimeUtil &itimeUtil,
+                       std::shared_ptr<okapi::ChassisModel> imodel,
+                       std::shared_ptr<GoalTracker> itracker,
+                       const Gains &igains,
+                       std::shared_ptr<okapi::Logger> ilogger = okapi::Logger::getDefaultLogger());
+
+  /**
+   * Turns toward the goal for one tick.
+   *
+   * @return The turn output sent to the chassis.
+   */
+  double step();
+
+  /**
+   * @return Whether the chassis has been within the settle angle of the goal for the settle time.
+   */
+  bool isSettled() const;
+
+  /**
+   * Stops the chassis and forgets the turn in progress.
+   */
+  void reset();
+
+  /**
+   * Turns to face the goal and blocks until the chassis has settled on it or the timeout passes.
+   * The chassis is stopped either way.
+   *
+   * @param itimeout The longest time to try for.
+   * @return Whether the chassis settled on the goal.
+   */
+  bool turnToGoal(okapi::QTime itimeout = 2 * okapi::second);
+
+  protected:
+  okapi::TimeUtil timeUtil;
+  std::unique_ptr<okapi::AbstractTimer> timer;
+  std::shared_ptr<okapi::ChassisModel> model;
+  std::shared_ptr<GoalTracker> tracker;
+  Gains gains;
+  std::shared_ptr<okapi::Logger> logger;
+
+  std::optional<okapi::QTime> lastStep;
+  double lastError{0};
+  std::optional<okapi::QTime> settledSince;
+  bool settled{false};
+};
+} // namespace spooder
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "okapi/api/chassis/model/skidSteerModel.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include "spooder/api/control/feedforward/feedforwardVelocityController.hpp"
+#include <memory>
+
+namespace spooder {
+class FeedforwardSkidSteerModel : public okapi::SkidSteerModel {
+  public:
+  /**
+   * A SkidSteerModel whose velocity mode commands are followed with a characterized feedforward
+   * instead of the motors' internal velocity controllers. Each side's voltage is
+   * ``kS sgn(v) + kV v + kA a``, plus PI trim on the side's measured velocity. The internal
+   * controllers only react once the robot falls behind, so a profile followed this way lags less
+   * through the acceleration and deceleration.
+   *
+   * The methods okapi drives in velocity mode (forward(), driveVector(), rotate(), left(), and
+   * right()) are followed this way; the voltage mode methods are unchanged. Hand this model to
+   * AsyncMotionProfileController with ``withOutput(model, scales, pair)``, which drives it
+   * through left() and right(). The desired acceleration is found by differencing successive
+   * commands, so call them at a steady rate, such as the profile's 10 ms.
+   *
+   * The constants are in RPM of the motors, so characterize the sides with SystemCharacterizer
+   * using an external ratio of 1.
+   *
+   * @param ileftSideMotor The left side motor.
+   * @param irightSideMotor The right side motor.
+   * @param ileftEnc The left side encoder.
+   * @param irightEnc The right side encoder.
+   * @param imaxVelocity The maximum velocity in motor RPM.
+   * @param imaxVoltage The maximum voltage in millivolts.
+   * @param ileftFeedforward The left side's constants.
+   * @param irightFeedforward The right side's constants.
+   * @param itrim The feedback gains, in volts and motor RPM. All zero is feedforward only.
+   * @param itimeUtil The time utility used to time successive commands.
+   */
+  FeedforwardSkidSteerModel(std::shared_ptr<okapi::AbstractMotor> ileftSideMotor,
+                            std::shared_ptr<okapi::AbstractMotor> irightSideMotor,
+                            std::shared_ptr<okapi::ContinuousRotarySensor> ileftEnc,
+                            std::shared_ptr<okapi::ContinuousRotarySensor> irightEnc,
+                            double imaxVelocity,
+                            double imaxVoltage,
+                            const SimpleMotorFeedforward &ileftFeedforward,
+                            const SimpleMotorFeedforward &irightFeedforward,
+                            const VelocityTrimGains &itrim,
+                            const okapi::TimeUtil &itimeUtil);
+
+  void forward(double ispeed) override;
+
+  void driveVector(double iySpeed, double izRotation) override;
+
+  void rotate(double ispeed) override;
+
+  void stop() override;
+
+  void left(double ispeed) override;
+
+  void right(double ispeed) override;
+
+  /**
+   * Drives each side at a velocity and acceleration, for followers that know the acceleration
+   * they want instead of leaving it to be differenced.
+   *
+   * @param ileftVelocity The left side's velocity in motor RPM.
+   * @param ileftAcceleration The left side's acceleration in motor RPM per second.
+   * @param irightVelocity The right side's velocity in motor RPM.
+   * @param irightAcceleration The right side's acceleration in motor RPM per second.
+   */
+  void setVelocity(double ileftVelocity,
+                   double ileftAcceleration,
+                   double irightVelocity,
+                   double irightAcceleration);
+
+  protected:
+  struct Side {
+    Side(const SimpleMotorFeedforward &ifeedforward, const VelocityTrimGains &itrim);
+
+    FeedforwardVelocityController controller;
+    double velocity{0};     // motor RPM
+    double acceleration{0}; // motor RPM per second
+    okapi::QTime time{0 * okapi::millisecond};
+    bool active{false};
+  };
+
+  std::unique_ptr<okapi::AbstractTimer> timer;
+  Side leftSide;
+  Side rightSide;
+
+  /**
+   * Commands older than this are not differenced, since the side was stopped or driven some other
+   * way in between.
+   */
+  static constexpr double maxCommandPeriod = 0.05; // seconds
+
+  /**
+   * Drives a side at a fraction of the max velocity, differencing the acceleration from the last
+   * command.
+   */
+  void drive(Side &iside, okapi::AbstractMotor &imotor, double ispeed);
+
+  /**
+   * Drives a side at a velocity and acceleration.
+   */
+  void drive(Side &iside, okapi::AbstractMotor &imotor, double ivelocity, double iacceleration);
+};
+} // namespace spooder
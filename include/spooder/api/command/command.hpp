@@ -0,0 +1,121 @@
+#pragma once
+
+#include "okapi/api/units/QTime.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace spooder {
+/**
+ * When a command ran, as seen by the CommandScheduler's timer.
+ */
+struct CommandTiming {
+  std::string name;
+  std::size_t depth{0}; ///< how deeply the command is nested in groups
+  bool ran{false};      ///< false if the command never started
+  bool interrupted{false};
+  okapi::QTime start{0 * okapi::millisecond};
+  okapi::QTime end{0 * okapi::millisecond};
+};
+
+class Command {
+  public:
+  virtual ~Command() = default;
+
+  /**
+   * Runs the command for one scheduler tick. The first tick initializes it. Once it finishes, it
+   * stays finished and further ticks do nothing, so a command object runs once.
+   *
+   * @param inow The scheduler's time.
+   * @return Whether the command has finished.
+   */
+  bool step(okapi::QTime inow);
+
+  /**
+   * Ends the command early. Does nothing if it is not running.
+   *
+   * @param inow The scheduler's time.
+   */
+  void cancel(okapi::QTime inow);
+
+  /**
+   * @return Whether the command has started and not yet finished.
+   */
+  bool isRunning() const;
+
+  /**
+   * @return Whether the command has finished, on its own or by being cancelled.
+   */
+  bool hasFinished() const;
+
+  /**
+   * @return The name the command is reported with.
+   */
+  const std::string &getName() const;
+
+  /**
+   * Appends when this command ran, followed by when each command nested inside it ran.
+   *
+   * @param otimings The list to append to.
+   * @param idepth The nesting depth of this command.
+   */
+  virtual void getTimings(std::vector<CommandTiming> &otimings, std::size_t idepth = 0) const;
+
+  protected:
+  /**
+   * Something the robot does during a routine, such as driving a path or spinning up the flywheel.
+   * Commands do not block: a CommandScheduler calls execute() and isFinished() once per tick until
+   * the command is done, so commands composed with ParallelCommand run at the same time in one
+   * task.
+   *
+   * @param iname The name the command is reported with.
+   */
+  explicit Command(std::string iname);
+
+  /**
+   * Called on the first tick, before execute().
+   */
+  virtual void initialize();
+
+  /**
+   * Called on every tick, including the first.
+   */
+  virtual void execute();
+
+  /**
+   * Called on every tick after execute().
+   *
+   * @return Whether the command is done.
+   */
+  virtual bool isFinished() = 0;
+
+  /**
+   * Called once after the command finishes or is cancelled.
+   *
+   * @param iinterrupted Whether the command was cancelled before it finished.
+   */
+  virtual void end(bool iinterrupted);
+
+  /**
+   * @return The time since the command started.
+   */
+  okapi::QTime getElapsed() const;
+
+  /**
+   * @return The scheduler's time at the current tick.
+   */
+  okapi::QTime getTime() const;
+
+  private:
+  enum class State { idle, running, finished };
+
+  std::string name;
+  State state{State::idle};
+  bool interrupted{false};
+  okapi::QTime startTime{0 * okapi::millisecond};
+  okapi::QTime endTime{0 * okapi::millisecond};
+  okapi::QTime now{0 * okapi::millisecond};
+};
+
+using CommandPtr = std::unique_ptr<Command>;
+} // namespace spooder
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "spooder/api/command/command.hpp"
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace spooder {
+class SequentialCommand : public Command {
+  public:
+  /**
+   * Runs commands one after another. When a command finishes, the next one starts on the same
+   * tick, so a sequence loses no time between its steps.
+   *
+   * @param icommands The commands, in order.
+   * @param iname The name the group is reported with.
+   */
+  explicit SequentialCommand(std::vector<CommandPtr> icommands, std::string iname = "sequence");
+
+  void getTimings(std::vector<CommandTiming> &otimings, std::size_t idepth = 0) const override;
+
+  protected:
+  std::vector<CommandPtr> commands;
+  std::size_t index{0};
+
+  void execute() override;
+  bool isFinished() override;
+  void end(bool iinterrupted) override;
+};
+
+class ParallelCommand : public Command {
+  public:
+  /**
+   * Runs commands at the same time and finishes when all of them have finished.
+   *
+   * @param icommands The commands.
+   * @param iname The name the group is reported with.
+   */
+  explicit ParallelCommand(std::vector<CommandPtr> icommands, std::string iname = "parallel");
+
+  void getTimings(std::vector<CommandTiming> &otimings, std::size_t idepth = 0) const override;
+
+  protected:
+  std::vector<CommandPtr> commands;
+
+  void execute() override;
+  bool isFinished() override;
+  void end(bool iinterrupted) override;
+};
+
+class TimeoutCommand : public Command {
+  public:
+  /**
+   * Runs a command and cancels it if it has not finished in time, so a routine cannot get stuck
+   * waiting on something that never happens.
+   *
+   * @param icommand The command.
+   * @param itimeout The longest the command may run.
+   */
+  TimeoutCommand(CommandPtr icommand, okapi::QTime itimeout);
+
+  void getTimings(std::vector<CommandTiming> &otimings, std::size_t idepth = 0) const override;
+
+  protected:
+  CommandPtr command;
+  okapi::QTime timeout;
+
+  void execute() override;
+  bool isFinished() override;
+  void end(bool iinterrupted) override;
+};
+
+namespace detail {
+template <typename... Commands> std::vector<CommandPtr> toVector(Commands &&...icommands) {
+  std::vector<CommandPtr> out;
+  out.reserve(sizeof...(icommands));
+  (out.push_back(std::forward<Commands>(icommands)), ...);
+  return out;
+}
+} // namespace detail
+
+/**
+ * @return A SequentialCommand running the commands one after another.
+ */
+template <typename... Commands> CommandPtr sequence(Commands &&...icommands) {
+  return std::make_unique<SequentialCommand>(
+    detail::toVector(std::forward<Commands>(icommands)...));
+}
+
+/**
+ * @return A ParallelCommand running the commands at the same time.
+ */
+template <typename... Commands> CommandPtr parallel(Commands &&...icommands) {
+  return std::make_unique<ParallelCommand>(detail::toVector(std::forward<Commands>(icommands)...));
+}
+
+/**
+ * @return A TimeoutCommand cancelling the command after ``itimeout``.
+ */
+inline CommandPtr withTimeout(CommandPtr icommand, const okapi::QTime itimeout) {
+  return std::make_unique<TimeoutCommand>(std::move(icommand), itimeout);
+}
+} // namespace spooder
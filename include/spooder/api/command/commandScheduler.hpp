@@ -0,0 +1,67 @@
+#pragma once
+
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include "spooder/api/command/command.hpp"
+#include "spooder/api/util/telemetry.hpp"
+#include <memory>
+#include <vector>
+
+namespace spooder {
+class CommandScheduler {
+  public:
+  /**
+   * Runs a tree of commands to completion in the calling task, stepping every running command once
+   * per tick. Commands composed in parallel therefore run at the same time without a task of their
+   * own, and a sequence moves on to its next command on the same tick the previous one finishes.
+   *
+   * When a run ends, the start time and duration of every command (relative to the start of the
+   * run) are logged and sent to telemetry on the ``command`` channel as
+   * ``<name>,<depth>,<start ms>,<duration ms>,<interrupted>``. Commands that never started are
+   * left out.
+   *
+   * @param itimeUtil The TimeUtil.
+   * @param iperiod The time between ticks.
+   * @param itelemetry The telemetry sink timings are sent to.
+   * @param ilogger The logger this instance will log to.
+   */
+  explicit CommandScheduler(
+    const okapi::TimeUtil &itimeUtil,
+    okapi::QTime iperiod = 10 * okapi::millisecond,
+    std::shared_ptr<Telemetry> itelemetry = Telemetry::getDefaultTelemetry(),
+    std::shared_ptr<okapi::Logger> ilogger = okapi::Logger::getDefaultLogger());
+
+  /**
+   * Runs a command until it finishes. Blocks the calling task.
+   *
+   * @param icommand The command, usually a group. It must not have run before.
+   * @return How long the command ran for.
+   */
+  okapi::QTime run(Command &icommand);
+
+  /**
+   * @return When each command in the last run ran, relative to the start of the run, in the order
+   * the commands are nested.
+   */
+  const std::vector<CommandTiming> &getTimings() const;
+
+  /**
+   * @return The number of ticks in the last run that took longer than the tick period.
+   */
+  std::size_t getOverruns() const;
+
+  protected:
+  okapi::TimeUtil timeUtil;
+  okapi::QTime period;
+  std::shared_ptr<Telemetry> telemetry;
+  std::shared_ptr<okapi::Logger> logger;
+  std::vector<CommandTiming> timings;
+  std::size_t overruns{0};
+
+  /**
+   * Logs and sends every timing.
+   */
+  void report(okapi::QTime ilength);
+};
+} // namespace spooder
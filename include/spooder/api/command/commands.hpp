@@ -0,0 +1,145 @@
+#pragma once
+
+#include "okapi/api/control/async/asyncMotionProfileController.hpp"
+#include "okapi/api/control/controllerInput.hpp"
+#include "okapi/api/device/motor/abstractMotor.hpp"
+#include "spooder/api/command/command.hpp"
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace spooder {
+class InstantCommand : public Command {
+  public:
+  /**
+   * Calls a function once and finishes on the same tick.
+   *
+   * @param iname The name the command is reported with.
+   * @param ifunction The function to call.
+   */
+  InstantCommand(std::string iname, std::function<void()> ifunction);
+
+  protected:
+  std::function<void()> function;
+
+  void initialize() override;
+  bool isFinished() override;
+};
+
+class WaitCommand : public Command {
+  public:
+  /**
+   * Finishes after some time.
+   *
+   * @param itime The time to wait.
+   */
+  explicit WaitCommand(okapi::QTime itime);
+
+  protected:
+  okapi::QTime time;
+
+  bool isFinished() override;
+};
+
+class WaitUntilCommand : public Command {
+  public:
+  /**
+   * Finishes once a condition is true. The condition is checked once per tick.
+   *
+   * @param iname The name the command is reported with.
+   * @param icondition The condition.
+   */
+  WaitUntilCommand(std::string iname, std::function<bool()> icondition);
+
+  protected:
+  std::function<bool()> condition;
+
+  bool isFinished() override;
+};
+
+class DrivePathCommand : public Command {
+  public:
+  /**
+   * Follows a path generated by an AsyncMotionProfileController and finishes when the controller
+   * settles. Cancelling the command stops the chassis.
+   *
+   * @param icontroller The controller that generated the path.
+   * @param ipathId The path's name.
+   * @param ibackwards Whether to follow the path backwards.
+   * @param imirrored Whether to follow the path mirrored.
+   */
+  DrivePathCommand(std::shared_ptr<okapi::AsyncMotionProfileController> icontroller,
+                   std::string ipathId,
+                   bool ibackwards = false,
+                   bool imirrored = false);
+
+  protected:
+  std::shared_ptr<okapi::AsyncMotionProfileController> controller;
+  std::string pathId;
+  bool backwards;
+  bool mirrored;
+
+  void initialize() override;
+  bool isFinished() override;
+  void end(bool iinterrupted) override;
+};
+
+class SpinToVelocityCommand : public Command {
+  public:
+  /**
+   * Sets a motor's velocity target and finishes once the motor has stayed within a tolerance of it
+   * for some time. The motor keeps spinning afterwards, so a flywheel can be spun up in parallel
+   * with a drive and stay at speed for the shots after it.
+   *
+   * @param imotor The motor.
+   * @param ivelocity The velocity target in the motor's gearset units (RPM).
+   * @param itolerance How close the velocity must be to the target, in RPM.
+   * @param idwellTime How long the velocity must stay within tolerance.
+   * @param ivelocitySensor Where to read the velocity from, such as a MotorVelocityEstimator, or
+   * nullptr to read ``getActualVelocity()``.
+   */
+  SpinToVelocityCommand(std::shared_ptr<okapi::AbstractMotor> imotor,
+                        double ivelocity,
+                        double itolerance = 15,
+                        okapi::QTime idwellTime = 100 * okapi::millisecond,
+                        std::shared_ptr<okapi::ControllerInput<double>> ivelocitySensor = nullptr);
+
+  protected:
+  std::shared_ptr<okapi::AbstractMotor> motor;
+  double velocity;
+  double tolerance;
+  okapi::QTime dwellTime;
+  std::shared_ptr<okapi::ControllerInput<double>> velocitySensor;
+  bool inBand{false};
+  okapi::QTime inBandSince{0 * okapi::millisecond};
+
+  void initialize() override;
+  bool isFinished() override;
+};
+
+class RunUntilCommand : public Command {
+  public:
+  /**
+   * Runs a motor at a voltage until a condition is true, then stops it. For example, runs the
+   * intake until a sensor sees a disc.
+   *
+   * @param iname The name the command is reported with.
+   * @param imotor The motor.
+   * @param ivoltage The voltage in millivolts.
+   * @param icondition The condition. It is checked once per tick.
+   */
+  RunUntilCommand(std::string iname,
+                  std::shared_ptr<okapi::AbstractMotor> imotor,
+                  std::int16_t ivoltage,
+                  std::function<bool()> icondition);
+
+  protected:
+  std::shared_ptr<okapi::AbstractMotor> motor;
+  std::int16_t voltage;
+  std::function<bool()> condition;
+
+  void initialize() override;
+  bool isFinished() override;
+  void end(bool iinterrupted) override;
+};
+} // namespace spooder
@@ -0,0 +1,207 @@
+#pragma once
+
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "spooder/api/util/settleEvent.hpp"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Starts a routine body. Everything from here to ROUTINE_END can suspend with the ROUTINE_AWAIT
+ * macros and resume where it left off.
+ */
+#define ROUTINE_BEGIN                                                                              \
+  switch (resumePoint) {                                                                           \
+  case 0:
+
+/**
+ * Ends a routine body.
+ */
+#define ROUTINE_END }
+
+/**
+ * Suspends the routine after running ``setup``, and resumes on the next line once the runner sees
+ * the wait is over. Use at most one await per source line.
+ */
+#define ROUTINE_SUSPEND(setup)                                                                     \
+  do {                                                                                             \
+    setup;                                                                                         \
+    resumePoint = __LINE__;                                                                        \
+    return;                                                                                        \
+  case __LINE__:;                                                                                  \
+  } while (0)
+
+/**
+ * Suspends the routine for some time.
+ */
+#define ROUTINE_DELAY(time) ROUTINE_SUSPEND(awaitDelay(time))
+
+/**
+ * Suspends the routine until a SettleEvent is set. The runner sleeps until then instead of
+ * polling.
+ */
+#define ROUTINE_AWAIT_EVENT(event) ROUTINE_SUSPEND(awaitEvent(event))
+
+/**
+ * Suspends the routine until a controller built with createNotifyingTimeUtil() settles. Like
+ * spooder::waitUntilSettled(), it sleeps on the controller's event and then confirms with
+ * ``isSettled()``.
+ */
+#define ROUTINE_AWAIT_SETTLED(controller, event)                                                   \
+  while (!(controller).isSettled())                                                                \
+  ROUTINE_AWAIT_EVENT(event)
+
+/**
+ * Suspends the routine until a condition, such as a sensor reading, is true. Conditions are
+ * checked every poll period of the runner while a routine waits on one.
+ */
+#define ROUTINE_AWAIT(condition) ROUTINE_SUSPEND(awaitCondition([this]() { return (condition); }))
+
+namespace spooder {
+class RoutineRunner;
+
+class Routine {
+  public:
+  virtual ~Routine() = default;
+
+  /**
+   * @return Whether the body has run to its end.
+   */
+  bool isFinished() const;
+
+  /**
+   * @return The name the routine is reported with.
+   */
+  const std::string &getName() const;
+
+  protected:
+  /**
+   * A piece of an autonomous routine that can wait on delays, controller events, and sensors
+   * without a task of its own. Many routines run concurrently in one RoutineRunner and share its
+   * task's stack.
+   *
+   * The body is a stackless coroutine written with the ROUTINE_ macros. Local variables do not
+   * survive an await, so keep state in members:
+   *
+   * ```cpp
+   * class Intake : public Routine {
+   *   public:
+   *   Intake() : Routine("intake") {}
+   *
+   *   protected:
+   *   void body() override {
+   *     ROUTINE_BEGIN
+   *     ROUTINE_DELAY(500_ms);
+   *     intake->moveVoltage(12000);
+   *     ROUTINE_AWAIT(discs->getCount() == 3);
+   *     intake->moveVoltage(0);
+   *     ROUTINE_END
+   *   }
+   * };
+   * ```
+   *
+   * @param iname The name the routine is reported with.
+   */
+  explicit Routine(std::string iname);
+
+  /**
+   * The routine's code. Called each time the routine resumes.
+   */
+  virtual void body() = 0;
+
+  /**
+   * @return The runner's time when the routine last resumed.
+   */
+  okapi::QTime getTime() const;
+
+  /**
+   * The line to resume from. Used by the ROUTINE_ macros.
+   */
+  int resumePoint{0};
+
+  /**
+   * Waits until ``itime`` after the current resume. Used by ROUTINE_DELAY.
+   */
+  void awaitDelay(okapi::QTime itime);
+
+  /**
+   * Waits until the event is set. Used by ROUTINE_AWAIT_EVENT.
+   */
+  void awaitEvent(SettleEvent &ievent);
+
+  /**
+   * Waits until the condition is true. Used by ROUTINE_AWAIT.
+   */
+  void awaitCondition(std::function<bool()> icondition);
+
+  private:
+  friend class RoutineRunner;
+
+  enum class Wait { start, delay, event, condition, finished };
+
+  std::string name;
+  Wait wait{Wait::start};
+  okapi::QTime now{0 * okapi::millisecond};
+  okapi::QTime deadline{0 * okapi::millisecond};
+  SettleEvent *event{nullptr};
+  std::function<bool()> condition;
+  SettleEvent *wake{nullptr};
+
+  /**
+   * @return Whether the routine's wait is over.
+   */
+  bool isReady(okapi::QTime inow) const;
+
+  /**
+   * Runs the body until its next await or its end.
+   */
+  void resume(okapi::QTime inow);
+};
+
+class RoutineRunner {
+  public:
+  /**
+   * Runs routines concurrently in the calling task. Between resumes the task sleeps until the
+   * next delay ends or an awaited event is set, so routines waiting on delays and controller
+   * events cost nothing while they wait. Only routines waiting on plain conditions are polled.
+   *
+   * @param itimer The timer routines are timed with.
+   * @param ipollPeriod How often conditions are checked while a routine waits on one.
+   * @param ilogger The logger this instance will log to.
+   */
+  explicit RoutineRunner(
+    std::unique_ptr<okapi::AbstractTimer> itimer,
+    okapi::QTime ipollPeriod = 10 * okapi::millisecond,
+    std::shared_ptr<okapi::Logger> ilogger = okapi::Logger::getDefaultLogger());
+
+  /**
+   * Adds a routine to run. It must outlive the runner.
+   *
+   * @param iroutine The routine.
+   */
+  void add(Routine &iroutine);
+
+  /**
+   * Runs every added routine until all of them have finished. Blocks the calling task.
+   *
+   * @return How long the routines ran for.
+   */
+  okapi::QTime run();
+
+  /**
+   * @return The number of times the last run woke up to check on its routines.
+   */
+  std::size_t getWakeups() const;
+
+  protected:
+  std::unique_ptr<okapi::AbstractTimer> timer;
+  okapi::QTime pollPeriod;
+  std::shared_ptr<okapi::Logger> logger;
+  std::vector<Routine *> routines;
+  SettleEvent wake;
+  std::size_t wakeups{0};
+};
+} // namespace spooder
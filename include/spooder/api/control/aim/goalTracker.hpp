@@ -0,0 +1,133 @@
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/odometry/odometry.hpp"
+#include "okapi/api/units/QAngle.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/abstractRate.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include "spooder/api/device/vision/abstractGoalCamera.hpp"
+#include "spooder/api/util/poseHistory.hpp"
+#include "spooder/api/util/telemetry.hpp"
+#include <array>
+#include <atomic>
+#include <memory>
+
+namespace spooder {
+/**
+ * How a GoalTracker turns camera frames into a heading to the goal.
+ */
+struct GoalTrackerParams {
+  okapi::QAngle fieldOfView{61 * okapi::degree};  ///< The camera's horizontal field of view
+  double imageWidth{316};                         ///< The image's width in pixels
+  okapi::QAngle mountYaw{0 * okapi::degree};      ///< Where the camera points, clockwise positive
+  okapi::QTime latency{50 * okapi::millisecond};  ///< From a frame being seen to it being read
+  double minArea{60};                             ///< Smaller objects are noise, in pixels
+  okapi::QAngle gate{10 * okapi::degree};         ///< Objects further off the track are not it
+  double filterGain{0.5};                         ///< The weight of each new frame
+  int maxMissed{10};                              ///< Frames without the goal before it is lost
+};
+
+class GoalTracker {
+  public:
+  /**
+   * Tracks the goal's bearing from a camera. The bearing is kept in the odometry frame rather
+   * than the camera's, so turning the robot does not move the track, and the heading error is
+   * the track's bearing less the robot's heading now.
+   *
+   * A frame shows the goal as it was when the frame was taken, ``latency`` before it is read. Each
+   * object's bearing is its angle in the image plus the heading the robot had then, found in a
+   * history of odometry poses, so the robot turning while a frame is on its way does not show up
+   * as the goal moving.
+   *
+   * While tracking, the object closest to the track and within the gate updates it, so a second
+   * goal or a reflection in the frame is not jumped to. With no track, the largest object starts
+   * one. The track is low pass filtered, and is dropped after maxMissed frames without the goal.
+   *
+   * Acquiring and losing the goal are logged. Each step sends the number of objects seen, the
+   * bearing and heading error in degrees, and whether the goal is tracked to telemetry on the
+   * ``vision`` channel.
+   *
+   * @param icamera The camera.
+   * @param iodometry The chassis' odometry.
+   * @param itimeUtil The time utility used to time poses and frames.
+   * @param iparams How to track the goal.
+   * @param itelemetry The telemetry sink steps are reported to.
+   * @param ilogger The logger this instance will log to.
+   */
+  GoalTracker(std::shared_ptr<AbstractGoalCamera> icamera,
+              std::shared_ptr<okapi::Odometry> iodometry,
+              const okapi::TimeUtil &itimeUtil,
+              const GoalTrackerParams &iparams,
+              std::shared_ptr<Telemetry> itelemetry = Telemetry::getDefaultTelemetry(),
+              std::shared_ptr<okapi::Logger> ilogger = okapi::Logger::getDefaultLogger());
+
+  GoalTracker(const GoalTracker &) = delete;
+
+  GoalTracker &operator=(const GoalTracker &) = delete;
+
+  ~GoalTracker();
+
+  /**
+   * Records the robot's pose, reads a frame and updates the track.
+   */
+  void step();
+
+  /**
+   * @return Whether the goal is tracked.
+   */
+  bool hasGoal() const;
+
+  /**
+   * @return The goal's bearing in the odometry frame.
+   */
+  okapi::QAngle getBearing() const;
+
+  /**
+   * @return How far the robot must turn to face the goal, clockwise positive, as of the last step.
+   */
+  okapi::QAngle getHeadingError() const;
+
+  /**
+   * Starts a thread that steps every period. This should be called once, from ``initialize()``.
+   *
+   * @param irate The rate used to wait between steps.
+   * @param iperiod The time between steps. The V5 vision sensor makes a frame every 20 ms.
+   */
+  void startThread(std::unique_ptr<okapi::AbstractRate> irate,
+                   okapi::QTime iperiod = 20 * okapi::millisecond);
+
+  /**
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  protected:
+  std::shared_ptr<AbstractGoalCamera> camera;
+  std::shared_ptr<okapi::Odometry> odometry;
+  std::unique_ptr<okapi::AbstractTimer> timer;
+  GoalTrackerParams params;
+  std::shared_ptr<Telemetry> telemetry;
+  std::shared_ptr<okapi::Logger> logger;
+  double focalLength; // pixels
+  mutable CrossplatformMutex mutex;
+
+  PoseHistory<16> history;
+  std::array<GoalDetection, 4> detections;
+  bool tracking{false};
+  int missed{0};
+  okapi::QAngle bearing{0 * okapi::degree};
+  okapi::QAngle headingError{0 * okapi::degree};
+
+  std::unique_ptr<okapi::AbstractRate> rate;
+  okapi::QTime threadPeriod{20 * okapi::millisecond};
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  static void trampoline(void *context);
+
+  void loop();
+};
+} // namespace spooder
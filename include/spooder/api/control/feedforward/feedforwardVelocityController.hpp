@@ -0,0 +1,58 @@
+#pragma once
+
+#include "spooder/api/control/feedforward/simpleMotorFeedforward.hpp"
+
+namespace spooder {
+/**
+ * Gains for the feedback that trims a feedforward velocity controller, in volts and the velocity
+ * units of the feedforward. All zero turns the feedback off.
+ */
+struct VelocityTrimGains {
+  double kP{0};            ///< Volts per unit of velocity error
+  double kI{0};            ///< Volts per unit of velocity error, per second
+  double integralLimit{2}; ///< The most volts the integral term can add
+};
+
+class FeedforwardVelocityController {
+  public:
+  /**
+   * Turns a desired velocity and acceleration into a voltage with a characterized feedforward
+   * model, and trims it with PI feedback on the measured velocity. The feedforward does most of the
+   * work, so the feedback only corrects for what the model gets wrong and can be gentle.
+   *
+   * @param ifeedforward The feedforward constants.
+   * @param itrim The feedback gains.
+   * @param imaxVoltage The largest voltage to output, in volts.
+   */
+  FeedforwardVelocityController(const SimpleMotorFeedforward &ifeedforward,
+                                const VelocityTrimGains &itrim,
+                                double imaxVoltage = 12);
+
+  /**
+   * Calculates the voltage for one control period.
+   *
+   * @param ivelocity The desired velocity.
+   * @param iacceleration The desired acceleration.
+   * @param imeasured The measured velocity.
+   * @param idt The time since the last step, in seconds.
+   * @return The voltage in volts.
+   */
+  double step(double ivelocity, double iacceleration, double imeasured, double idt);
+
+  /**
+   * Clears the integral term.
+   */
+  void reset();
+
+  /**
+   * @return The feedforward constants.
+   */
+  const SimpleMotorFeedforward &getFeedforward() const;
+
+  protected:
+  SimpleMotorFeedforward feedforward;
+  VelocityTrimGains trim;
+  double maxVoltage;
+  double integral{0};
+};
+} // namespace spooder
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+namespace spooder {
+/**
+ * The feedforward model of a DC motor driven mechanism, ``V = kS sgn(v) + kV v + kA a``. The
+ * constants come from SystemCharacterizer, and their units follow whatever velocity units were
+ * used to find them (RPM at the mechanism, by default).
+ */
+struct SimpleMotorFeedforward {
+  double kS{0}; ///< Volts to overcome static friction
+  double kV{0}; ///< Volts per unit of velocity
+  double kA{0}; ///< Volts per unit of acceleration
+
+  /**
+   * Calculates the voltage needed to move at a velocity and acceleration.
+   *
+   * @param ivelocity The desired velocity.
+   * @param iacceleration The desired acceleration.
+   * @return The voltage in volts.
+   */
+  double calculate(const double ivelocity, const double iacceleration = 0) const {
+    const double direction = (ivelocity > 0) ? 1 : ((ivelocity < 0) ? -1 : 0);
+    return kS * direction + kV * ivelocity + kA * iacceleration;
+  }
+
+  /**
+   * @return The velocity reached at a voltage once acceleration dies out.
+   */
+  double maxVelocity(const double ivoltage) const {
+    return (kV > 0) ? std::copysign(std::max(0.0, std::abs(ivoltage) - kS), ivoltage) / kV : 0;
+  }
+
+  /**
+   * @return The time constant of the velocity response, ``kA / kV``, in the time unit of the
+   * acceleration.
+   */
+  double timeConstant() const {
+    return (kV > 0) ? kA / kV : 0;
+  }
+};
+} // namespace spooder
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "okapi/api/control/controllerInput.hpp"
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/abstractRate.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include "spooder/api/util/telemetry.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+
+namespace spooder {
+/**
+ * How a DiscCounter sees a disc go past its sensor. Distances are in millimeters.
+ */
+struct DiscCounterParams {
+  double enterBelow{50};  ///< Closer than this is a disc arriving
+  double exitAbove{80};   ///< Further than this is the disc gone
+  int enterSamples{2};    ///< Samples in a row closer than enterBelow; a single one is noise
+  int capacity{3};        ///< The most discs the robot may hold
+};
+
+class DiscCounter {
+  public:
+  /**
+   * Counts the discs in the robot with a distance sensor looking across the intake. A disc
+   * arrives when the distance is below enterBelow for enterSamples samples in a row, and has gone
+   * past when the distance rises above exitAbove. The gap between the two thresholds keeps a disc
+   * sitting on the edge of one from being counted over and over.
+   *
+   * A disc that goes past while the intake is moving discs in is added, and one that goes past
+   * while it moves them out, as when a jam is backed out or the driver spits a disc, is taken
+   * away. If the intake stopped while the disc was in front of the sensor, the way it was moving
+   * when the disc arrived is used. Shots are taken away with remove().
+   *
+   * Each disc that goes past is sent to telemetry on the ``disc`` channel with the count, which
+   * way it went, and the milliseconds it was in front of the sensor. Going over capacity is
+   * logged.
+   *
+   * @param isensor The sensor, reading in millimeters, such as an okapi::DistanceSensor.
+   * @param idirection Which way the intake is moving discs: 1 in, -1 out, 0 stopped.
+   * @param itimeUtil The time utility used to time discs.
+   * @param iparams How to see discs.
+   * @param itelemetry The telemetry sink discs are reported to.
+   * @param ilogger The logger this instance will log to.
+   */
+  DiscCounter(std::shared_ptr<okapi::ControllerInput<double>> isensor,
+              std::function<int()> idirection,
+              const okapi::TimeUtil &itimeUtil,
+              const DiscCounterParams &iparams,
+              std::shared_ptr<Telemetry> itelemetry = Telemetry::getDefaultTelemetry(),
+              std::shared_ptr<okapi::Logger> ilogger = okapi::Logger::getDefaultLogger());
+
+  DiscCounter(const DiscCounter &) = delete;
+
+  DiscCounter &operator=(const DiscCounter &) = delete;
+
+  ~DiscCounter();
+
+  /**
+   * Reads the sensor and counts a disc that has gone past.
+   */
+  void step();
+
+  /**
+   * Takes discs that left some other way than past the sensor, such as shots, off the count.
+   *
+   * @param icount The number of discs.
+   */
+  void remove(int icount = 1);
+
+  /**
+   * Sets the count, such as to the preloads at the start of a match.
+   *
+   * @param icount The number of discs in the robot.
+   */
+  void setCount(int icount);
+
+  /**
+   * @return The number of discs in the robot.
+   */
+  int getCount() const;
+
+  /**
+   * @return Whether the robot holds its capacity or more.
+   */
+  bool isFull() const;
+
+  /**
+   * @return Whether a disc is in front of the sensor.
+   */
+  bool isDiscPresent() const;
+
+  /**
+   * Starts a thread that steps every period. This should be called once, from ``initialize()``.
+   *
+   * @param irate The rate used to wait between steps.
+   * @param iperiod The time between steps. The brain reads the sensor every 10 ms, and a disc takes
+   * a few times that to go past it.
+   */
+  void startThread(std::unique_ptr<okapi::AbstractRate> irate,
+                   okapi::QTime iperiod = 10 * okapi::millisecond);
+
+  /**
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  protected:
+  std::shared_ptr<okapi::ControllerInput<double>> sensor;
+  std::function<int()> direction;
+  std::unique_ptr<okapi::AbstractTimer> timer;
+  DiscCounterParams params;
+  std::shared_ptr<Telemetry> telemetry;
+  std::shared_ptr<okapi::Logger> logger;
+  mutable CrossplatformMutex mutex;
+
+  int count{0};
+  bool present{false};
+  int closeSamples{0}; // samples in a row closer than enterBelow
+  okapi::QTime arrived{0 * okapi::millisecond}; // when the disc came closer than enterBelow
+  int arrivedDirection{0};
+
+  std::unique_ptr<okapi::AbstractRate> rate;
+  okapi::QTime threadPeriod{10 * okapi::millisecond};
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  static void trampoline(void *context);
+
+  void loop();
+};
+} // namespace spooder
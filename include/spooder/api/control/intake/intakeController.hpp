@@ -0,0 +1,172 @@
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/device/motor/abstractMotor.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/abstractRate.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include "spooder/api/util/telemetry.hpp"
+#include <atomic>
+#include <memory>
+
+namespace spooder {
+/**
+ * How an IntakeController tells a jam from a loaded intake, and how it clears one. Velocities are
+ * in RPM for the motor's gearset.
+ */
+struct IntakeJamParams {
+  std::int16_t minVoltage{6000};       ///< Slower commands are never treated as jammed
+  double stallVelocity{60};            ///< Slower than this counts as stopped
+  std::int32_t stallCurrent{1800};     ///< More draw than this counts as loaded, in mA
+  double stallTorque{0.25};            ///< More torque than this counts as loaded, in N*m
+  okapi::QTime stallTime{150 * okapi::millisecond};  ///< How long a stall lasts before it's a jam
+  okapi::QTime spinUpTime{250 * okapi::millisecond}; ///< Ignore stalls this long after starting
+  std::int16_t reverseVoltage{8000};   ///< How hard to back a jam out, in mV
+  okapi::QTime reverseTime{250 * okapi::millisecond};  ///< How long to back a jam out
+  okapi::QTime clearTime{500 * okapi::millisecond};    ///< Running this long clears the retries
+  int maxRetries{3};                   ///< Jams in a row before the intake gives up
+};
+
+class IntakeController {
+  public:
+  enum class State {
+    stopped,   ///< Commanded to stop
+    running,   ///< Running at the commanded voltage
+    reversing, ///< Backing a jam out before trying again
+    jammed     ///< Gave up after too many jams in a row; waits for a new command
+  };
+
+  /**
+   * Runs an intake at a commanded voltage and clears jams without the driver noticing. A jam is
+   * the motor running slower than stallVelocity while loaded, drawing more than stallCurrent,
+   * pushing more than stallTorque, or reporting it is over its current limit, for stallTime. A
+   * loaded but moving intake is just carrying discs, so speed is what decides.
+   *
+   * On a jam the intake reverses at reverseVoltage for reverseTime and then tries again. Jams
+   * in a row without clearTime of clean running between them count as one blockage; after
+   * maxRetries of them the intake stops and stays stopped until it is given a different command,
+   * rather than grinding against something it cannot clear.
+   *
+   * The time lost to each jam runs from when the intake stalled until it is running again. Each
+   * jam is logged, and sent to telemetry on the ``jam`` channel with the jam count, the retry it
+   * was, and the milliseconds lost to it once it clears or the intake gives up.
+   *
+   * @param imotor The intake motor. Set its brake mode and gearset as usual.
+   * @param itimeUtil The time utility used to time stalls and reversals.
+   * @param iparams How to detect and clear jams.
+   * @param itelemetry The telemetry sink jams are reported to.
+   * @param ilogger The logger this instance will log to.
+   */
+  IntakeController(std::shared_ptr<okapi::AbstractMotor> imotor,
+                   const okapi::TimeUtil &itimeUtil,
+                   const IntakeJamParams &iparams,
+                   std::shared_ptr<Telemetry> itelemetry = Telemetry::getDefaultTelemetry(),
+                   std::shared_ptr<okapi::Logger> ilogger = okapi::Logger::getDefaultLogger());
+
+  IntakeController(const IntakeController &) = delete;
+
+  IntakeController &operator=(const IntakeController &) = delete;
+
+  ~IntakeController();
+
+  /**
+   * Sets the voltage to run the intake at. Changing it ends a reversal, and lets a jammed intake
+   * try again.
+   *
+   * @param ivoltage The voltage in millivolts, 0 to stop.
+   */
+  void setTarget(std::int16_t ivoltage);
+
+  /**
+   * Changes how jams are detected and cleared.
+   *
+   * @param iparams The new parameters.
+   */
+  void setParams(const IntakeJamParams &iparams);
+
+  /**
+   * Reads the motor and commands it.
+   */
+  void step();
+
+  /**
+   * @return What the intake is doing.
+   */
+  State getState() const;
+
+  /**
+   * @return Which way the intake is moving discs: 1 in, -1 out, 0 stopped. It is the opposite of
+   * the target while a jam is backed out.
+   */
+  int getDirection() const;
+
+  /**
+   * @return The number of jams detected.
+   */
+  std::size_t getJamCount() const;
+
+  /**
+   * @return The time lost to jams, including one still being cleared.
+   */
+  okapi::QTime getTimeLost() const;
+
+  /**
+   * Starts a thread that steps every period. This should be called once, from ``initialize()``.
+   *
+   * @param irate The rate used to wait between steps.
+   * @param iperiod The time between steps.
+   */
+  void startThread(std::unique_ptr<okapi::AbstractRate> irate,
+                   okapi::QTime iperiod = 10 * okapi::millisecond);
+
+  /**
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  protected:
+  std::shared_ptr<okapi::AbstractMotor> motor;
+  std::unique_ptr<okapi::AbstractTimer> timer;
+  IntakeJamParams params;
+  std::shared_ptr<Telemetry> telemetry;
+  std::shared_ptr<okapi::Logger> logger;
+  mutable CrossplatformMutex mutex;
+
+  std::int16_t target{0};
+  State state{State::stopped};
+  okapi::QTime stateStart{0 * okapi::millisecond};  // when the intake last started or reversed
+  okapi::QTime stallStart{0 * okapi::millisecond};  // when the present stall started
+  okapi::QTime jamStart{0 * okapi::millisecond};    // when the jam being cleared started
+  bool stalling{false};
+  bool clearing{false}; // a jam has been detected and the intake is not running cleanly yet
+  int retries{0};
+  std::size_t jamCount{0};
+  okapi::QTime timeLost{0 * okapi::millisecond};
+
+  std::unique_ptr<okapi::AbstractRate> rate;
+  okapi::QTime threadPeriod{10 * okapi::millisecond};
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  /**
+   * @return Whether the motor is stopped against a load.
+   */
+  bool isStalled();
+
+  /**
+   * Starts running the intake at the target.
+   */
+  void run(okapi::QTime inow);
+
+  /**
+   * Counts the jam being cleared as over and reports the time lost to it.
+   */
+  void endJam(okapi::QTime inow);
+
+  static void trampoline(void *context);
+
+  void loop();
+};
+} // namespace spooder
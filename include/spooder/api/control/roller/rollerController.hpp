@@ -0,0 +1,194 @@
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/device/motor/abstractMotor.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/abstractRate.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include "spooder/api/device/optical/abstractColorSensor.hpp"
+#include "spooder/api/util/telemetry.hpp"
+#include <atomic>
+#include <memory>
+
+namespace spooder {
+enum class RollerColor {
+  none, ///< Nothing close enough, or no color the roller has
+  red,
+  blue
+};
+
+/**
+ * How a RollerController reads the roller's color and turns it. Hues are in degrees.
+ */
+struct RollerParams {
+  std::int16_t voltage{8000};                       ///< How hard to turn the roller, in mV
+  std::int32_t minProximity{100};                   ///< Less is not the roller, 0 to 255
+  double minSaturation{0.3};                        ///< Paler readings are grey, not a color
+  double redBelow{20};                              ///< Hues below this are red
+  double redAbove{330};                             ///< Hues above this are red too
+  double blueFrom{190};                             ///< Hues from this ...
+  double blueTo{250};                               ///< ... to this are blue
+  int confirmSamples{1};                            ///< Samples in a row before a color counts
+  okapi::QTime timeout{1500 * okapi::millisecond};  ///< Give up after turning this long
+};
+
+class RollerController {
+  public:
+  enum class State {
+    idle,    ///< Not turning, and never has
+    turning, ///< Turning until the target color shows up
+    done,    ///< Stopped on the target color
+    timedOut ///< Stopped after the timeout without seeing it
+  };
+
+  /**
+   * Turns a roller until the sensor sees the target color, then stops it. The sensor is read every
+   * step and the motor is stopped from the same step that sees the color, so nothing but the
+   * sensor's integration time and the step period stand between the color coming round and the
+   * roller stopping. Give the controller a motor that writes straight to the port rather than one
+   * behind a MotorCommandBatch, or the stop waits for the next flush.
+   *
+   * A reading is a color only when something is closer than minProximity and the reading is more
+   * saturated than minSaturation, since the hue of a grey or distant surface is noise.
+   *
+   * Each turn is logged and sent to telemetry on the ``roller`` channel with the number of turns,
+   * whether it ended on the target color, the milliseconds it took, the microseconds from the
+   * detecting sample being read to the stop being written, the number of samples and the largest
+   * gap between two samples in microseconds.
+   *
+   * @param imotor The roller motor. Use the hold brake mode so it stops where it is told to; the
+   * controller stops it with a zero velocity command, which is what the brake mode acts on.
+   * @param isensor The sensor facing the roller.
+   * @param itimeUtil The time utility used to time turns.
+   * @param iparams How to read and turn the roller.
+   * @param itelemetry The telemetry sink turns are reported to.
+   * @param ilogger The logger this instance will log to.
+   */
+  RollerController(std::shared_ptr<okapi::AbstractMotor> imotor,
+                   std::shared_ptr<AbstractColorSensor> isensor,
+                   const okapi::TimeUtil &itimeUtil,
+                   const RollerParams &iparams,
+                   std::shared_ptr<Telemetry> itelemetry = Telemetry::getDefaultTelemetry(),
+                   std::shared_ptr<okapi::Logger> ilogger = okapi::Logger::getDefaultLogger());
+
+  RollerController(const RollerController &) = delete;
+
+  RollerController &operator=(const RollerController &) = delete;
+
+  ~RollerController();
+
+  /**
+   * Sets the color to turn the roller to, which is the alliance's own.
+   *
+   * @param icolor The color.
+   */
+  void setTargetColor(RollerColor icolor);
+
+  /**
+   * Starts turning the roller. Does nothing while it is already turning.
+   */
+  void start();
+
+  /**
+   * Stops turning the roller.
+   */
+  void cancel();
+
+  /**
+   * Starts turning the roller and blocks until it stops, for autonomous routines. The thread must
+   * be running.
+   *
+   * @return Whether the roller stopped on the target color.
+   */
+  bool turnRoller();
+
+  /**
+   * Reads the sensor and stops the roller if it shows the target color.
+   */
+  void step();
+
+  /**
+   * @return What the roller is doing.
+   */
+  State getState() const;
+
+  /**
+   * @return The color the sensor saw last.
+   */
+  RollerColor getColor() const;
+
+  /**
+   * @return The time the last turn took.
+   */
+  okapi::QTime getCycleTime() const;
+
+  /**
+   * @return The time from the sample that saw the target color being read to the stop being
+   * written on the last turn that found it, in microseconds.
+   */
+  std::uint32_t getLatency() const;
+
+  /**
+   * @return The largest time between two samples on the last turn, in microseconds.
+   */
+  std::uint32_t getMaxSampleGap() const;
+
+  /**
+   * Starts a thread that steps every period. This should be called once, from ``initialize()``.
+   *
+   * @param irate The rate used to wait between steps.
+   * @param iperiod The time between steps. Keep it shorter than the sensor's integration time so
+   * each new reading is seen soon after it is made.
+   */
+  void startThread(std::unique_ptr<okapi::AbstractRate> irate,
+                   okapi::QTime iperiod = 5 * okapi::millisecond);
+
+  /**
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  protected:
+  std::shared_ptr<okapi::AbstractMotor> motor;
+  std::shared_ptr<AbstractColorSensor> sensor;
+  okapi::TimeUtil timeUtil;
+  std::unique_ptr<okapi::AbstractTimer> timer;
+  RollerParams params;
+  std::shared_ptr<Telemetry> telemetry;
+  std::shared_ptr<okapi::Logger> logger;
+  mutable CrossplatformMutex mutex;
+
+  RollerColor target{RollerColor::red};
+  RollerColor color{RollerColor::none};
+  State state{State::idle};
+  okapi::QTime turnStart{0 * okapi::millisecond}; // when the turn started
+  okapi::QTime cycleTime{0 * okapi::millisecond};
+  std::uint64_t lastSample{0}; // when the last sample was read, in microseconds
+  std::uint32_t latency{0};
+  std::uint32_t maxSampleGap{0};
+  std::size_t samples{0};
+  std::size_t turns{0};
+  int seen{0}; // samples in a row of the target color
+
+  std::unique_ptr<okapi::AbstractRate> rate;
+  okapi::QTime threadPeriod{5 * okapi::millisecond};
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  /**
+   * @return The color the sensor sees.
+   */
+  RollerColor readColor();
+
+  /**
+   * Stops the roller and reports the turn.
+   */
+  void finish(State istate, okapi::QTime inow);
+
+  static void trampoline(void *context);
+
+  void loop();
+};
+} // namespace spooder
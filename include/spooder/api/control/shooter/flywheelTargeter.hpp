@@ -0,0 +1,65 @@
+#pragma once
+
+#include "okapi/api/units/QLength.hpp"
+#include "spooder/api/control/shooter/rpmTable.hpp"
+#include <functional>
+
+namespace spooder {
+/**
+ * Picks the flywheel velocity for where the robot is: it reads the distance to the goal and looks
+ * it up in the table for the angle changer's position. Each angle has its own table because the
+ * same distance needs a different speed at a different launch angle.
+ *
+ * The distance comes from a function, so it can be the odometry pose's distance to the goal, a
+ * distance sensor facing it, or one falling back to the other. Stepping calls it and reads a
+ * table, and neither allocates, so it can run every tick of a control loop.
+ *
+ * @tparam n The number of entries in each table.
+ */
+template <std::size_t n> class FlywheelTargeter {
+  public:
+  /**
+   * @param ilowTable The table for the angle changer down.
+   * @param ihighTable The table for the angle changer up.
+   * @param idistance Returns the distance to the goal.
+   */
+  FlywheelTargeter(const RpmTable<n> &ilowTable,
+                   const RpmTable<n> &ihighTable,
+                   std::function<okapi::QLength()> idistance)
+    : lowTable(ilowTable), highTable(ihighTable), distanceSource(std::move(idistance)) {
+  }
+
+  /**
+   * Reads the distance to the goal and picks the velocity.
+   *
+   * @param iangled Whether the angle changer is up.
+   * @return The flywheel velocity in RPM.
+   */
+  double step(const bool iangled) {
+    distance = distanceSource();
+    target = iangled ? highTable.get(distance) : lowTable.get(distance);
+    return target;
+  }
+
+  /**
+   * @return The distance read on the last step.
+   */
+  okapi::QLength getDistance() const {
+    return distance;
+  }
+
+  /**
+   * @return The velocity picked on the last step, in RPM.
+   */
+  double getTarget() const {
+    return target;
+  }
+
+  protected:
+  RpmTable<n> lowTable;
+  RpmTable<n> highTable;
+  std::function<okapi::QLength()> distanceSource;
+  okapi::QLength distance{0 * okapi::meter};
+  double target{0};
+};
+} // namespace spooder
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "okapi/api/units/QLength.hpp"
+#include <algorithm>
+#include <array>
+
+namespace spooder {
+/**
+ * A flywheel velocity for each of a few measured distances to the goal, interpolated in between.
+ * The entries live in a fixed size array, so looking a distance up never allocates and is cheap
+ * enough to do every tick.
+ *
+ * @tparam n The number of entries.
+ */
+template <std::size_t n> class RpmTable {
+  public:
+  static_assert(n >= 1, "An RpmTable needs at least one entry");
+
+  struct Entry {
+    okapi::QLength distance; ///< The distance to the goal
+    double rpm;              ///< The flywheel velocity that scores from there
+  };
+
+  /**
+   * @param ientries The measured entries, in any order. Two entries should not share a distance.
+   */
+  explicit RpmTable(const std::array<Entry, n> &ientries) : entries(ientries) {
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+      return a.distance < b.distance;
+    });
+  }
+
+  /**
+   * Looks up the velocity for a distance, interpolating between the entries either side of it.
+   * Distances outside the table get the velocity of the nearest end rather than an extrapolated
+   * one, since the table says nothing about how the shot behaves out there.
+   *
+   * @param idistance The distance to the goal.
+   * @return The flywheel velocity in RPM.
+   */
+  double get(const okapi::QLength idistance) const {
+    const auto upper = std::upper_bound(
+      entries.begin(), entries.end(), idistance, [](okapi::QLength distance, const Entry &entry) {
+        return distance < entry.distance;
+      });
+
+    if (upper == entries.begin()) {
+      return entries.front().rpm;
+    }
+    if (upper == entries.end()) {
+      return entries.back().rpm;
+    }
+
+    const Entry &below = *(upper - 1);
+    const double fraction = ((idistance - below.distance) / (upper->distance - below.distance))
+                              .convert(okapi::number);
+    return below.rpm + fraction * (upper->rpm - below.rpm);
+  }
+
+  /**
+   * @return The entries, sorted by distance.
+   */
+  const std::array<Entry, n> &getEntries() const {
+    return entries;
+  }
+
+  protected:
+  std::array<Entry, n> entries;
+};
+} // namespace spooder
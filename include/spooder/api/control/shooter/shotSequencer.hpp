@@ -0,0 +1,235 @@
+#pragma once
+
+#include "okapi/api/control/controllerInput.hpp"
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/abstractRate.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include "spooder/api/util/telemetry.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace spooder {
+/**
+ * When a ShotSequencer lets a disc go, and how it sees one leave. Velocities are in RPM.
+ */
+struct ShotParams {
+  double tolerance{15};                          ///< How close to the target a precise shot needs
+  okapi::QTime dwellTime{100 * okapi::millisecond}; ///< How long it must stay that close
+  double rapidTolerance{40};                     ///< How close to the target rapid fire needs
+  double shotDrop{25};                           ///< A drop this big means a disc went through
+  okapi::QTime feedTimeout{500 * okapi::millisecond}; ///< Feeding this long without a shot is empty
+};
+
+class ShotSequencer {
+  public:
+  enum class Mode {
+    precise, ///< Each disc waits for the flywheel to be back in band for the dwell time
+    rapid    ///< The indexer keeps feeding while the flywheel is in the wider rapid band
+  };
+
+  enum class State {
+    idle,    ///< No shots asked for
+    waiting, ///< Waiting for the flywheel to be ready
+    feeding, ///< The indexer is pushing a disc in
+    firing   ///< A disc is going through the flywheel
+  };
+
+  /**
+   * A shot, as recorded by the sequencer. Velocities are in RPM.
+   */
+  struct Shot {
+    okapi::QTime time;     ///< When the disc hit the flywheel
+    double target;         ///< The flywheel's target
+    double release;        ///< The flywheel's velocity as the disc hit it
+    double minimum;        ///< The lowest it dropped to
+    okapi::QTime interval; ///< The time since the last shot of the same burst, 0 for the first
+  };
+
+  /**
+   * Fires discs only when the flywheel is at speed. The flywheel is run by whatever already runs
+   * it; the sequencer reads its velocity and runs the indexer.
+   *
+   * In precise mode a disc is fed once the flywheel has stayed within tolerance of the target for
+   * the dwell time, and the indexer stops as soon as the disc is seen to go through, so the next
+   * disc waits for the flywheel to recover. In rapid mode there is no dwell, the band is
+   * rapidTolerance, and the indexer keeps running from one disc to the next as long as the
+   * flywheel stays in it, which trades some spread for the shortest time between shots.
+   *
+   * A disc going through shows up as the velocity dropping by shotDrop from its peak since the
+   * last shot. If the indexer feeds for feedTimeout without one, it is taken to be empty and
+   * the burst ends.
+   *
+   * Every shot is recorded, logged, and sent to telemetry on the ``shot`` channel with the shot
+   * count, the target, the velocity at release, the lowest velocity, and the milliseconds since
+   * the last shot of its burst.
+   *
+   * @param ivelocity Where to read the flywheel's velocity from, such as a MotorVelocityEstimator.
+   * Only the sequencer should step it.
+   * @param iindexer Turns the indexer on (true) or off (false). It is called on every step of a
+   * burst, starting with off, so it must be cheap to call with the same value again. Anything else
+   * that runs the same motor should only do so while the sequencer is idle.
+   * @param itimeUtil The time utility used to time dwells and shots.
+   * @param iparams When to fire and how to see a shot.
+   * @param itelemetry The telemetry sink shots are reported to.
+   * @param ilogger The logger this instance will log to.
+   */
+  ShotSequencer(std::shared_ptr<okapi::ControllerInput<double>> ivelocity,
+                std::function<void(bool)> iindexer,
+                const okapi::TimeUtil &itimeUtil,
+                const ShotParams &iparams,
+                std::shared_ptr<Telemetry> itelemetry = Telemetry::getDefaultTelemetry(),
+                std::shared_ptr<okapi::Logger> ilogger = okapi::Logger::getDefaultLogger());
+
+  ShotSequencer(const ShotSequencer &) = delete;
+
+  ShotSequencer &operator=(const ShotSequencer &) = delete;
+
+  ~ShotSequencer();
+
+  /**
+   * Sets the flywheel velocity shots are gated on. Set it wherever the flywheel's target is set.
+   * It may be set every tick; only a change bigger than the tolerance restarts the dwell.
+   *
+   * @param ivelocity The target in RPM, 0 while the flywheel is off.
+   */
+  void setTarget(double ivelocity);
+
+  /**
+   * @param imode How to fire.
+   */
+  void setMode(Mode imode);
+
+  /**
+   * Asks for some shots, on top of any still to go. A burst ends when they are done or the
+   * indexer is empty.
+   *
+   * @param ishots The number of shots.
+   */
+  void fire(int ishots);
+
+  /**
+   * Fires for as long as it is on, such as while a button is held. Turning it off cancels any
+   * shots still to go; a disc already going through is still recorded.
+   *
+   * @param ifiring Whether to fire.
+   */
+  void setFiring(bool ifiring);
+
+  /**
+   * Reads the velocity and runs the indexer.
+   */
+  void step();
+
+  /**
+   * @return Whether the flywheel is ready for a shot in the present mode.
+   */
+  bool isReady() const;
+
+  /**
+   * @return What the sequencer is doing.
+   */
+  State getState() const;
+
+  /**
+   * @return The flywheel velocity read on the last step, in RPM.
+   */
+  double getVelocity() const;
+
+  /**
+   * @return Every shot so far.
+   */
+  std::vector<Shot> getShots() const;
+
+  /**
+   * @return The number of shots so far.
+   */
+  std::size_t getShotCount() const;
+
+  /**
+   * @return The shots per second of the last burst with more than one shot, or 0 if there has not
+   * been one.
+   */
+  double getShotsPerSecond() const;
+
+  /**
+   * Starts a thread that steps every period. This should be called once, from ``initialize()``.
+   *
+   * @param irate The rate used to wait between steps.
+   * @param iperiod The time between steps.
+   */
+  void startThread(std::unique_ptr<okapi::AbstractRate> irate,
+                   okapi::QTime iperiod = 10 * okapi::millisecond);
+
+  /**
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  protected:
+  std::shared_ptr<okapi::ControllerInput<double>> velocitySensor;
+  std::function<void(bool)> indexer;
+  std::unique_ptr<okapi::AbstractTimer> timer;
+  ShotParams params;
+  std::shared_ptr<Telemetry> telemetry;
+  std::shared_ptr<okapi::Logger> logger;
+  mutable CrossplatformMutex mutex;
+
+  double target{0};
+  Mode mode{Mode::precise};
+  State state{State::idle};
+  int remaining{0}; // shots still to go, negative while firing until told to stop
+  bool indexing{false};
+
+  double velocity{0};
+  bool inBand{false};
+  okapi::QTime inBandSince{0 * okapi::millisecond};
+  okapi::QTime feedStart{0 * okapi::millisecond};
+  double peak{0};    // highest velocity since the last shot
+  double minimum{0}; // lowest velocity of the shot going through
+  okapi::QTime shotTime{0 * okapi::millisecond};
+
+  std::vector<Shot> shots;
+  std::size_t burstShots{0};
+  okapi::QTime burstStart{0 * okapi::millisecond}; // when the burst's first shot went through
+  double shotsPerSecond{0};
+
+  std::unique_ptr<okapi::AbstractRate> rate;
+  okapi::QTime threadPeriod{10 * okapi::millisecond};
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  /**
+   * @return Whether the flywheel has been in band long enough to feed a disc.
+   */
+  bool ready(okapi::QTime inow) const;
+
+  /**
+   * Turns the indexer on or off if it is not already.
+   */
+  void setIndexer(bool ion);
+
+  /**
+   * Starts feeding a disc.
+   */
+  void feed(okapi::QTime inow);
+
+  /**
+   * Records the shot that just went through and decides what to do next.
+   */
+  void finishShot(okapi::QTime inow);
+
+  /**
+   * Ends the burst and stops the indexer.
+   */
+  void endBurst();
+
+  static void trampoline(void *context);
+
+  void loop();
+};
+} // namespace spooder
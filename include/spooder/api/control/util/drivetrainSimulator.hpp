@@ -0,0 +1,283 @@
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/device/motor/abstractMotor.hpp"
+#include "okapi/api/odometry/odomState.hpp"
+#include "okapi/api/units/QAngularSpeed.hpp"
+#include "okapi/api/units/QLength.hpp"
+#include "okapi/api/units/QSpeed.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/abstractRate.hpp"
+#include "spooder/api/util/simulatedTime.hpp"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace spooder {
+class DrivetrainSimulator : public SimulationClock {
+  public:
+  /**
+   * The physical description of the drivetrain. Lengths are in meters, masses in kilograms, and
+   * inertias in kg*m^2.
+   */
+  struct Parameters {
+    /**
+     * The drive cartridge and the external ratio, with the same meaning as in ChassisScales.
+     */
+    okapi::AbstractMotor::GearsetRatioPair gearset{okapi::AbstractMotor::gearset::green};
+    std::size_t motorsPerSide = 3;
+    double wheelDiameter = 0.08255; // 3.25 in
+    double trackWidth = 0.2921;     // 11.5 in, center to center of the wheels
+    double wheelbase = 0.28;        // front to back wheel, which sets the turning scrub
+    double mass = 6.5;
+    double momentOfInertia = 0.22;  // about the center, ignoring the wheels
+    double sideInertia = 1.2e-3;    // everything that spins with one side, at the wheel
+    double muStatic = 1.0;          // longitudinal wheel grip before slipping
+    double muKinetic = 0.8;         // longitudinal wheel grip while slipping
+    double scrubFriction = 0.3;     // lateral friction of the wheels that slide when turning
+    double rollingFriction = 0.03;  // rolling resistance as a fraction of the weight
+    double supplyVoltage = 12;      // most the motors can apply; drops as the battery sags
+  };
+
+  /**
+   * How a motor is being driven, like the V5 motor's internal control modes.
+   */
+  enum class MotorMode { voltage, velocity, position };
+
+  /**
+   * A motor command in the units of the physical cartridge output.
+   */
+  struct MotorCommand {
+    MotorMode mode{MotorMode::voltage};
+    double target{0};      ///< volts, RPM, or degrees
+    double maxVelocity{0}; ///< RPM, for position mode
+  };
+
+  /**
+   * A motor's measurements in the units of the physical cartridge output. Like the real motor,
+   * these are only refreshed every sensor period.
+   */
+  struct MotorReading {
+    double position{0}; ///< degrees
+    double velocity{0}; ///< RPM
+    double voltage{0};  ///< volts
+    double current{0};  ///< amps
+    double torque{0};   ///< N*m
+    okapi::QTime timestamp{0 * okapi::millisecond};
+  };
+
+  /**
+   * Simulates a tank (skid steer) drivetrain with several motors per side. Each side's wheels are
+   * chained together, and each motor follows the V5 motor's linear torque-speed curve, current
+   * limit, brake modes, and internal velocity and position control. The wheels grip the field up
+   * to a friction limit and slip past it, and the wheels at the ends of the drive scrub sideways
+   * when the robot turns.
+   *
+   * Motors ``0 .. motorsPerSide - 1`` are on the left and the rest on the right. A positive
+   * command drives its side forward. The pose follows okapi's frame-transformation convention:
+   * ``x`` forward, ``y`` to the right, and ``theta`` clockwise.
+   *
+   * The simulator steps in fixed increments of the time step, so results do not depend on how
+   * step() is called. Use SimulatedMotor to hand its motors to okapi, and createSimulatedTimeUtil
+   * to run okapi's controllers on its clock.
+   *
+   * @param iparams The physical description.
+   * @param itimestep The physics time step.
+   */
+  explicit DrivetrainSimulator(const Parameters &iparams,
+                               okapi::QTime itimestep = 1 * okapi::millisecond);
+
+  /**
+   * Simulates our competition drivetrain with the default Parameters.
+   */
+  DrivetrainSimulator();
+
+  ~DrivetrainSimulator() override;
+
+  /**
+   * Steps the simulation forward.
+   *
+   * @param idt How far to step. Rounded to a whole number of time steps.
+   */
+  void step(okapi::QTime idt);
+
+  okapi::QTime getTime() const override;
+
+  void advanceTo(okapi::QTime itime) override;
+
+  /**
+   * Puts the robot at rest at a pose and stops every motor. The time is not reset.
+   *
+   * @param ipose The new pose.
+   */
+  void reset(const okapi::OdomState &ipose = {});
+
+  /**
+   * @return The true pose of the robot.
+   */
+  okapi::OdomState getPose() const;
+
+  /**
+   * @return The forward velocity of the robot.
+   */
+  okapi::QSpeed getLinearVelocity() const;
+
+  /**
+   * @return The clockwise angular velocity of the robot.
+   */
+  okapi::QAngularSpeed getAngularVelocity() const;
+
+  /**
+   * @param ileft Whether to check the left or the right side.
+   * @return Whether that side's wheels are slipping.
+   */
+  bool isSlipping(bool ileft) const;
+
+  /**
+   * Sets the longitudinal wheel grip.
+   *
+   * @param imuStatic The grip before slipping, as a fraction of the weight.
+   * @param imuKinetic The grip while slipping, as a fraction of the weight.
+   */
+  void setTraction(double imuStatic, double imuKinetic);
+
+  /**
+   * @return The physical description.
+   */
+  Parameters getParameters() const;
+
+  /**
+   * @return The number of motors.
+   */
+  std::size_t getMotorCount() const;
+
+  /**
+   * @param imotor The motor index.
+   * @param icommand The new command.
+   */
+  void setCommand(std::size_t imotor, const MotorCommand &icommand);
+
+  /**
+   * @param imotor The motor index.
+   * @param imode The new brake mode, used when a motor is commanded to zero.
+   */
+  void setBrakeMode(std::size_t imotor, okapi::AbstractMotor::brakeMode imode);
+
+  /**
+   * @param imotor The motor index.
+   * @param ilimit The new current limit in amps.
+   */
+  void setCurrentLimit(std::size_t imotor, double ilimit);
+
+  /**
+   * @param imotor The motor index.
+   * @param ilimit The new voltage limit in volts.
+   */
+  void setVoltageLimit(std::size_t imotor, double ilimit);
+
+  /**
+   * @param imotor The motor index.
+   * @return The motor's latest measurements.
+   */
+  MotorReading getReading(std::size_t imotor) const;
+
+  /**
+   * Steps the simulation in real time in a background task, for when the simulated motors are
+   * handed to code that uses the normal (wall clock) TimeUtil, such as a ChassisController built
+   * on the robot.
+   *
+   * @param irate The rate used to wait between steps.
+   * @param iperiod The time between steps.
+   */
+  void startThread(std::unique_ptr<okapi::AbstractRate> irate,
+                   okapi::QTime iperiod = 5 * okapi::millisecond);
+
+  /**
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  /**
+   * The stall torque of the V5 motor's 100 RPM cartridge in N*m. The other cartridges scale it by
+   * their speed.
+   */
+  static constexpr double redStallTorque = 2.1;
+
+  /**
+   * The stall current of the V5 motor in amps.
+   */
+  static constexpr double stallCurrent = 2.5;
+
+  /**
+   * The V5 motor's full voltage.
+   */
+  static constexpr double nominalVoltage = 12;
+
+  protected:
+  struct Motor {
+    MotorCommand command;
+    okapi::AbstractMotor::brakeMode brakeMode{okapi::AbstractMotor::brakeMode::coast};
+    double currentLimit{stallCurrent};
+    double voltageLimit{nominalVoltage};
+    double integral{0}; // volts, from the internal velocity controller
+    double holdPosition{0};
+    bool holding{false};
+    double voltage{0};
+    double current{0};
+    double torque{0};
+    MotorReading reading;
+  };
+
+  struct Side {
+    double velocity{0}; // wheel surface speed, m/s
+    double position{0}; // wheel surface travel, m
+    bool slipping{false};
+  };
+
+  Parameters params;
+  const double dt; // seconds
+  const std::int64_t sensorPeriodSteps;
+  const double freeSpeed;   // rad/s at the cartridge output
+  const double stallTorque; // N*m at the cartridge output
+  const double normalForce; // per side, N
+
+  mutable CrossplatformMutex mutex;
+  std::int64_t steps{0};
+  std::vector<Motor> motors;
+  Side left, right;
+  double x{0}, y{0}, theta{0}; // m, m, rad clockwise
+  double linearVelocity{0};    // m/s
+  double angularVelocity{0};   // rad/s clockwise
+
+  std::unique_ptr<okapi::AbstractRate> rate;
+  okapi::QTime threadPeriod;
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  static void trampoline(void *iparam);
+
+  void loop();
+
+  void stepOnce();
+
+  /**
+   * Runs a motor's controller and finds its torque at the cartridge output.
+   *
+   * @param imotor The motor.
+   * @param ispeed The cartridge output speed in rad/s.
+   * @param iposition The cartridge output position in degrees.
+   * @return The torque in N*m.
+   */
+  double motorTorque(Motor &imotor, double ispeed, double iposition);
+
+  /**
+   * Applies a side's contact force, slipping if the motors ask for more than the wheels can grip.
+   *
+   * @param iside The side.
+   * @param idriveForce The motors' force at the wheel surface.
+   * @param igroundSpeed The speed of the field under that side.
+   * @return The force the field applies to the robot at that side.
+   */
+  double contactForce(Side &iside, double idriveForce, double igroundSpeed);
+};
+} // namespace spooder
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "okapi/api/control/closedLoopController.hpp"
+#include "okapi/api/control/util/settledUtil.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include "spooder/api/util/settleEvent.hpp"
+#include <memory>
+
+namespace spooder {
+class NotifyingSettledUtil : public okapi::SettledUtil {
+  public:
+  /**
+   * A SettledUtil that also sets an event while the control loop is settled and clears it while it
+   * is not. The okapi PID controllers check their SettledUtil on every step of their task, so the
+   * event is set the same step the loop settles.
+   *
+   * @param ievent The event to set and clear.
+   * @param iatTargetTimer A timer used to track `iatTargetTime`.
+   * @param iatTargetError The minimum error to be considered settled.
+   * @param iatTargetDerivative The minimum error derivative to be considered settled.
+   * @param iatTargetTime The minimum time within atTargetError to be considered settled.
+   */
+  NotifyingSettledUtil(std::shared_ptr<SettleEvent> ievent,
+                       std::unique_ptr<okapi::AbstractTimer> iatTargetTimer,
+                       double iatTargetError = 50,
+                       double iatTargetDerivative = 5,
+                       okapi::QTime iatTargetTime = 250 * okapi::millisecond);
+
+  bool isSettled(double ierror) override;
+
+  void reset() override;
+
+  protected:
+  std::shared_ptr<SettleEvent> event;
+};
+
+/**
+ * Makes a TimeUtil like ``itimeUtil`` whose SettledUtil also drives ``ievent``. Give the result to
+ * exactly one controller, since every SettledUtil it makes drives the same event.
+ *
+ * @param itimeUtil The TimeUtil whose timers and rates to use, such as
+ * ``TimeUtilFactory::createDefault()`` on the robot.
+ * @param ievent The event to set while the controller is settled.
+ * @param iatTargetError The minimum error to be considered settled.
+ * @param iatTargetDerivative The minimum error derivative to be considered settled.
+ * @param iatTargetTime The minimum time within atTargetError to be considered settled.
+ * @return The TimeUtil.
+ */
+okapi::TimeUtil createNotifyingTimeUtil(const okapi::TimeUtil &itimeUtil,
+                                        const std::shared_ptr<SettleEvent> &ievent,
+                                        double iatTargetError = 50,
+                                        double iatTargetDerivative = 5,
+                                        okapi::QTime iatTargetTime = 250 * okapi::millisecond);
+
+/**
+ * Blocks until a controller built with a TimeUtil from createNotifyingTimeUtil() settles. Unlike
+ * the controller's own waitUntilSettled(), which checks every 10 ms, this sleeps on the event and
+ * returns on the step the controller settles. The controller must check its SettledUtil from its
+ * own task, as the okapi PID controllers do.
+ *
+ * @param icontroller The controller.
+ * @param ievent The event its SettledUtil drives.
+ */
+template <typename Input, typename Output>
+void waitUntilSettled(okapi::ClosedLoopController<Input, Output> &icontroller,
+                      SettleEvent &ievent) {
+  // The event may still be set from before the last target change, so confirm with the
+  // controller. A check that finds it unsettled also clears the event.
+  while (!icontroller.isSettled()) {
+    ievent.wait();
+  }
+}
+} // namespace spooder
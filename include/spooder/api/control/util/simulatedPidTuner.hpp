@@ -0,0 +1,137 @@
+#pragma once
+
+#include "okapi/api/units/QTime.hpp"
+#include "spooder/api/control/util/simulatedPlant.hpp"
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace spooder {
+class SimulatedPIDTuner {
+  public:
+  struct Output {
+    double kP, kI, kD;
+  };
+
+  /**
+   * Tunes a position PID controller with the same particle swarm search and cost as
+   * okapi::PIDTuner, but against a simulated plant instead of the robot. Each particle is scored
+   * by running a simulated step response in simulated time, so no loop waits for real time, and
+   * on a desktop (``THREADS_STD``) all particles of an iteration are scored in parallel.
+   *
+   * The simulated controller has the same structure and gain units as
+   * okapi::IterativePosPIDController, so the resulting gains can be loaded on the robot directly.
+   *
+   * @param iplantSupplier Makes a fresh plant. Called once per particle per iteration, possibly
+   * from several threads at once.
+   * @param itimeout The longest a step response is simulated for.
+   * @param igoal The step response target.
+   * @param ikPMin The minimum kP.
+   * @param ikPMax The maximum kP.
+   * @param ikIMin The minimum kI.
+   * @param ikIMax The maximum kI.
+   * @param ikDMin The minimum kD.
+   * @param ikDMax The maximum kD.
+   * @param inumIterations The number of swarm iterations.
+   * @param inumParticles The number of particles.
+   * @param ikSettle The weight of the settling time (in ms) in the cost.
+   * @param ikITAE The weight of the integral of time-weighted absolute error in the cost.
+   * @param iseed The random seed, so a tuning run can be repeated exactly.
+   */
+  SimulatedPIDTuner(std::function<std::unique_ptr<SimulatedPlant>()> iplantSupplier,
+                    okapi::QTime itimeout,
+                    double igoal,
+                    double ikPMin,
+                    double ikPMax,
+                    double ikIMin,
+                    double ikIMax,
+                    double ikDMin,
+                    double ikDMax,
+                    std::size_t inumIterations = 20,
+                    std::size_t inumParticles = 64,
+                    double ikSettle = 1,
+                    double ikITAE = 2,
+                    std::uint32_t iseed = 0);
+
+  /**
+   * Runs the search.
+   *
+   * @return The best gains found.
+   */
+  Output autotune();
+
+  /**
+   * Scores one set of gains with a simulated step response. Lower is better.
+   *
+   * @param igains The gains to score.
+   * @return The cost: ``kSettle * settle time (ms) + kITAE * ITAE``.
+   */
+  double evaluate(const Output &igains) const;
+
+  /**
+   * @return The cost of the gains last returned by autotune().
+   */
+  double getBestCost() const;
+
+  /**
+   * Sets the settled condition, which matches okapi::SettledUtil.
+   *
+   * @param iatTargetError The largest error that counts as at the target.
+   * @param iatTargetDerivative The largest error change per step that counts as stopped.
+   * @param iatTargetTime How long the error must stay at the target to count as settled.
+   */
+  void setSettledParams(double iatTargetError,
+                        double iatTargetDerivative,
+                        okapi::QTime iatTargetTime);
+
+  /**
+   * Sets the simulated controller sample time.
+   *
+   * @param isampleTime The sample time.
+   */
+  void setSampleTime(okapi::QTime isampleTime);
+
+  /**
+   * Sets the number of threads used on a desktop.
+   *
+   * @param ithreads The number of threads, or 0 for one per core.
+   */
+  void setThreads(std::size_t ithreads);
+
+  protected:
+  static constexpr double inertia = 0.5;   // Particle inertia
+  static constexpr double confSelf = 1.1;  // Self confidence
+  static constexpr double confSwarm = 1.2; // Particle swarm confidence
+
+  struct Particle {
+    double pos, vel, best;
+  };
+
+  struct ParticleSet {
+    Particle kP, kI, kD;
+    double bestError;
+  };
+
+  std::function<std::unique_ptr<SimulatedPlant>()> plantSupplier;
+  const okapi::QTime timeout;
+  const double goal;
+  const double kPMin;
+  const double kPMax;
+  const double kIMin;
+  const double kIMax;
+  const double kDMin;
+  const double kDMax;
+  const std::size_t numIterations;
+  const std::size_t numParticles;
+  const double kSettle;
+  const double kITAE;
+  const std::uint32_t seed;
+
+  double atTargetError = 50;
+  double atTargetDerivative = 5;
+  okapi::QTime atTargetTime = 250 * okapi::millisecond;
+  okapi::QTime sampleTime = 10 * okapi::millisecond;
+  std::size_t threads = 0;
+  double bestCost = 0;
+};
+} // namespace spooder
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "okapi/api/units/QTime.hpp"
+
+namespace spooder {
+/**
+ * A simulated system for a controller to drive, used to tune and test controllers off the robot.
+ */
+class SimulatedPlant {
+  public:
+  virtual ~SimulatedPlant() = default;
+
+  /**
+   * Returns the plant to its initial state.
+   */
+  virtual void reset() = 0;
+
+  /**
+   * Applies a control input for one time step.
+   *
+   * @param icontrol The control input in the range ``[-1, 1]``, like a controller output.
+   * @param idt The length of the time step.
+   * @return The measured output after the step, like a sensor reading.
+   */
+  virtual double step(double icontrol, okapi::QTime idt) = 0;
+};
+
+/**
+ * A DC motor driven mechanism described by the feedforward constants from system identification:
+ * ``V = kS sgn(v) + kV v + kA a``. This fits both a flywheel and one side of a drivetrain.
+ */
+class MotorModelPlant : public SimulatedPlant {
+  public:
+  /**
+   * @param ikS The voltage needed to overcome static friction.
+   * @param ikV The voltage per unit of velocity.
+   * @param ikA The voltage per unit of acceleration.
+   * @param ioutputPosition Whether step() returns position (true) or velocity (false).
+   * @param imaxVoltage The voltage a control input of 1 applies.
+   */
+  MotorModelPlant(double ikS,
+                  double ikV,
+                  double ikA,
+                  bool ioutputPosition = true,
+                  double imaxVoltage = 12);
+
+  void reset() override;
+
+  double step(double icontrol, okapi::QTime idt) override;
+
+  /**
+   * @return The current position.
+   */
+  double getPosition() const;
+
+  /**
+   * @return The current velocity.
+   */
+  double getVelocity() const;
+
+  protected:
+  double kS;
+  double kV;
+  double kA;
+  bool outputPosition;
+  double maxVoltage;
+  double position = 0;
+  double velocity = 0;
+};
+} // namespace spooder
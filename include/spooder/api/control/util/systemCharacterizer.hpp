@@ -0,0 +1,135 @@
+#pragma once
+
+#include "okapi/api/device/motor/abstractMotor.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include "spooder/api/control/feedforward/simpleMotorFeedforward.hpp"
+#include "spooder/api/filter/motorVelocityEstimator.hpp"
+#include "spooder/api/util/telemetry.hpp"
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace spooder {
+class SystemCharacterizer {
+  public:
+  struct Sample {
+    double time;         ///< seconds since the test started
+    double voltage;      ///< volts, as measured by the motor
+    double velocity;     ///< RPM at the output of any external gear ratio
+    double acceleration; ///< RPM per second
+  };
+
+  /**
+   * Finds the feedforward constants of one or more mechanisms by applying known voltages and
+   * recording how they respond, then fitting ``V = kS sgn(v) + kV v + kA a`` to the recording.
+   *
+   * All motors are driven together, so a drivetrain is characterized by passing both sides; each
+   * side gets its own constants. Run at least one quasistatic test (a slow voltage ramp, which
+   * mostly measures kS and kV) and one dynamic test (a voltage step, which measures kA) before
+   * calling fit(). The robot moves during the tests, so give it room.
+   *
+   * Velocity and acceleration come from the motors' timestamped encoder readings through
+   * MotorVelocityEstimator. Every sample is also sent to telemetry on the ``sysid`` channel.
+   *
+   * @param imotors The motors (or motor groups) to characterize.
+   * @param itimeUtil The time utility used for timing the tests.
+   * @param iratio Any external gear ratio (output / motor), so velocities are at the mechanism.
+   * @param itelemetry The telemetry sink samples are sent to.
+   * @param ilogger The logger this instance will log to.
+   */
+  SystemCharacterizer(std::vector<std::shared_ptr<okapi::AbstractMotor>> imotors,
+                      const okapi::TimeUtil &itimeUtil,
+                      double iratio = 1,
+                      std::shared_ptr<Telemetry> itelemetry = Telemetry::getDefaultTelemetry(),
+                      std::shared_ptr<okapi::Logger> ilogger = okapi::Logger::getDefaultLogger());
+
+  /**
+   * Ramps the voltage up slowly from zero so the mechanism is barely accelerating. Blocks until
+   * the ramp reaches ``imaxVoltage`` or ``itimeout`` passes, then stops the motors and waits for
+   * them to come to rest.
+   *
+   * @param irampRate The ramp rate in volts per second.
+   * @param imaxVoltage The voltage to stop at.
+   * @param ireverse Whether to drive backwards.
+   * @param itimeout The longest the test may run.
+   */
+  void runQuasistatic(double irampRate = 0.25,
+                      double imaxVoltage = 7,
+                      bool ireverse = false,
+                      okapi::QTime itimeout = 30 * okapi::second);
+
+  /**
+   * Applies a voltage step from rest. Blocks for ``iduration``, then stops the motors and waits
+   * for them to come to rest.
+   *
+   * @param istepVoltage The step voltage.
+   * @param iduration How long to apply it.
+   * @param ireverse Whether to drive backwards.
+   */
+  void runDynamic(double istepVoltage = 6,
+                  okapi::QTime iduration = 2 * okapi::second,
+                  bool ireverse = false);
+
+  /**
+   * Fits the feedforward constants of every motor to the samples recorded so far. The results are
+   * also logged and sent to telemetry on the ``sysidfit`` channel.
+   *
+   * @return The constants for each motor, in the order the motors were given.
+   */
+  std::vector<SimpleMotorFeedforward> fit() const;
+
+  /**
+   * Fits ``V = kS sgn(v) + kV v + kA a`` to a recording by least squares, in its discrete form:
+   * each sample's velocity is predicted from the sample before it, so the recorded accelerations
+   * are not used. Samples must be evenly spaced, with each test's time starting from zero. Samples
+   * slower than ``iminVelocity`` are skipped, since static friction makes them meaningless.
+   *
+   * @param isamples The recording.
+   * @param iminVelocity The slowest sample to use.
+   * @return The constants, or all zeros if the recording does not determine them.
+   */
+  static SimpleMotorFeedforward fit(const std::vector<Sample> &isamples, double iminVelocity);
+
+  /**
+   * @param imotor The index of the motor.
+   * @return The samples recorded for a motor.
+   */
+  const std::vector<Sample> &getSamples(std::size_t imotor) const;
+
+  /**
+   * Forgets every recorded sample.
+   */
+  void clear();
+
+  /**
+   * Sets the time between samples. The motors update every 10 ms, so sampling faster only adds
+   * repeated readings.
+   *
+   * @param isamplePeriod The time between samples.
+   */
+  void setSamplePeriod(okapi::QTime isamplePeriod);
+
+  protected:
+  std::shared_ptr<okapi::Logger> logger;
+  std::shared_ptr<Telemetry> telemetry;
+  okapi::TimeUtil timeUtil;
+  std::vector<std::shared_ptr<okapi::AbstractMotor>> motors;
+  std::vector<MotorVelocityEstimator<8>> estimators;
+  std::vector<std::vector<Sample>> samples;
+  okapi::QTime samplePeriod = 10 * okapi::millisecond;
+  double minFitVelocity = 1; // RPM
+
+  /**
+   * Drives every motor with the voltage ``ivoltage(t)`` (in volts, ``t`` in seconds) and records
+   * samples for the duration.
+   */
+  void runTest(const std::function<double(double)> &ivoltage, okapi::QTime iduration);
+
+  /**
+   * Stops the motors and waits for them to come to rest.
+   */
+  void stop();
+};
+} // namespace spooder
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+namespace spooder {
+class AbstractBattery {
+  public:
+  virtual ~AbstractBattery() = default;
+
+  /**
+   * Gets the battery's voltage.
+   *
+   * @return The voltage in millivolts, or ``PROS_ERR`` if the operation failed.
+   */
+  virtual std::int32_t getVoltage() = 0;
+
+  /**
+   * Gets the current drawn from the battery by everything on the robot.
+   *
+   * @return The current in milliamps, or ``PROS_ERR`` if the operation failed.
+   */
+  virtual std::int32_t getCurrent() = 0;
+};
+} // namespace spooder
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "okapi/api/device/button/buttonBase.hpp"
+#include "spooder/api/util/inputLog.hpp"
+
+namespace spooder {
+class InputFrameButton : public okapi::ButtonBase {
+  public:
+  /**
+   * A button read from a recorded or replayed InputFrame instead of a controller, for running
+   * driver code on a desktop.
+   *
+   * @param iframe The frame to read, such as InputReplay::getFrame(). Must outlive this button.
+   * @param ibutton The button index (okapi::ControllerDigital minus InputFrame::firstButton).
+   * @param iinverted Whether the button is inverted (``true`` meaning default pressed and
+   * ``false`` meaning default not pressed).
+   */
+  InputFrameButton(const InputFrame &iframe, std::size_t ibutton, bool iinverted = false);
+
+  protected:
+  const InputFrame &frame;
+  std::size_t button;
+
+  bool currentlyPressed() override;
+};
+} // namespace spooder
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/device/motor/abstractMotor.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/abstractRate.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "spooder/api/device/battery/abstractBattery.hpp"
+#include "spooder/api/util/telemetry.hpp"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace spooder {
+/**
+ * How a CurrentBudget shares current out. Currents are in milliamps per motor, except the budget,
+ * which is for every motor together.
+ */
+struct CurrentBudgetParams {
+  std::int32_t budget{20000};         ///< The most the motors may draw together
+  std::int32_t sagVoltage{11500};     ///< Battery millivolts below which the budget is cut
+  std::int32_t sagRecovery{300};      ///< How far above sagVoltage the budget starts to recover
+  std::int32_t cutStep{1000};         ///< How much the budget is cut each step while sagging
+  std::int32_t recoverStep{200};      ///< How much it recovers each step once the battery does
+  std::int32_t minBudgetShare{50};    ///< The cut budget never drops below this % of the budget
+  std::int32_t headroom{300};         ///< Room above a subsystem's draw to let it speed up
+  std::int32_t changeThreshold{100};  ///< Smaller changes to a limit are not sent to the motors
+};
+
+class CurrentBudget {
+  public:
+  /**
+   * Shares a total current budget between subsystems by priority, so the motors together never
+   * draw more than the battery can give without sagging. Each step reads every motor's current
+   * draw and the battery, then sets each subsystem's current limit:
+   *
+   * 1. Every subsystem gets its minimum, so none is ever starved.
+   * 2. In order of priority, each subsystem gets what it is drawing plus some headroom, or its
+   *    maximum if it is already pressed against its limit.
+   * 3. Whatever is left goes out in priority order up to each subsystem's maximum.
+   *
+   * When the budget covers everything, every subsystem runs at its maximum; priority only matters
+   * once the motors ask for more than the budget. While the battery is below the sag voltage the
+   * budget is cut a step at a time, and it recovers once the battery does.
+   *
+   * Limit changes are logged and sent to telemetry on the ``powerlimit`` channel. Each step sends
+   * the battery voltage and current, the motors' total draw, and the budget on the ``power``
+   * channel.
+   *
+   * @param ibattery The battery to watch.
+   * @param iparams How to share the current.
+   * @param itelemetry The telemetry sink steps are reported to.
+   * @param ilogger The logger this instance will log to.
+   */
+  CurrentBudget(std::shared_ptr<AbstractBattery> ibattery,
+                const CurrentBudgetParams &iparams,
+                std::shared_ptr<Telemetry> itelemetry = Telemetry::getDefaultTelemetry(),
+                std::shared_ptr<okapi::Logger> ilogger = okapi::Logger::getDefaultLogger());
+
+  CurrentBudget(const CurrentBudget &) = delete;
+
+  CurrentBudget &operator=(const CurrentBudget &) = delete;
+
+  ~CurrentBudget();
+
+  /**
+   * Adds a subsystem. All of its motors share one limit.
+   *
+   * @param iname The name it is logged with.
+   * @param imotors Its motors. Add each physical motor, not a group, so each one's draw is read.
+   * @param ipriority Its priority. Higher priorities are served first.
+   * @param iminLimit The least current each motor is given.
+   * @param imaxLimit The most current each motor is given.
+   * @return The subsystem's index.
+   */
+  std::size_t add(std::string iname,
+                  std::vector<std::shared_ptr<okapi::AbstractMotor>> imotors,
+                  int ipriority,
+                  std::int32_t iminLimit = 500,
+                  std::int32_t imaxLimit = 2500);
+
+  /**
+   * Changes a subsystem's priority, such as raising the flywheel's while shooting.
+   *
+   * @param isubsystem The subsystem's index.
+   * @param ipriority Its new priority.
+   */
+  void setPriority(std::size_t isubsystem, int ipriority);
+
+  /**
+   * Reads the motors and the battery and updates every limit.
+   */
+  void step();
+
+  /**
+   * @param isubsystem The subsystem's index.
+   * @return The current limit of each of its motors, in milliamps.
+   */
+  std::int32_t getLimit(std::size_t isubsystem) const;
+
+  /**
+   * @return The budget after any cut for battery sag, in milliamps.
+   */
+  std::int32_t getBudget() const;
+
+  /**
+   * @return The lowest battery voltage seen, in millivolts.
+   */
+  std::int32_t getMinVoltage() const;
+
+  /**
+   * Starts a thread that steps every period. This should be called once, from ``initialize()``.
+   *
+   * @param irate The rate used to wait between steps.
+   * @param iperiod The time between steps.
+   */
+  void startThread(std::unique_ptr<okapi::AbstractRate> irate,
+                   okapi::QTime iperiod = 20 * okapi::millisecond);
+
+  /**
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  protected:
+  struct Subsystem {
+    std::string name;
+    std::vector<std::shared_ptr<okapi::AbstractMotor>> motors;
+    int priority;
+    std::int32_t minLimit;
+    std::int32_t maxLimit;
+    std::int32_t limit;  // what was last sent to the motors
+    double draw{0};      // filtered draw of its hungriest motor
+  };
+
+  std::shared_ptr<AbstractBattery> battery;
+  CurrentBudgetParams params;
+  std::shared_ptr<Telemetry> telemetry;
+  std::shared_ptr<okapi::Logger> logger;
+  std::vector<Subsystem> subsystems;
+  std::int32_t budget;
+  std::int32_t minVoltage{INT32_MAX};
+  mutable CrossplatformMutex mutex;
+
+  std::unique_ptr<okapi::AbstractRate> rate;
+  okapi::QTime threadPeriod{20 * okapi::millisecond};
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  /**
+   * The weight of each new reading in the filtered draws.
+   */
+  static constexpr double drawFilterGain = 0.3;
+
+  /**
+   * Sets a subsystem's limit if it changed enough to bother the motors.
+   */
+  void apply(Subsystem &isubsystem, std::int32_t ilimit, std::int32_t ivoltage);
+
+  static void trampoline(void *context);
+
+  void loop();
+};
+} // namespace spooder
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "okapi/api/device/motor/abstractMotor.hpp"
+#include <memory>
+
+namespace spooder {
+class ForwardingMotor : public okapi::AbstractMotor {
+  public:
+  /**
+   * A motor that passes every call through to another motor. Derive from it to change a few
+   * calls, such as holding or scaling commands, without repeating the rest.
+   *
+   * @param imotor The motor to pass calls to.
+   */
+  explicit ForwardingMotor(std::shared_ptr<okapi::AbstractMotor> imotor);
+
+  std::int32_t moveAbsolute(double iposition, std::int32_t ivelocity) override;
+
+  std::int32_t moveRelative(double iposition, std::int32_t ivelocity) override;
+
+  std::int32_t moveVelocity(std::int16_t ivelocity) override;
+
+  std::int32_t moveVoltage(std::int16_t ivoltage) override;
+
+  std::int32_t modifyProfiledVelocity(std::int32_t ivelocity) override;
+
+  double getTargetPosition() override;
+
+  double getPosition() override;
+
+  std::int32_t tarePosition() override;
+
+  std::int32_t getTargetVelocity() override;
+
+  double getActualVelocity() override;
+
+  std::int32_t getCurrentDraw() override;
+
+  std::int32_t getDirection() override;
+
+  double getEfficiency() override;
+
+  std::int32_t isOverCurrent() override;
+
+  std::int32_t isOverTemp() override;
+
+  std::int32_t isStopped() override;
+
+  std::int32_t getZeroPositionFlag() override;
+
+  uint32_t getFaults() override;
+
+  uint32_t getFlags() override;
+
+  std::int32_t getRawPosition(std::uint32_t *timestamp) override;
+
+  double getPower() override;
+
+  double getTemperature() override;
+
+  double getTorque() override;
+
+  std::int32_t getVoltage() override;
+
+  std::int32_t setBrakeMode(brakeMode imode) override;
+
+  brakeMode getBrakeMode() override;
+
+  std::int32_t setCurrentLimit(std::int32_t ilimit) override;
+
+  std::int32_t getCurrentLimit() override;
+
+  std::int32_t setEncoderUnits(encoderUnits iunits) override;
+
+  encoderUnits getEncoderUnits() override;
+
+  std::int32_t setGearing(gearset igearset) override;
+
+  gearset getGearing() override;
+
+  std::int32_t setReversed(bool ireverse) override;
+
+  std::int32_t setVoltageLimit(std::int32_t ilimit) override;
+
+  std::shared_ptr<okapi::ContinuousRotarySensor> getEncoder() override;
+
+  /**
+   * Writes the value of the controller output. This method might be automatically called in
+   * another thread by the controller. The range of input values is expected to be ``[-1, 1]``.
+   *
+   * @param ivalue The controller's output in the range ``[-1, 1]``.
+   */
+  void controllerSet(double ivalue) override;
+
+  /**
+   * @return The motor calls are passed to.
+   */
+  std::shared_ptr<okapi::AbstractMotor> getMotor() const;
+
+  protected:
+  std::shared_ptr<okapi::AbstractMotor> motor;
+};
+} // namespace spooder
@@ -0,0 +1,220 @@
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/abstractRate.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "spooder/api/device/motor/forwardingMotor.hpp"
+#include "spooder/api/util/telemetry.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace spooder {
+class BatchedMotor;
+
+class MotorCommandBatch {
+  public:
+  /**
+   * Collects the move commands for a set of motors during a control period and sends them all at
+   * once at its end, so every motor's new command goes out within microseconds of the others
+   * instead of wherever the code that set it happened to run. Commands that are the same as the
+   * last one sent are skipped, except every ``iresendPeriod`` so a motor that lost power picks its
+   * command back up.
+   *
+   * Motors are added with add(), which returns a BatchedMotor to use in place of the motor. Call
+   * flush() at the end of each control period, or let the thread started by startThread() do it
+   * for code that commands the motors from its own tasks, like okapi's async controllers.
+   *
+   * Each flush sends the number of commands written and skipped and the skew, the time from the
+   * first write to the last, in microseconds, to telemetry on the ``motorbatch`` channel.
+   *
+   * @param iresendPeriod The longest an unchanged command goes without being sent again.
+   * @param itelemetry The telemetry sink flushes are reported to.
+   * @param ilogger The logger this instance will log to.
+   */
+  explicit MotorCommandBatch(
+    okapi::QTime iresendPeriod = 500 * okapi::millisecond,
+    std::shared_ptr<Telemetry> itelemetry = Telemetry::getDefaultTelemetry(),
+    std::shared_ptr<okapi::Logger> ilogger = okapi::Logger::getDefaultLogger());
+
+  MotorCommandBatch(const MotorCommandBatch &) = delete;
+
+  MotorCommandBatch &operator=(const MotorCommandBatch &) = delete;
+
+  ~MotorCommandBatch();
+
+  /**
+   * Adds a motor (or motor group) to the batch. Its move commands are held until the next flush,
+   * and everything else goes straight to the motor.
+   *
+   * @param imotor The motor.
+   * @return The motor to command instead. It must not outlive the batch.
+   */
+  std::shared_ptr<BatchedMotor> add(std::shared_ptr<okapi::AbstractMotor> imotor);
+
+  /**
+   * Sends every command set since the last flush, back to back.
+   */
+  void flush();
+
+  /**
+   * Makes the next flush send each motor's last command again, even if nothing new was set and
+   * even if it is the same as the last one. Call it when something below the batch changes what a
+   * command does, such as a MotorHealthMonitor changing a motor's derating. Relative moves are
+   * not sent again.
+   */
+  void resend();
+
+  /**
+   * @return The skew of the last flush that wrote anything, in microseconds.
+   */
+  std::uint32_t getLastSkew() const;
+
+  /**
+   * @return The largest skew of any flush, in microseconds.
+   */
+  std::uint32_t getMaxSkew() const;
+
+  /**
+   * @return The number of commands written to the motors.
+   */
+  std::size_t getWritten() const;
+
+  /**
+   * @return The number of commands skipped because they had already been sent.
+   */
+  std::size_t getSkipped() const;
+
+  /**
+   * Starts a thread that flushes every period while auto flush is on. This should be called once,
+   * from ``initialize()``.
+   *
+   * @param irate The rate used to wait between flushes.
+   * @param iperiod The time between flushes.
+   */
+  void startThread(std::unique_ptr<okapi::AbstractRate> irate,
+                   okapi::QTime iperiod = 10 * okapi::millisecond);
+
+  /**
+   * Turns the thread's flushes on or off. Turn them off while a control loop flushes at the end of
+   * its own period, so a flush from the thread does not split the loop's commands. On by default.
+   *
+   * @param ienabled Whether the thread flushes.
+   */
+  void setAutoFlush(bool ienabled);
+
+  /**
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  protected:
+  friend class BatchedMotor;
+
+  enum class CommandType { none, absolute, relative, velocity, voltage };
+
+  struct Command {
+    CommandType type{CommandType::none};
+    double position{0};
+    std::int32_t velocity{0}; // RPM for moves, millivolts for voltage
+  };
+
+  struct Slot {
+    std::shared_ptr<okapi::AbstractMotor> motor;
+    Command pending;
+    Command sent;
+    std::uint64_t sentMicros{0};
+  };
+
+  std::uint64_t resendMicros;
+  std::shared_ptr<Telemetry> telemetry;
+  std::shared_ptr<okapi::Logger> logger;
+  std::vector<Slot> slots;
+  mutable CrossplatformMutex mutex;
+  std::uint32_t lastSkew{0};
+  std::uint32_t maxSkew{0};
+  std::size_t written{0};
+  std::size_t skipped{0};
+
+  std::unique_ptr<okapi::AbstractRate> rate;
+  okapi::QTime threadPeriod{10 * okapi::millisecond};
+  std::atomic_bool autoFlush{true};
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  /**
+   * Holds a command for a motor until the next flush, replacing any command already held. Relative
+   * moves held back to back are added together, since each one moves from where the last ended.
+   */
+  void set(std::size_t islot, const Command &icommand);
+
+  /**
+   * Changes a setting that changes what the motor makes of its commands, such as its zero or its
+   * direction, and forgets the last command sent so the next one is sent even if it is the same.
+   * The change is made under the batch's lock so a flush cannot send the old command in between.
+   *
+   * @param islot The motor's slot.
+   * @param ichange Changes the setting.
+   * @return The result of the change.
+   */
+  std::int32_t reconfigure(std::size_t islot, const std::function<std::int32_t()> &ichange);
+
+  /**
+   * Sends a command to a motor.
+   *
+   * @return The motor's result, ``OKAPI_PROS_ERR`` if the write failed.
+   */
+  static std::int32_t send(okapi::AbstractMotor &imotor, const Command &icommand);
+
+  static void trampoline(void *context);
+
+  void loop();
+};
+
+class BatchedMotor : public ForwardingMotor {
+  public:
+  /**
+   * A motor whose move commands are held by a MotorCommandBatch until its next flush. Made by
+   * MotorCommandBatch::add(). Readings and settings go straight to the motor, so targets read back
+   * before a flush are the previous ones.
+   *
+   * Only the last move command before a flush is sent, except that relative moves in a row are
+   * added together. Taring, reversing, or changing the gearing or encoder units makes the next
+   * command go out even if it is the same as the last one, since the motor now reads it
+   * differently.
+   */
+  BatchedMotor(MotorCommandBatch &ibatch,
+               std::size_t islot,
+               std::shared_ptr<okapi::AbstractMotor> imotor);
+
+  std::int32_t moveAbsolute(double iposition, std::int32_t ivelocity) override;
+
+  std::int32_t moveRelative(double iposition, std::int32_t ivelocity) override;
+
+  std::int32_t moveVelocity(std::int16_t ivelocity) override;
+
+  std::int32_t moveVoltage(std::int16_t ivoltage) override;
+
+  std::int32_t tarePosition() override;
+
+  std::int32_t setEncoderUnits(encoderUnits iunits) override;
+
+  std::int32_t setGearing(gearset igearset) override;
+
+  std::int32_t setReversed(bool ireverse) override;
+
+  /**
+   * Writes the value of the controller output. This method might be automatically called in
+   * another thread by the controller. The range of input values is expected to be ``[-1, 1]``.
+   *
+   * @param ivalue The controller's output in the range ``[-1, 1]``.
+   */
+  void controllerSet(double ivalue) override;
+
+  protected:
+  MotorCommandBatch &batch;
+  std::size_t slot;
+};
+} // namespace spooder
@@ -0,0 +1,262 @@
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/device/motor/abstractMotor.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/abstractRate.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include "spooder/api/device/motor/forwardingMotor.hpp"
+#include "spooder/api/util/telemetry.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace spooder {
+class DeratedMotor;
+
+/**
+ * The thermal model and derating of a MotorHealthMonitor. Temperatures are in degrees Celsius.
+ *
+ * The defaults are a starting point for an 11 W motor. Tune heatingRate and timeConstant from the
+ * ``health`` telemetry of a motor held at stall: the estimate should track the reported
+ * temperature to within its 5 degree steps.
+ */
+struct MotorHealthParams {
+  double ambient{25};           ///< The temperature a cold motor settles to
+  double heatingRate{10};       ///< Steady rise above ambient per amp squared of draw
+  double timeConstant{120};     ///< Seconds for the motor to make 63% of a temperature change
+  double limit{55};             ///< Where the motor's firmware starts cutting its own current
+  double derateStart{45};       ///< Derating starts here and reaches minScale at the limit
+  double warningTime{20};       ///< Seconds; motors predicted to reach the limit sooner are derated
+  double minScale{0.25};        ///< The most a motor is derated to, as a share of its commands
+  double derateRate{0.5};       ///< The most the scale falls per second
+  double recoverRate{0.05};     ///< The most the scale rises per second
+};
+
+/**
+ * What a MotorHealthMonitor knows about one motor.
+ */
+struct MotorHealth {
+  double temperature{0};       ///< The reported temperature, in 5 degree steps
+  double estimate{0};          ///< The thermal model's temperature
+  std::int32_t current{0};     ///< Current draw in milliamps
+  double efficiency{0};        ///< Efficiency in percent
+  std::uint32_t faults{0};     ///< The motor's fault bits
+  bool overTemp{false};        ///< Whether the firmware reports it over temperature
+  bool overCurrent{false};     ///< Whether it is drawing over its current limit
+  double timeToLimit{0};       ///< Seconds until the limit at this draw, infinite if never
+  double scale{1};             ///< The share of its commands and current limit it is given
+};
+
+class MotorHealthMonitor {
+  public:
+  /**
+   * Watches the temperature, current, efficiency and faults of a set of motors, and derates a
+   * motor before its firmware does. V5 motors halve their own current at 55 degrees and keep
+   * halving it every 5 degrees above that, which is sudden and only reported in 5 degree steps.
+   *
+   * Each step runs a first order thermal model of every motor: the estimate moves toward
+   * ``ambient + heatingRate * amps^2`` with the time constant, and is pulled back inside the
+   * reported temperature's 5 degree step whenever it leaves it. From the estimate and the present
+   * draw the model predicts the time left until the limit. A motor's scale is lowered when its
+   * estimate passes derateStart, or when it is predicted to reach the limit within warningTime,
+   * and the scale changes at most derateRate per second down and recoverRate per second up.
+   *
+   * The scale is applied through the motors returned by add(): their voltage commands and their
+   * current limit are multiplied by it. The current limit is what holds a velocity controlled
+   * motor back, since its velocity command is left alone. A voltage command is scaled when it is
+   * sent, so a motor held by a layer that only sends changed commands, such as a
+   * MotorCommandBatch, keeps its old voltage until that layer sends again. Use setOnScaleChange()
+   * to have it send again, as with MotorCommandBatch::resend().
+   *
+   * Changes to a motor's faults and the start and end of its derating are logged. Each step sends
+   * each motor's name, reported and estimated temperature, current, efficiency, faults, time to
+   * the limit and scale to telemetry on the ``health`` channel.
+   *
+   * @param itimeUtil The time utility used to time steps.
+   * @param iparams The thermal model and derating.
+   * @param itelemetry The telemetry sink steps are reported to.
+   * @param ilogger The logger this instance will log to.
+   */
+  MotorHealthMonitor(const okapi::TimeUtil &itimeUtil,
+                     const MotorHealthParams &iparams,
+                     std::shared_ptr<Telemetry> itelemetry = Telemetry::getDefaultTelemetry(),
+                     std::shared_ptr<okapi::Logger> ilogger = okapi::Logger::getDefaultLogger());
+
+  MotorHealthMonitor(const MotorHealthMonitor &) = delete;
+
+  MotorHealthMonitor &operator=(const MotorHealthMonitor &) = delete;
+
+  ~MotorHealthMonitor();
+
+  /**
+   * Adds a motor. Add each physical motor, not a group, since each one heats on its own.
+   *
+   * @param iname The name it is logged with.
+   * @param imotor The motor.
+   * @return The motor to command instead. It must not outlive the monitor.
+   */
+  std::shared_ptr<DeratedMotor> add(std::string iname,
+                                    std::shared_ptr<okapi::AbstractMotor> imotor);
+
+  /**
+   * Sets a function called after each step that changed any motor's scale. It is called without
+   * the monitor's lock held, so it may command the motors.
+   *
+   * @param icallback The function.
+   */
+  void setOnScaleChange(std::function<void()> icallback);
+
+  /**
+   * Reads every motor and updates its model and scale.
+   */
+  void step();
+
+  /**
+   * @param imotor The motor's index, in the order it was added.
+   * @return What is known about the motor.
+   */
+  MotorHealth getHealth(std::size_t imotor) const;
+
+  /**
+   * @param imotor The motor's index, in the order it was added.
+   * @return The name it was added with.
+   */
+  std::string getName(std::size_t imotor) const;
+
+  /**
+   * @return The index of the motor with the least time to the limit, or the hottest estimate if
+   * none is heading there.
+   */
+  std::size_t getWorst() const;
+
+  /**
+   * @return Whether any motor is derated.
+   */
+  bool isDerating() const;
+
+  /**
+   * Starts a thread that steps every period. This should be called once, from ``initialize()``.
+   *
+   * @param irate The rate used to wait between steps.
+   * @param iperiod The time between steps.
+   */
+  void startThread(std::unique_ptr<okapi::AbstractRate> irate,
+                   okapi::QTime iperiod = 100 * okapi::millisecond);
+
+  /**
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  protected:
+  friend class DeratedMotor;
+
+  struct Entry {
+    std::string name;
+    std::shared_ptr<okapi::AbstractMotor> motor;
+    MotorHealth health;
+    bool seeded{false};
+    std::int32_t requestedLimit{2500}; // the current limit asked for before derating
+    std::int32_t appliedLimit{2500};   // what was last sent to the motor
+  };
+
+  std::unique_ptr<okapi::AbstractTimer> timer;
+  MotorHealthParams params;
+  std::shared_ptr<Telemetry> telemetry;
+  std::shared_ptr<okapi::Logger> logger;
+  std::vector<Entry> entries;
+  okapi::QTime lastStep{0 * okapi::millisecond};
+  bool stepped{false};
+  std::function<void()> onScaleChange;
+  mutable CrossplatformMutex mutex;
+
+  std::unique_ptr<okapi::AbstractRate> rate;
+  okapi::QTime threadPeriod{100 * okapi::millisecond};
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  /**
+   * The step of the reported temperature.
+   */
+  static constexpr double temperatureStep = 5;
+
+  /**
+   * Limit changes smaller than this are not sent to the motors.
+   */
+  static constexpr std::int32_t limitThreshold = 50;
+
+  /**
+   * Steps every motor with the lock held.
+   *
+   * @return Whether any motor's scale changed.
+   */
+  bool stepLocked();
+
+  /**
+   * Updates one motor's model and scale from a reading.
+   *
+   * @return Whether the scale changed.
+   */
+  bool update(Entry &ientry, double idt);
+
+  /**
+   * @return The seconds until the estimate reaches the limit at a draw, infinite if it never does.
+   */
+  double predictTimeToLimit(double iestimate, double iamps) const;
+
+  /**
+   * @return The scale the motor should head toward.
+   */
+  double targetScale(const MotorHealth &ihealth) const;
+
+  /**
+   * Sends a motor its derated current limit if it changed enough to bother the motor.
+   */
+  void applyLimit(Entry &ientry);
+
+  std::int16_t scaleVoltage(std::size_t imotor, std::int16_t ivoltage) const;
+
+  std::int32_t setRequestedLimit(std::size_t imotor, std::int32_t ilimit);
+
+  std::int32_t getRequestedLimit(std::size_t imotor) const;
+
+  static void trampoline(void *context);
+
+  void loop();
+};
+
+class DeratedMotor : public ForwardingMotor {
+  public:
+  /**
+   * A motor whose voltage commands and current limit are scaled down by a MotorHealthMonitor as it
+   * heats. Made by MotorHealthMonitor::add().
+   */
+  DeratedMotor(MotorHealthMonitor &imonitor,
+               std::size_t iindex,
+               std::shared_ptr<okapi::AbstractMotor> imotor);
+
+  std::int32_t moveVoltage(std::int16_t ivoltage) override;
+
+  /**
+   * Sets the current limit the motor has when it is not derated.
+   *
+   * @param ilimit The new current limit in mA.
+   * @return 1 if the operation was successful or PROS_ERR if the operation failed, setting errno.
+   */
+  std::int32_t setCurrentLimit(std::int32_t ilimit) override;
+
+  /**
+   * @return The current limit the motor has when it is not derated, in mA.
+   */
+  std::int32_t getCurrentLimit() override;
+
+  protected:
+  MotorHealthMonitor &monitor;
+  std::size_t index;
+};
+} // namespace spooder
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "okapi/api/device/motor/abstractMotor.hpp"
+#include "spooder/api/control/util/drivetrainSimulator.hpp"
+#include <memory>
+#include <vector>
+
+namespace spooder {
+class SimulatedMotor : public okapi::AbstractMotor {
+  public:
+  /**
+   * A motor, or a group of motors driven together, in a DrivetrainSimulator. Like
+   * okapi::MotorGroup, commands go to every motor and readings come from the first one. Gearing,
+   * encoder units, and reversal behave like a real motor's, so this can be handed to
+   * ChassisControllerBuilder or ChassisModel in place of real motors.
+   *
+   * @param isimulator The simulator the motors are in.
+   * @param imotors The indices of the motors in the simulator.
+   * @param ireversed Whether to reverse the motors.
+   * @param igearset The gearset the motors are told they have. Like a real motor, telling it the
+   * wrong cartridge scales its readings.
+   * @param iencoderUnits The encoder units.
+   */
+  SimulatedMotor(std::shared_ptr<DrivetrainSimulator> isimulator,
+                 std::vector<std::size_t> imotors,
+                 bool ireversed = false,
+                 gearset igearset = gearset::green,
+                 encoderUnits iencoderUnits = encoderUnits::degrees);
+
+  std::int32_t moveAbsolute(double iposition, std::int32_t ivelocity) override;
+
+  std::int32_t moveRelative(double iposition, std::int32_t ivelocity) override;
+
+  std::int32_t moveVelocity(std::int16_t ivelocity) override;
+
+  std::int32_t moveVoltage(std::int16_t ivoltage) override;
+
+  std::int32_t modifyProfiledVelocity(std::int32_t ivelocity) override;
+
+  double getTargetPosition() override;
+
+  double getPosition() override;
+
+  std::int32_t tarePosition() override;
+
+  std::int32_t getTargetVelocity() override;
+
+  double getActualVelocity() override;
+
+  std::int32_t getCurrentDraw() override;
+
+  std::int32_t getDirection() override;
+
+  double getEfficiency() override;
+
+  std::int32_t isOverCurrent() override;
+
+  std::int32_t isOverTemp() override;
+
+  std::int32_t isStopped() override;
+
+  std::int32_t getZeroPositionFlag() override;
+
+  uint32_t getFaults() override;
+
+  uint32_t getFlags() override;
+
+  std::int32_t getRawPosition(std::uint32_t *timestamp) override;
+
+  double getPower() override;
+
+  double getTemperature() override;
+
+  double getTorque() override;
+
+  std::int32_t getVoltage() override;
+
+  std::int32_t setBrakeMode(brakeMode imode) override;
+
+  brakeMode getBrakeMode() override;
+
+  std::int32_t setCurrentLimit(std::int32_t ilimit) override;
+
+  std::int32_t getCurrentLimit() override;
+
+  std::int32_t setEncoderUnits(encoderUnits iunits) override;
+
+  encoderUnits getEncoderUnits() override;
+
+  std::int32_t setGearing(gearset igearset) override;
+
+  gearset getGearing() override;
+
+  std::int32_t setReversed(bool ireverse) override;
+
+  std::int32_t setVoltageLimit(std::int32_t ilimit) override;
+
+  std::shared_ptr<okapi::ContinuousRotarySensor> getEncoder() override;
+
+  /**
+   * Writes the value of the controller output. This method might be automatically called in
+   * another thread by the controller. The range of input values is expected to be ``[-1, 1]``.
+   *
+   * @param ivalue The controller's output in the range ``[-1, 1]``.
+   */
+  void controllerSet(double ivalue) override;
+
+  protected:
+  std::shared_ptr<DrivetrainSimulator> simulator;
+  std::vector<std::size_t> motors;
+  std::vector<double> offsets; // degrees at the cartridge output, per motor
+  double reversed{1};
+  gearset gearing;
+  encoderUnits units;
+  brakeMode brake{brakeMode::coast};
+  std::int32_t currentLimit{2500};
+  double targetPosition{0};
+  std::int32_t targetVelocity{0};
+  std::int32_t voltageLimit{12000};
+  double profiledVelocity{0};
+
+  /**
+   * @return The factor from the real cartridge's output to the one the motor was told it has.
+   */
+  double gearingScale() const;
+
+  /**
+   * Converts degrees at the real cartridge output to encoder units.
+   */
+  double toUnits(double idegrees) const;
+
+  /**
+   * Converts encoder units to degrees at the real cartridge output.
+   */
+  double fromUnits(double iposition) const;
+
+  /**
+   * Sends a command to every motor.
+   */
+  void send(DrivetrainSimulator::MotorMode imode, double itarget, double imaxVelocity = 0);
+};
+} // namespace spooder
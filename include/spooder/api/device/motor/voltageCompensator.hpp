@@ -0,0 +1,97 @@
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include "spooder/api/device/battery/abstractBattery.hpp"
+#include "spooder/api/device/motor/forwardingMotor.hpp"
+#include <memory>
+
+namespace spooder {
+class CompensatedMotor;
+
+class VoltageCompensator {
+  public:
+  /**
+   * Scales voltage commands by the nominal voltage over the battery's voltage, so a command gives
+   * the same speed on a full battery as on a tired one. A command of 6000 mV on a battery sagging
+   * to 11 V is sent as 6545 mV; commands that would need more than the battery has are clipped to
+   * 12000 mV.
+   *
+   * The battery is read at most once a sample period and low pass filtered, so the compensation
+   * does not chase the battery's own sag under a step in load.
+   *
+   * Motors are wrapped with compensate(), which returns a motor whose moveVoltage() is scaled and
+   * whose other calls go straight through.
+   *
+   * @param ibattery The battery to read.
+   * @param itimeUtil The time utility used to time battery reads.
+   * @param inominalVoltage The battery voltage commands are meant for, in millivolts. A battery
+   * above this gets smaller commands.
+   * @param ifilterTime The time constant of the filter.
+   * @param isamplePeriod The time between battery reads.
+   * @param ilogger The logger this instance will log to.
+   */
+  VoltageCompensator(std::shared_ptr<AbstractBattery> ibattery,
+                     const okapi::TimeUtil &itimeUtil,
+                     std::int32_t inominalVoltage = 12000,
+                     okapi::QTime ifilterTime = 200 * okapi::millisecond,
+                     okapi::QTime isamplePeriod = 10 * okapi::millisecond,
+                     std::shared_ptr<okapi::Logger> ilogger = okapi::Logger::getDefaultLogger());
+
+  /**
+   * Wraps a motor so its voltage commands are compensated.
+   *
+   * @param imotor The motor.
+   * @return The motor to command instead. It must not outlive the compensator.
+   */
+  std::shared_ptr<CompensatedMotor> compensate(std::shared_ptr<okapi::AbstractMotor> imotor);
+
+  /**
+   * Scales a voltage command.
+   *
+   * @param ivoltage The command in millivolts.
+   * @return The command to send, in millivolts.
+   */
+  std::int16_t scale(std::int16_t ivoltage);
+
+  /**
+   * @return The filtered battery voltage in millivolts, or the nominal voltage before the battery
+   * has been read.
+   */
+  double getFilteredVoltage();
+
+  protected:
+  std::shared_ptr<AbstractBattery> battery;
+  std::unique_ptr<okapi::AbstractTimer> timer;
+  double nominalVoltage;
+  double filterTime;   // seconds
+  double samplePeriod; // seconds
+  std::shared_ptr<okapi::Logger> logger;
+  CrossplatformMutex mutex;
+  double filtered{0};
+  bool seeded{false};
+  okapi::QTime lastRead{0 * okapi::millisecond};
+
+  /**
+   * Reads the battery if a sample period has passed since the last read.
+   */
+  void update();
+};
+
+class CompensatedMotor : public ForwardingMotor {
+  public:
+  /**
+   * A motor whose voltage commands are scaled by a VoltageCompensator. Made by
+   * VoltageCompensator::compensate().
+   */
+  CompensatedMotor(VoltageCompensator &icompensator, std::shared_ptr<okapi::AbstractMotor> imotor);
+
+  std::int32_t moveVoltage(std::int16_t ivoltage) override;
+
+  protected:
+  VoltageCompensator &compensator;
+};
+} // namespace spooder
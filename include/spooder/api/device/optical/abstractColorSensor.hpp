@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+namespace spooder {
+class AbstractColorSensor {
+  public:
+  virtual ~AbstractColorSensor() = default;
+
+  /**
+   * @return The color's hue in degrees, ``[0, 360)``, or ``PROS_ERR_F`` if the sensor could not be
+   * read.
+   */
+  virtual double getHue() = 0;
+
+  /**
+   * @return The color's saturation, ``[0, 1]``, or ``PROS_ERR_F`` if the sensor could not be read.
+   */
+  virtual double getSaturation() = 0;
+
+  /**
+   * @return How close the object in front of the sensor is, 0 for nothing to 255 for touching, or
+   * ``PROS_ERR`` if the sensor could not be read.
+   */
+  virtual std::int32_t getProximity() = 0;
+};
+} // namespace spooder
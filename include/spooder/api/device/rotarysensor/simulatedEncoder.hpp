@@ -0,0 +1,50 @@
+#pragma once
+
+#include "okapi/api/device/rotarysensor/continuousRotarySensor.hpp"
+#include "spooder/api/control/util/drivetrainSimulator.hpp"
+#include <memory>
+
+namespace spooder {
+class SimulatedEncoder : public okapi::ContinuousRotarySensor {
+  public:
+  /**
+   * The integrated encoder of a motor in a DrivetrainSimulator. Reads degrees at the cartridge
+   * output, like okapi::IntegratedEncoder.
+   *
+   * @param isimulator The simulator the motor is in.
+   * @param imotor The index of the motor in the simulator.
+   * @param ireversed Whether the encoder is reversed.
+   */
+  SimulatedEncoder(std::shared_ptr<DrivetrainSimulator> isimulator,
+                   std::size_t imotor,
+                   bool ireversed = false);
+
+  /**
+   * Get the current sensor value.
+   *
+   * @return the current sensor value.
+   */
+  double get() const override;
+
+  /**
+   * Reset the sensor to zero.
+   *
+   * @return `1` on success.
+   */
+  std::int32_t reset() override;
+
+  /**
+   * Get the sensor value for use in a control loop. This method might be automatically called in
+   * another thread by the controller.
+   *
+   * @return the current sensor value.
+   */
+  double controllerGet() override;
+
+  protected:
+  std::shared_ptr<DrivetrainSimulator> simulator;
+  std::size_t motor;
+  double reversed{1};
+  double offset{0};
+};
+} // namespace spooder
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+namespace spooder {
+/**
+ * An object a camera sees. Coordinates are in pixels from the center of the image, with x to the
+ * right and y down.
+ */
+struct GoalDetection {
+  double x{0};      ///< The center of the object
+  double y{0};      ///< The center of the object
+  double width{0};  ///< The width of its bounding box
+  double height{0}; ///< The height of its bounding box
+};
+
+class AbstractGoalCamera {
+  public:
+  virtual ~AbstractGoalCamera() = default;
+
+  /**
+   * Reads the objects in the camera's latest frame that look like the goal, largest first.
+   *
+   * @param odetections Where to write the objects.
+   * @param imax The most objects to read.
+   * @return The number of objects read, 0 if there are none or the camera could not be read.
+   */
+  virtual std::size_t getGoals(GoalDetection *odetections, std::size_t imax) = 0;
+};
+} // namespace spooder
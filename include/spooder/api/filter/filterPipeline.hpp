@@ -0,0 +1,90 @@
+#pragma once
+
+#include "okapi/api/filter/filter.hpp"
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+namespace spooder {
+/**
+ * A filter made of other filters, like okapi::ComposableFilter, except that the stages are fixed
+ * at compile time and stored by value. The input signal is passed through each stage in sequence
+ * and the output of this filter is the output of the last stage.
+ *
+ * Stages are called directly instead of through a virtual call on a shared pointer, so stages
+ * defined in headers (such as okapi::MedianFilter, okapi::AverageFilter and
+ * RunningMedianFilter) are inlined into one function. The pipeline itself is an okapi::Filter, so
+ * it can be handed to anything that takes one, such as okapi::VelMath.
+ *
+ * ```cpp
+ * FilterPipeline<MedianFilter<5>, EmaFilter> filter(MedianFilter<5>(), EmaFilter(0.2));
+ * ```
+ *
+ * A stage can be any type with a ``double filter(double)`` member function.
+ *
+ * @tparam Stages The stage types, in the order the signal passes through them.
+ */
+template <typename... Stages> class FilterPipeline : public okapi::Filter {
+  static_assert(sizeof...(Stages) > 0, "FilterPipeline needs at least one stage");
+
+  public:
+  /**
+   * Makes a pipeline with default constructed stages.
+   */
+  FilterPipeline() = default;
+
+  /**
+   * Makes a pipeline from copies of the given stages.
+   *
+   * @param istages The stages, in the order the signal passes through them.
+   */
+  explicit FilterPipeline(Stages... istages) : stages(std::move(istages)...) {
+  }
+
+  /**
+   * Filters a value.
+   *
+   * @param ireading A new measurement.
+   * @return The filtered result.
+   */
+  double filter(const double ireading) override {
+    output = filterAll(ireading, std::index_sequence_for<Stages...>{});
+    return output;
+  }
+
+  /**
+   * @return The previous output from filter.
+   */
+  double getOutput() const override {
+    return output;
+  }
+
+  /**
+   * Returns a stage, for example to change its gains.
+   *
+   * @tparam I The index of the stage.
+   * @return The stage.
+   */
+  template <std::size_t I> auto &getStage() {
+    return std::get<I>(stages);
+  }
+
+  protected:
+  std::tuple<Stages...> stages;
+  double output = 0;
+
+  template <std::size_t... I>
+  double filterAll(double ireading, std::index_sequence<I...>) {
+    ((ireading = filterStage(std::get<I>(stages), ireading)), ...);
+    return ireading;
+  }
+
+  /**
+   * Calls a stage's filter without virtual dispatch. The qualified call names the exact stage type,
+   * which is known here, so the compiler can call (or inline) it directly.
+   */
+  template <typename Stage> static double filterStage(Stage &istage, const double ireading) {
+    return istage.Stage::filter(ireading);
+  }
+};
+} // namespace spooder
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "spooder/api/util/matrix.hpp"
+#include <cstddef>
+
+namespace spooder {
+/**
+ * A multi-state (extended) Kalman filter with the state and measurement sizes fixed at compile
+ * time. Where okapi::EKFFilter tracks a single value, this can track e.g. a flywheel's speed and
+ * acceleration together, or fuse several sensors into a pose. All matrices live inside the filter,
+ * so predict and update never allocate.
+ *
+ * For a linear system, set the model matrices once and call predict() and update(). For a
+ * nonlinear system (EKF), evaluate the model yourself each step and pass the predicted state or
+ * measurement along with its Jacobian to the overloads that take them.
+ *
+ * For example, a flywheel's speed and acceleration from a speed measurement every 10 ms:
+ *
+ * ```cpp
+ * KalmanFilter<2, 1> kf(kinematicModel<2>(0.01), {1, 0}, {0.01, 0, 0, 10}, {25});
+ * kf.predict();
+ * kf.update({measuredRpm});
+ * double rpm = kf.getState()[0];
+ * ```
+ *
+ * @tparam N The number of states.
+ * @tparam M The number of measurements.
+ */
+template <std::size_t N, std::size_t M> class KalmanFilter {
+  public:
+  /**
+   * @param iF The state transition matrix.
+   * @param iH The measurement matrix, mapping the state to the expected measurement.
+   * @param iQ The process noise covariance. Think of it as how much the model is trusted; larger
+   * values follow the measurements more closely.
+   * @param iR The measurement noise covariance. Think of it as how noisy the sensor is.
+   * @param ix0 The initial state.
+   * @param iP0 The initial state covariance. Large values make the first measurements count more.
+   */
+  KalmanFilter(const Matrix<N, N> &iF,
+               const Matrix<M, N> &iH,
+               const Matrix<N, N> &iQ,
+               const Matrix<M, M> &iR,
+               const Vector<N> &ix0 = Vector<N>(),
+               const Matrix<N, N> &iP0 = Matrix<N, N>::identity())
+    : F(iF), H(iH), Q(iQ), R(iR), x(ix0), P(iP0) {
+  }
+
+  /**
+   * Predicts the next state with the linear model, ``x = F x``.
+   */
+  void predict() {
+    x = F * x;
+    P = F * P * F.transpose() + Q;
+  }
+
+  /**
+   * Predicts the next state with a control input, ``x = F x + B u``.
+   *
+   * @param iB The control input matrix.
+   * @param iu The control input, for example the applied voltage.
+   */
+  template <std::size_t U> void predict(const Matrix<N, U> &iB, const Vector<U> &iu) {
+    x = F * x + iB * iu;
+    P = F * P * F.transpose() + Q;
+  }
+
+  /**
+   * Predicts the next state with a nonlinear model (EKF).
+   *
+   * @param ixPredicted The model evaluated at the current state, ``f(x, u)``.
+   * @param iF The Jacobian of the model at the current state.
+   */
+  void predict(const Vector<N> &ixPredicted, const Matrix<N, N> &iF) {
+    x = ixPredicted;
+    P = iF * P * iF.transpose() + Q;
+  }
+
+  /**
+   * Corrects the state with a measurement using the linear measurement model.
+   *
+   * @param iz The measurement.
+   * @return false if the innovation covariance was singular and the measurement was skipped.
+   */
+  bool update(const Vector<M> &iz) {
+    return update(iz, H * x, H);
+  }
+
+  /**
+   * Corrects the state with a measurement using a nonlinear measurement model (EKF).
+   *
+   * @param iz The measurement.
+   * @param ihx The measurement model evaluated at the current state, ``h(x)``.
+   * @param iH The Jacobian of the measurement model at the current state.
+   * @return false if the innovation covariance was singular and the measurement was skipped.
+   */
+  bool update(const Vector<M> &iz, const Vector<M> &ihx, const Matrix<M, N> &iH) {
+    const Matrix<N, M> PHt = P * iH.transpose();
+    const Matrix<M, M> S = iH * PHt + R;
+
+    // K = P H' S^-1, found by solving S K' = H P' (S and P are symmetric)
+    Matrix<M, N> Kt;
+    if (!S.solve(PHt.transpose(), Kt)) {
+      return false;
+    }
+    const Matrix<N, M> K = Kt.transpose();
+
+    x += K * (iz - ihx);
+
+    // Joseph form, which keeps P symmetric and positive definite despite rounding
+    const Matrix<N, N> IKH = Matrix<N, N>::identity() - K * iH;
+    P = IKH * P * IKH.transpose() + K * R * Kt;
+    return true;
+  }
+
+  /**
+   * @return The current state estimate.
+   */
+  const Vector<N> &getState() const {
+    return x;
+  }
+
+  /**
+   * @return The current state covariance.
+   */
+  const Matrix<N, N> &getCovariance() const {
+    return P;
+  }
+
+  /**
+   * Overwrites the state estimate and its covariance, for example after a known reset.
+   *
+   * @param ix The new state.
+   * @param iP The new state covariance.
+   */
+  void reset(const Vector<N> &ix, const Matrix<N, N> &iP = Matrix<N, N>::identity()) {
+    x = ix;
+    P = iP;
+  }
+
+  /**
+   * Sets the state transition matrix, for example when the time step changes.
+   *
+   * @param iF The state transition matrix.
+   */
+  void setTransition(const Matrix<N, N> &iF) {
+    F = iF;
+  }
+
+  /**
+   * Sets the noise covariances.
+   *
+   * @param iQ The process noise covariance.
+   * @param iR The measurement noise covariance.
+   */
+  void setNoise(const Matrix<N, N> &iQ, const Matrix<M, M> &iR) {
+    Q = iQ;
+    R = iR;
+  }
+
+  protected:
+  Matrix<N, N> F;
+  Matrix<M, N> H;
+  Matrix<N, N> Q;
+  Matrix<M, M> R;
+  Vector<N> x;
+  Matrix<N, N> P;
+};
+
+/**
+ * The state transition matrix for a chain of derivatives (position, velocity, acceleration, ...)
+ * with each state integrating the ones after it over a time step. ``kinematicModel<2>`` is a
+ * constant velocity model and ``kinematicModel<3>`` is a constant acceleration model.
+ *
+ * @tparam N The number of states.
+ * @param idt The time step.
+ * @return The state transition matrix.
+ */
+template <std::size_t N> Matrix<N, N> kinematicModel(const double idt) {
+  Matrix<N, N> F = Matrix<N, N>::identity();
+  for (std::size_t r = 0; r < N; r++) {
+    double term = 1;
+    for (std::size_t c = r + 1; c < N; c++) {
+      term *= idt / static_cast<double>(c - r);
+      F(r, c) = term;
+    }
+  }
+  return F;
+}
+} // namespace spooder
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "okapi/api/control/controllerInput.hpp"
+#include "okapi/api/device/motor/abstractMotor.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include "spooder/api/filter/timestampedVelMath.hpp"
+#include <memory>
+
+namespace spooder {
+/**
+ * Estimates a motor's velocity and acceleration from its raw encoder position and the timestamp
+ * the motor reports with it, using TimestampedVelMath. This is cleaner and lower latency than
+ * okapi::AbstractMotor::getActualVelocity, which is the motor's own coarse estimate.
+ *
+ * As a ``ControllerInput<double>`` it can be used as the feedback for okapi's velocity
+ * controllers, and returns RPM at the output of any external gear ratio.
+ *
+ * @tparam n The number of samples in the fit window.
+ */
+template <std::size_t n = 8> class MotorVelocityEstimator : public okapi::ControllerInput<double> {
+  public:
+  /**
+   * @param imotor The motor to read. For a motor group, the first motor is read.
+   * @param iratio Any external gear ratio (output / motor).
+   */
+  explicit MotorVelocityEstimator(std::shared_ptr<okapi::AbstractMotor> imotor,
+                                  const double iratio = 1)
+    : motor(std::move(imotor)), ratio(iratio) {
+  }
+
+  /**
+   * Reads the motor and updates the estimate. Reading faster than the motor updates (every 10 ms)
+   * is harmless; repeated readings are ignored.
+   *
+   * @return The new velocity estimate in RPM, or the previous estimate if the motor could not be
+   * read.
+   */
+  okapi::QAngularSpeed step() {
+    // The gearset is usually set in initialize(), after this was constructed, so check it here
+    const auto gearset = motor->getGearing();
+    if (gearset != lastGearset && gearset != okapi::AbstractMotor::gearset::invalid) {
+      lastGearset = gearset;
+      velMath.setTicksPerRev(okapi::gearsetToTPR(gearset) / ratio);
+    }
+
+    std::uint32_t timestamp = 0;
+    const std::int32_t position = motor->getRawPosition(&timestamp);
+    if (position == okapi::OKAPI_PROS_ERR ||
+        lastGearset == okapi::AbstractMotor::gearset::invalid) {
+      return velMath.getVelocity();
+    }
+
+    return velMath.step(position, timestamp * okapi::millisecond);
+  }
+
+  /**
+   * Get the sensor value for use in a control loop.
+   *
+   * @return The current velocity in RPM.
+   */
+  double controllerGet() override {
+    return step().convert(okapi::rpm);
+  }
+
+  /**
+   * @return The last calculated velocity.
+   */
+  okapi::QAngularSpeed getVelocity() const {
+    return velMath.getVelocity();
+  }
+
+  /**
+   * @return The last calculated acceleration.
+   */
+  okapi::QAngularAcceleration getAccel() const {
+    return velMath.getAccel();
+  }
+
+  protected:
+  std::shared_ptr<okapi::AbstractMotor> motor;
+  double ratio;
+  okapi::AbstractMotor::gearset lastGearset{okapi::AbstractMotor::gearset::invalid};
+  TimestampedVelMath<n> velMath{1};
+};
+} // namespace spooder
@@ -0,0 +1,188 @@
+/*
+ * Based on the double heap "mediator" running median algorithm by AShelly.
+ */
+#pragma once
+
+#include "okapi/api/filter/filter.hpp"
+#include <array>
+#include <cstddef>
+
+namespace spooder {
+/**
+ * A filter which returns the median value of list of values. Returns the same results as
+ * okapi::MedianFilter, but keeps the window partially sorted between readings so each reading
+ * costs O(log n) instead of an O(n) copy and quickselect. Use this one for windows larger than a
+ * handful of taps.
+ *
+ * The window is a max heap of the lower half and a min heap of the upper half that meet at the
+ * median. Each reading overwrites the oldest value in place and sifts it to its new position.
+ *
+ * @tparam n number of taps in the filter
+ */
+template <std::size_t n> class RunningMedianFilter : public okapi::Filter {
+  static_assert(n > 0, "RunningMedianFilter needs at least one tap");
+
+  public:
+  RunningMedianFilter() {
+    // The window starts full of zeros, like okapi::MedianFilter. Any placement is a valid heap.
+    for (std::size_t i = 0; i < n; i++) {
+      pos[i] = static_cast<int>((i + 1) / 2) * ((i & 1) ? -1 : 1);
+      heap(pos[i]) = i;
+    }
+  }
+
+  /**
+   * Filters a value, like a sensor reading.
+   *
+   * @param ireading new measurement
+   * @return filtered result
+   */
+  double filter(const double ireading) override {
+    const int p = pos[index];
+    const double old = data[index];
+    data[index++] = ireading;
+    if (index >= n) {
+      index = 0;
+    }
+
+    if (p > 0) {
+      // The new value replaced one in the upper half
+      if (old < ireading) {
+        minSortDown(p);
+      } else if (minSortUp(p)) {
+        maxSortDown(0);
+      }
+    } else if (p < 0) {
+      // The new value replaced one in the lower half
+      if (ireading < old) {
+        maxSortDown(p);
+      } else if (maxSortUp(p)) {
+        minSortDown(0);
+      }
+    } else {
+      // The new value replaced the median
+      maxSortDown(0);
+      minSortDown(0);
+    }
+
+    // For an even window okapi::MedianFilter returns the lower of the two middle values, which is
+    // the top of the lower half
+    output = (n & 1) ? data[heap(0)] : data[heap(-1)];
+    return output;
+  }
+
+  /**
+   * Returns the previous output from filter.
+   *
+   * @return the previous output from filter
+   */
+  double getOutput() const override {
+    return output;
+  }
+
+  protected:
+  static constexpr int minCount = static_cast<int>((n - 1) / 2);
+  static constexpr int maxCount = static_cast<int>(n / 2);
+
+  std::array<double, n> data{0};
+
+  // Heap position of each value in data. Positive positions are in the min heap, negative positions
+  // are in the max heap, and position 0 is the median.
+  std::array<int, n> pos{};
+
+  // Index into data of the value at each heap position, offset so position 0 is in the middle
+  std::array<std::size_t, n> heapStorage{};
+
+  std::size_t index = 0;
+  double output = 0;
+
+  std::size_t &heap(const int ipos) {
+    return heapStorage[static_cast<std::size_t>(ipos + maxCount)];
+  }
+
+  bool less(const int i, const int j) {
+    return data[heap(i)] < data[heap(j)];
+  }
+
+  void exchange(const int i, const int j) {
+    const std::size_t t = heap(i);
+    heap(i) = heap(j);
+    heap(j) = t;
+    pos[heap(i)] = i;
+    pos[heap(j)] = j;
+  }
+
+  /**
+   * Swaps the values at two heap positions if the first is less than the second.
+   *
+   * @return whether the values were swapped
+   */
+  bool compareExchange(const int i, const int j) {
+    if (less(i, j)) {
+      exchange(i, j);
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * Moves the value at a position in the min heap (or the median) down until the min heap is
+   * valid. The median has a single child in each heap, all other positions have two.
+   */
+  void minSortDown(int i) {
+    while (true) {
+      int child = (i == 0) ? 1 : 2 * i;
+      if (child > minCount) {
+        break;
+      }
+      if (i != 0 && child < minCount && less(child + 1, child)) {
+        ++child;
+      }
+      if (!compareExchange(child, i)) {
+        break;
+      }
+      i = child;
+    }
+  }
+
+  /**
+   * Moves the value at a position in the max heap (or the median) down until the max heap is
+   * valid.
+   */
+  void maxSortDown(int i) {
+    while (true) {
+      int child = (i == 0) ? -1 : 2 * i;
+      if (child < -maxCount) {
+        break;
+      }
+      if (i != 0 && child > -maxCount && less(child, child - 1)) {
+        --child;
+      }
+      if (!compareExchange(i, child)) {
+        break;
+      }
+      i = child;
+    }
+  }
+
+  /**
+   * @return whether the value moved all the way up to the median
+   */
+  bool minSortUp(int i) {
+    while (i > 0 && compareExchange(i, i / 2)) {
+      i /= 2;
+    }
+    return i == 0;
+  }
+
+  /**
+   * @return whether the value moved all the way up to the median
+   */
+  bool maxSortUp(int i) {
+    while (i < 0 && compareExchange(i / 2, i)) {
+      i /= 2;
+    }
+    return i == 0;
+  }
+};
+} // namespace spooder
@@ -0,0 +1,176 @@
+#pragma once
+
+#include "okapi/api/units/QAngle.hpp"
+#include "okapi/api/units/QAngularAcceleration.hpp"
+#include "okapi/api/units/QAngularSpeed.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+
+namespace spooder {
+/**
+ * Velocity math helper for timestamped position samples, such as the raw motor positions from
+ * okapi::AbstractMotor::getRawPosition. Where okapi::VelMath differentiates the last two positions
+ * using the time between calls, this fits a polynomial to the last ``n`` samples against the time
+ * each one was actually measured (a Savitzky-Golay style least squares fit on non-uniform spacing)
+ * and differentiates the fit at the newest sample. This gives velocity and acceleration that are
+ * both smoother and less delayed than a filter on finite differences.
+ *
+ * A sample with the same timestamp as the previous one is a repeated reading of a sensor which has
+ * not updated yet, so it is ignored instead of being counted as zero motion.
+ *
+ * @tparam n The number of samples in the fit window. The V5 motor updates its position every
+ * 10 ms, so 8 samples covers 70 ms.
+ */
+template <std::size_t n> class TimestampedVelMath {
+  static_assert(n >= 2, "TimestampedVelMath needs at least two samples");
+
+  public:
+  /**
+   * Throws a ``std::invalid_argument`` exception if ``iticksPerRev`` is zero.
+   *
+   * @param iticksPerRev The number of ticks per revolution (or whatever units you are using).
+   */
+  explicit TimestampedVelMath(const double iticksPerRev) {
+    setTicksPerRev(iticksPerRev);
+  }
+
+  /**
+   * Adds a position sample and recalculates the velocity and acceleration. Windows of four or more
+   * samples are fit with a quadratic, which also gives acceleration; smaller windows (and the
+   * first few samples) are fit with a line.
+   *
+   * @param iposition The position measurement.
+   * @param itimestamp The time the position was measured.
+   * @return The new velocity estimate.
+   */
+  okapi::QAngularSpeed step(const double iposition, const okapi::QTime itimestamp) {
+    const double time = itimestamp.convert(okapi::second);
+    if (count > 0 && time == times[newest()]) {
+      return vel;
+    }
+
+    index = (index + 1) % n;
+    times[index] = time;
+    positions[index] = iposition / ticksPerRev;
+    if (count < n) {
+      count++;
+    }
+
+    fit();
+    return vel;
+  }
+
+  /**
+   * Sets ticks per revolution (or whatever units you are using). Throws a ``std::invalid_argument``
+   * exception if iticksPerRev is zero. Clears the window, since old samples are in the old units.
+   *
+   * @param iticksPerRev The number of ticks per revolution.
+   */
+  void setTicksPerRev(const double iticksPerRev) {
+    if (iticksPerRev == 0) {
+      throw std::invalid_argument("TimestampedVelMath: The ticks per revolution cannot be zero.");
+    }
+
+    ticksPerRev = iticksPerRev;
+    reset();
+  }
+
+  /**
+   * Forgets every sample and zeroes the estimates.
+   */
+  void reset() {
+    count = 0;
+    vel = 0 * okapi::rpm;
+    accel = 0 * okapi::rpm / okapi::second;
+  }
+
+  /**
+   * @return The last calculated velocity.
+   */
+  okapi::QAngularSpeed getVelocity() const {
+    return vel;
+  }
+
+  /**
+   * @return The last calculated acceleration.
+   */
+  okapi::QAngularAcceleration getAccel() const {
+    return accel;
+  }
+
+  protected:
+  std::array<double, n> times{};     // seconds
+  std::array<double, n> positions{}; // revolutions
+  std::size_t index = n - 1;
+  std::size_t count = 0;
+  double ticksPerRev = 1;
+  okapi::QAngularSpeed vel{0.0};
+  okapi::QAngularAcceleration accel{0.0};
+
+  std::size_t newest() const {
+    return index;
+  }
+
+  /**
+   * Fits position against time, with both measured relative to the newest sample so the sums stay
+   * well conditioned, and reads the slope and curvature at the newest sample.
+   */
+  void fit() {
+    if (count < 2) {
+      return;
+    }
+
+    // Sums of t^k and p * t^k over the window
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0, s4 = 0;
+    double p0 = 0, p1 = 0, p2 = 0;
+    for (std::size_t i = 0; i < count; i++) {
+      const std::size_t j = (index + n - i) % n;
+      const double t = times[j] - times[index];
+      const double p = positions[j] - positions[index];
+      const double t2 = t * t;
+      s0 += 1;
+      s1 += t;
+      s2 += t2;
+      s3 += t2 * t;
+      s4 += t2 * t2;
+      p0 += p;
+      p1 += p * t;
+      p2 += p * t2;
+    }
+
+    double slope = 0; // rev/s
+    double curve = 0; // rev/s^2
+
+    if (count >= 4) {
+      // Quadratic p = a + b t + c t^2 by Cramer's rule on the normal equations
+      const double det = s0 * (s2 * s4 - s3 * s3) - s1 * (s1 * s4 - s3 * s2) +
+                         s2 * (s1 * s3 - s2 * s2);
+      if (std::abs(det) > 1e-18) {
+        const double detB = s0 * (p1 * s4 - s3 * p2) - p0 * (s1 * s4 - s3 * s2) +
+                            s2 * (s1 * p2 - p1 * s2);
+        const double detC = s0 * (s2 * p2 - p1 * s3) - s1 * (s1 * p2 - p1 * s2) +
+                            p0 * (s1 * s3 - s2 * s2);
+        slope = detB / det;
+        curve = 2 * detC / det;
+        store(slope, curve);
+        return;
+      }
+    }
+
+    // Straight line p = a + b t
+    const double det = s0 * s2 - s1 * s1;
+    if (std::abs(det) > 1e-12) {
+      slope = (s0 * p1 - s1 * p0) / det;
+    }
+    store(slope, curve);
+  }
+
+  void store(const double irevPerSec, const double irevPerSec2) {
+    vel = irevPerSec * 60 * okapi::rpm;
+    accel = irevPerSec2 * 60 * okapi::rpm / okapi::second;
+  }
+};
+} // namespace spooder
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "okapi/api/units/QTime.hpp"
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace spooder {
+/**
+ * Everything read from a controller in one tick. Analog channels are indexed like
+ * okapi::ControllerAnalog and buttons like okapi::ControllerDigital minus ``firstButton``.
+ */
+struct InputFrame {
+  static constexpr std::size_t analogChannels = 4;
+  static constexpr std::size_t buttons = 12;
+  static constexpr std::size_t firstButton = 6; ///< okapi::ControllerDigital::L1
+
+  std::array<std::int8_t, analogChannels> analog{}; ///< raw joystick values, [-127, 127]
+  std::uint16_t digital{0};                         ///< one bit per button
+
+  /**
+   * @param ichannel The analog channel.
+   * @return The channel scaled to ``[-1, 1]``, like okapi::Controller::getAnalog.
+   */
+  float getAnalog(std::size_t ichannel) const;
+
+  /**
+   * @param ibutton The button index.
+   * @return Whether the button is pressed.
+   */
+  bool getDigital(std::size_t ibutton) const;
+
+  /**
+   * @param ibutton The button index.
+   * @param ipressed Whether the button is pressed.
+   */
+  void setDigital(std::size_t ibutton, bool ipressed);
+
+  bool operator==(const InputFrame &other) const;
+};
+
+/**
+ * A recorded driver session: the controller inputs of every tick in order.
+ *
+ * The file format is an 8 byte header (``SPIL``, a version byte, a reserved byte, and the tick
+ * period in ms as a little endian ``uint16``) followed by 6 bytes per tick (the four analog
+ * channels as ``int8`` and the buttons as a little endian ``uint16``). A two minute match at 50 Hz
+ * is 36 kB.
+ */
+struct InputLog {
+  static constexpr std::size_t headerSize = 8;
+  static constexpr std::size_t frameSize = 6;
+
+  okapi::QTime tickPeriod{20 * okapi::millisecond};
+  std::vector<InputFrame> frames;
+
+  /**
+   * Reads a log.
+   *
+   * @param ifile The file to read from, positioned at the start of the log.
+   * @param olog The log that was read.
+   * @return Whether the file held a log. A partly written last frame is ignored.
+   */
+  static bool read(FILE *ifile, InputLog &olog);
+
+  /**
+   * Reads a log from a path.
+   *
+   * @param ipath The path, such as ``/usd/replay.bin`` on the robot.
+   * @return The log, or nullptr if it could not be read.
+   */
+  static std::shared_ptr<InputLog> load(const char *ipath);
+};
+
+class InputRecorder {
+  public:
+  /**
+   * Writes controller inputs to a log file, one frame per tick. The file is flushed every
+   * ``iflushFrames`` frames, so a session cut short by the robot being disabled loses at most
+   * that many frames. If the file cannot be opened (for example, no SD card), frames are dropped.
+   *
+   * @param ipath The path to write to. It is overwritten, so use unusedPath() to keep earlier
+   * sessions.
+   * @param itickPeriod The time between frames.
+   * @param iflushFrames The number of frames between flushes.
+   */
+  explicit InputRecorder(const char *ipath,
+                         okapi::QTime itickPeriod = 20 * okapi::millisecond,
+                         std::size_t iflushFrames = 50);
+
+  ~InputRecorder();
+
+  InputRecorder(const InputRecorder &) = delete;
+  InputRecorder &operator=(const InputRecorder &) = delete;
+
+  /**
+   * Finds a path for a new log that does not overwrite an earlier one.
+   *
+   * @param ipattern A printf pattern with one ``%u`` for a number, such as
+   * ``/usd/inputs%03u.bin``.
+   * @param imax The number of paths to try, numbered from 0.
+   * @return The first of the paths with no file at it, or an empty path if they are all taken.
+   */
+  static std::string unusedPath(const char *ipattern, unsigned imax = 1000);
+
+  /**
+   * @return Whether frames are being written anywhere.
+   */
+  bool isEnabled() const;
+
+  /**
+   * Appends one tick's inputs.
+   *
+   * @param iframe The inputs.
+   */
+  void record(const InputFrame &iframe);
+
+  /**
+   * @return The number of frames recorded.
+   */
+  std::size_t getFrameCount() const;
+
+  protected:
+  FILE *file;
+  std::size_t flushFrames;
+  std::size_t frameCount{0};
+};
+
+class InputReplay {
+  public:
+  /**
+   * Plays back a recorded session one tick at a time. Past the end of the log, every input reads
+   * as released and centered.
+   *
+   * @param ilog The session to play back.
+   */
+  explicit InputReplay(std::shared_ptr<const InputLog> ilog);
+
+  /**
+   * Moves to the next tick's inputs. Call once per tick, before reading any inputs.
+   *
+   * @return Whether there was a next tick, false once the log has ended.
+   */
+  bool step();
+
+  /**
+   * @return The current tick's inputs.
+   */
+  const InputFrame &getFrame() const;
+
+  /**
+   * @return Whether the whole log has been played.
+   */
+  bool isFinished() const;
+
+  /**
+   * @return The number of ticks played so far.
+   */
+  std::size_t getTick() const;
+
+  /**
+   * @return The log being played.
+   */
+  const InputLog &getLog() const;
+
+  protected:
+  std::shared_ptr<const InputLog> log;
+  std::size_t tick{0};
+  InputFrame frame{};
+};
+} // namespace spooder
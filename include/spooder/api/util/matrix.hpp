@@ -0,0 +1,204 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+
+namespace spooder {
+/**
+ * A small dense matrix with its size fixed at compile time, stored by value in row-major order.
+ * Nothing here allocates, so matrices can be used freely inside control loops. This is only meant
+ * for the handful-of-states math in filters and models, not as a general linear algebra library.
+ *
+ * @tparam R The number of rows.
+ * @tparam C The number of columns.
+ */
+template <std::size_t R, std::size_t C> class Matrix {
+  static_assert(R > 0 && C > 0, "Matrix dimensions must be positive");
+
+  public:
+  /**
+   * A matrix of zeros.
+   */
+  constexpr Matrix() = default;
+
+  /**
+   * A matrix from its elements in row-major order. Missing elements are zero.
+   *
+   * @param ielements The elements, row by row.
+   */
+  constexpr Matrix(std::initializer_list<double> ielements) {
+    std::size_t i = 0;
+    for (const double element : ielements) {
+      if (i >= R * C) {
+        break;
+      }
+      data[i++] = element;
+    }
+  }
+
+  /**
+   * @return The identity matrix.
+   */
+  static constexpr Matrix identity() {
+    static_assert(R == C, "Only square matrices have an identity");
+    Matrix out;
+    for (std::size_t i = 0; i < R; i++) {
+      out(i, i) = 1;
+    }
+    return out;
+  }
+
+  constexpr double &operator()(const std::size_t irow, const std::size_t icol) {
+    return data[irow * C + icol];
+  }
+
+  constexpr double operator()(const std::size_t irow, const std::size_t icol) const {
+    return data[irow * C + icol];
+  }
+
+  /**
+   * Element access for column vectors.
+   */
+  constexpr double &operator[](const std::size_t i) {
+    static_assert(C == 1, "Single index access is only for column vectors");
+    return data[i];
+  }
+
+  constexpr double operator[](const std::size_t i) const {
+    static_assert(C == 1, "Single index access is only for column vectors");
+    return data[i];
+  }
+
+  constexpr Matrix<C, R> transpose() const {
+    Matrix<C, R> out;
+    for (std::size_t r = 0; r < R; r++) {
+      for (std::size_t c = 0; c < C; c++) {
+        out(c, r) = (*this)(r, c);
+      }
+    }
+    return out;
+  }
+
+  constexpr Matrix &operator+=(const Matrix &rhs) {
+    for (std::size_t i = 0; i < R * C; i++) {
+      data[i] += rhs.data[i];
+    }
+    return *this;
+  }
+
+  constexpr Matrix &operator-=(const Matrix &rhs) {
+    for (std::size_t i = 0; i < R * C; i++) {
+      data[i] -= rhs.data[i];
+    }
+    return *this;
+  }
+
+  constexpr Matrix &operator*=(const double rhs) {
+    for (double &element : data) {
+      element *= rhs;
+    }
+    return *this;
+  }
+
+  constexpr Matrix operator+(const Matrix &rhs) const {
+    Matrix out(*this);
+    out += rhs;
+    return out;
+  }
+
+  constexpr Matrix operator-(const Matrix &rhs) const {
+    Matrix out(*this);
+    out -= rhs;
+    return out;
+  }
+
+  constexpr Matrix operator*(const double rhs) const {
+    Matrix out(*this);
+    out *= rhs;
+    return out;
+  }
+
+  template <std::size_t K> constexpr Matrix<R, K> operator*(const Matrix<C, K> &rhs) const {
+    Matrix<R, K> out;
+    for (std::size_t r = 0; r < R; r++) {
+      for (std::size_t i = 0; i < C; i++) {
+        const double lhs = (*this)(r, i);
+        for (std::size_t k = 0; k < K; k++) {
+          out(r, k) += lhs * rhs(i, k);
+        }
+      }
+    }
+    return out;
+  }
+
+  /**
+   * Solves ``A X = B`` for ``X``, where ``A`` is this (square) matrix, by Gaussian elimination with
+   * partial pivoting. This is cheaper and more accurate than multiplying by an inverse.
+   *
+   * @param ib The right hand side.
+   * @param ox Where the solution is written.
+   * @return false if this matrix is singular, in which case ``ox`` is left unchanged.
+   */
+  template <std::size_t K> bool solve(const Matrix<R, K> &ib, Matrix<R, K> &ox) const {
+    static_assert(R == C, "Only square systems can be solved");
+    Matrix a(*this);
+    Matrix<R, K> b(ib);
+
+    for (std::size_t col = 0; col < R; col++) {
+      std::size_t pivot = col;
+      for (std::size_t r = col + 1; r < R; r++) {
+        if (std::abs(a(r, col)) > std::abs(a(pivot, col))) {
+          pivot = r;
+        }
+      }
+
+      if (std::abs(a(pivot, col)) < 1e-300) {
+        return false;
+      }
+
+      if (pivot != col) {
+        for (std::size_t c = 0; c < R; c++) {
+          std::swap(a(pivot, c), a(col, c));
+        }
+        for (std::size_t k = 0; k < K; k++) {
+          std::swap(b(pivot, k), b(col, k));
+        }
+      }
+
+      for (std::size_t r = col + 1; r < R; r++) {
+        const double factor = a(r, col) / a(col, col);
+        for (std::size_t c = col; c < R; c++) {
+          a(r, c) -= factor * a(col, c);
+        }
+        for (std::size_t k = 0; k < K; k++) {
+          b(r, k) -= factor * b(col, k);
+        }
+      }
+    }
+
+    for (std::size_t i = R; i-- > 0;) {
+      for (std::size_t k = 0; k < K; k++) {
+        double sum = b(i, k);
+        for (std::size_t c = i + 1; c < R; c++) {
+          sum -= a(i, c) * b(c, k);
+        }
+        b(i, k) = sum / a(i, i);
+      }
+    }
+
+    ox = b;
+    return true;
+  }
+
+  protected:
+  std::array<double, R * C> data{};
+};
+
+/**
+ * A column vector.
+ */
+template <std::size_t N> using Vector = Matrix<N, 1>;
+} // namespace spooder
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace spooder {
+/**
+ * Calls ``ibody(i)`` for every ``i`` in ``[0, icount)``. On a desktop (``THREADS_STD``) the calls
+ * are spread over a pool of worker threads that pull indices from a shared counter, so uneven work
+ * still balances across cores. On the robot there is one core, so the calls run in order on the
+ * calling task.
+ *
+ * The calls may run concurrently and in any order, so ``ibody`` must only write to state owned by
+ * its index. Returns once every call has finished.
+ *
+ * @param icount The number of indices.
+ * @param ibody The function to call for each index.
+ * @param ithreads The number of worker threads, or 0 for one per core.
+ */
+template <typename F>
+void parallelFor(const std::size_t icount, F &&ibody, std::size_t ithreads = 0) {
+#ifdef THREADS_STD
+  if (ithreads == 0) {
+    ithreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  ithreads = std::min(ithreads, icount);
+
+  std::atomic_size_t next{0};
+  auto worker = [&]() {
+    for (std::size_t i = next++; i < icount; i = next++) {
+      ibody(i);
+    }
+  };
+
+  std::vector<std::thread> pool;
+  pool.reserve(ithreads);
+  for (std::size_t i = 1; i < ithreads; i++) {
+    pool.emplace_back(worker);
+  }
+  worker();
+
+  for (auto &thread : pool) {
+    thread.join();
+  }
+#else
+  (void)ithreads;
+  for (std::size_t i = 0; i < icount; i++) {
+    ibody(i);
+  }
+#endif
+}
+} // namespace spooder
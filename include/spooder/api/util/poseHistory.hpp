@@ -0,0 +1,95 @@
+#pragma once
+
+#include "okapi/api/odometry/odomMath.hpp"
+#include "okapi/api/odometry/odomState.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include <array>
+#include <optional>
+
+namespace spooder {
+/**
+ * The last few odometry poses and when they were taken, so a measurement that was made some time
+ * ago, like a camera frame, can be matched with where the robot was when it was made. The poses
+ * live in a fixed size ring, so recording one never allocates.
+ *
+ * @tparam n The number of poses kept. Record a pose every period and keep enough to cover the
+ * longest latency being compensated for.
+ */
+template <std::size_t n = 32> class PoseHistory {
+  public:
+  static_assert(n >= 2, "A PoseHistory needs room for at least two poses");
+
+  /**
+   * Records a pose. Poses must be recorded in time order.
+   *
+   * @param itime When the pose was taken.
+   * @param istate The pose.
+   */
+  void record(const okapi::QTime itime, const okapi::OdomState &istate) {
+    newest = (newest + 1) % n;
+    entries[newest] = {itime, istate};
+    if (count < n) {
+      count++;
+    }
+  }
+
+  /**
+   * Finds where the robot was at a time, interpolating between the poses either side of it. Times
+   * before the oldest pose get the oldest, and times after the newest get the newest.
+   *
+   * @param itime The time.
+   * @return The pose at that time, or nothing if no pose has been recorded.
+   */
+  std::optional<okapi::OdomState> getAt(const okapi::QTime itime) const {
+    if (count == 0) {
+      return std::nullopt;
+    }
+
+    // Walk back from the newest pose to the first one at or before the time
+    std::size_t after = newest;
+    for (std::size_t i = 1; i < count; i++) {
+      const std::size_t before = (newest + n - i) % n;
+      if (entries[before].time <= itime) {
+        return interpolate(entries[before], entries[after], itime);
+      }
+      after = before;
+    }
+
+    return entries[after].state;
+  }
+
+  /**
+   * @return The number of poses kept.
+   */
+  std::size_t size() const {
+    return count;
+  }
+
+  protected:
+  struct Entry {
+    okapi::QTime time{0 * okapi::millisecond};
+    okapi::OdomState state;
+  };
+
+  std::array<Entry, n> entries;
+  std::size_t newest{n - 1};
+  std::size_t count{0};
+
+  static okapi::OdomState
+  interpolate(const Entry &ibefore, const Entry &iafter, const okapi::QTime itime) {
+    if (itime >= iafter.time || iafter.time <= ibefore.time) {
+      return iafter.state;
+    }
+
+    const double fraction =
+      ((itime - ibefore.time) / (iafter.time - ibefore.time)).convert(okapi::number);
+    const auto &a = ibefore.state;
+    const auto &b = iafter.state;
+
+    // Turn the short way round, in case the heading wrapped between the two poses
+    return {a.x + (b.x - a.x) * fraction,
+            a.y + (b.y - a.y) * fraction,
+            a.theta + okapi::OdomMath::constrainAngle180(b.theta - a.theta) * fraction};
+  }
+};
+} // namespace spooder
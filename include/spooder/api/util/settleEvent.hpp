@@ -0,0 +1,79 @@
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include <atomic>
+
+#ifdef THREADS_STD
+#include <condition_variable>
+#include <mutex>
+#endif
+
+namespace spooder {
+class SettleEvent {
+  public:
+  /**
+   * A flag that tasks can block on until another task sets it. Setting it wakes every waiting task
+   * at once, without them polling, and it stays set until it is cleared. On the robot this is a
+   * PROS semaphore; on the desktop it is a condition variable.
+   */
+  SettleEvent();
+
+  ~SettleEvent();
+
+  SettleEvent(const SettleEvent &) = delete;
+
+  SettleEvent &operator=(const SettleEvent &) = delete;
+
+  /**
+   * Sets the flag and wakes every task waiting on it.
+   */
+  void set();
+
+  /**
+   * Clears the flag.
+   */
+  void clear();
+
+  /**
+   * @return Whether the flag is set.
+   */
+  bool isSet() const;
+
+  /**
+   * Blocks until the flag is set. Returns immediately if it already is.
+   */
+  void wait();
+
+  /**
+   * Blocks until the flag is set or the timeout passes. Returns immediately if it is already set.
+   *
+   * @param itimeout The longest time to wait.
+   * @return Whether the flag was set, false if the wait timed out.
+   */
+  bool wait(okapi::QTime itimeout);
+
+  /**
+   * Sets another event whenever this one is set, so one task can sleep on several events at once
+   * by waiting on the listener. There is one listener at a time.
+   *
+   * @param ilistener The event to set, or nullptr for none. It must outlive this event or be
+   * removed first.
+   */
+  void setListener(SettleEvent *ilistener);
+
+  protected:
+  std::atomic<SettleEvent *> listener{nullptr};
+
+#ifdef THREADS_STD
+  mutable std::mutex mutex;
+  std::condition_variable cv;
+  bool flag{false};
+#else
+  pros::c::sem_t sem;
+  std::atomic_bool flag{false};
+
+  bool waitMillis(std::uint32_t itimeout);
+#endif
+};
+} // namespace spooder
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "okapi/api/control/util/settledUtil.hpp"
+#include "okapi/api/util/abstractRate.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <memory>
+
+namespace spooder {
+/**
+ * Something that keeps its own simulated time, such as a physics simulator.
+ */
+class SimulationClock {
+  public:
+  virtual ~SimulationClock() = default;
+
+  /**
+   * @return The simulated time.
+   */
+  virtual okapi::QTime getTime() const = 0;
+
+  /**
+   * Steps the simulation until the simulated time reaches ``itime``. Does nothing if it already
+   * has.
+   *
+   * @param itime The simulated time to advance to.
+   */
+  virtual void advanceTo(okapi::QTime itime) = 0;
+};
+
+/**
+ * A timer that reads a SimulationClock instead of the system clock.
+ */
+class SimulatedTimer : public okapi::AbstractTimer {
+  public:
+  /**
+   * @param iclock The clock to read.
+   */
+  explicit SimulatedTimer(std::shared_ptr<SimulationClock> iclock);
+
+  okapi::QTime millis() const override;
+
+  protected:
+  std::shared_ptr<SimulationClock> clock;
+};
+
+/**
+ * A rate that, instead of sleeping, steps a SimulationClock forward by the requested time. Code
+ * written against okapi::AbstractRate therefore runs in lockstep with the simulation and as fast
+ * as the simulation can step. Only one thread may drive a clock this way at a time.
+ */
+class SimulatedRate : public okapi::AbstractRate {
+  public:
+  /**
+   * @param iclock The clock to step.
+   */
+  explicit SimulatedRate(std::shared_ptr<SimulationClock> iclock);
+
+  void delay(okapi::QFrequency ihz) override;
+
+  void delayUntil(okapi::QTime itime) override;
+
+  void delayUntil(uint32_t ims) override;
+
+  protected:
+  std::shared_ptr<SimulationClock> clock;
+  okapi::QTime lastTime;
+};
+
+/**
+ * Makes a TimeUtil whose timers, rates, and settled utils all run on simulated time.
+ *
+ * @param iclock The clock to use.
+ * @param iatTargetError The minimum error to be considered settled.
+ * @param iatTargetDerivative The minimum error derivative to be considered settled.
+ * @param iatTargetTime The minimum time within atTargetError to be considered settled.
+ * @return The TimeUtil.
+ */
+okapi::TimeUtil
+createSimulatedTimeUtil(const std::shared_ptr<SimulationClock> &iclock,
+                        double iatTargetError = 50,
+                        double iatTargetDerivative = 5,
+                        okapi::QTime iatTargetTime = 250 * okapi::millisecond);
+} // namespace spooder
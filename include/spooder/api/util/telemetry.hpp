@@ -0,0 +1,62 @@
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include <cstdarg>
+#include <cstdio>
+#include <memory>
+
+namespace spooder {
+class Telemetry {
+  public:
+  /**
+   * A disabled telemetry sink. Every record sent to it is dropped.
+   */
+  Telemetry() noexcept;
+
+  /**
+   * Writes machine-readable telemetry records, one per line, in the form
+   * ``<time ms>,<channel>,<fields...>``. Records from different subsystems share one stream and
+   * are told apart by their channel, so the serial terminal output can be split with a single grep
+   * and loaded into a spreadsheet.
+   *
+   * @param itimer The timer used to timestamp records.
+   * @param ifile The file to write to, usually ``stdout`` (the serial terminal) or a file on the
+   * SD card. The file is not closed by this class.
+   */
+  Telemetry(std::unique_ptr<okapi::AbstractTimer> itimer, FILE *ifile) noexcept;
+
+  /**
+   * @return Whether records sent to this sink are written anywhere.
+   */
+  bool isEnabled() const noexcept;
+
+  /**
+   * Sends a record. The fields are formatted with ``printf`` semantics and should be comma
+   * separated.
+   *
+   * @param ichannel The channel this record belongs to, such as ``"task"`` or ``"shot"``.
+   * @param iformat The ``printf`` format string for the fields.
+   */
+  void send(const char *ichannel, const char *iformat, ...) noexcept
+    __attribute__((format(printf, 3, 4)));
+
+  /**
+   * @return The telemetry sink used by subsystems which were not given one explicitly.
+   */
+  static std::shared_ptr<Telemetry> getDefaultTelemetry();
+
+  /**
+   * Sets the telemetry sink used by subsystems which were not given one explicitly. Subsystems
+   * read the default when they are constructed, so call this first thing in ``initialize()``.
+   *
+   * @param itelemetry The new default sink.
+   */
+  static void setDefaultTelemetry(std::shared_ptr<Telemetry> itelemetry);
+
+  protected:
+  std::unique_ptr<okapi::AbstractTimer> timer;
+  FILE *file;
+  CrossplatformMutex fileMutex;
+};
+} // namespace spooder
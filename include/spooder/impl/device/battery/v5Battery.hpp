@@ -0,0 +1,17 @@
+#pragma once
+
+#include "spooder/api/device/battery/abstractBattery.hpp"
+
+namespace spooder {
+class V5Battery : public AbstractBattery {
+  public:
+  /**
+   * The V5 battery, read through the brain.
+   */
+  V5Battery() = default;
+
+  std::int32_t getVoltage() override;
+
+  std::int32_t getCurrent() override;
+};
+} // namespace spooder
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/impl/device/opticalSensor.hpp"
+#include "spooder/api/device/optical/abstractColorSensor.hpp"
+
+namespace spooder {
+class OpticalColorSensor : public AbstractColorSensor {
+  public:
+  /**
+   * The V5 optical sensor, with its gesture sensor off and its LED on so the color it reads does
+   * not depend on the field lighting. The sensor's integration time is shortened from its 100 ms
+   * default, so a new color shows up in a few milliseconds instead of a tenth of a second, at the
+   * cost of a noisier reading.
+   *
+   * @param iport The sensor's port.
+   * @param iintegrationTime How long the sensor collects light for each reading. The sensor
+   * accepts 3 ms to 712 ms.
+   * @param iledPower The LED's brightness in percent.
+   */
+  explicit OpticalColorSensor(std::uint8_t iport,
+                              okapi::QTime iintegrationTime = 10 * okapi::millisecond,
+                              std::uint8_t iledPower = 100);
+
+  double getHue() override;
+
+  double getSaturation() override;
+
+  std::int32_t getProximity() override;
+
+  protected:
+  okapi::OpticalSensor sensor;
+};
+} // namespace spooder
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "okapi/impl/device/controller.hpp"
+#include "spooder/api/util/inputLog.hpp"
+#include <array>
+#include <memory>
+
+namespace spooder {
+class ReplayController : public okapi::Controller {
+  public:
+  /**
+   * A controller whose inputs can be recorded and replayed. It reads the real controller once per
+   * step() into an InputFrame, and every analog, digital, and button read in that tick sees the
+   * same frame. When a replay is loaded, the frames come from the replay instead, so a recorded
+   * driver session drives the robot code exactly as it did the first time.
+   *
+   * Buttons from operator[] also read the frame, so keep references to them instead of making
+   * separate okapi::ControllerButton objects.
+   *
+   * @param iid The controller to read when not replaying.
+   */
+  explicit ReplayController(okapi::ControllerId iid = okapi::ControllerId::master);
+
+  /**
+   * Starts replaying a session. Once it ends, every input reads as released and centered.
+   *
+   * @param ireplay The session to replay, or nullptr to go back to the real controller.
+   */
+  void setReplay(std::shared_ptr<InputReplay> ireplay);
+
+  /**
+   * Starts replaying a session from a file, if there is one. Nothing is loaded while the robot is
+   * connected to field control or a competition switch, so a log left on the SD card can never
+   * take over a match. Any replay loaded before is dropped, even if this one is not loaded.
+   *
+   * @param ipath The path of the log, such as ``/usd/replay.bin``.
+   * @return Whether a replay was loaded.
+   */
+  bool loadReplay(const char *ipath);
+
+  /**
+   * @return Whether a replay is loaded.
+   */
+  bool isReplaying() const;
+
+  /**
+   * Reads this tick's inputs from the controller or the replay. Call once per tick, before
+   * reading any inputs.
+   */
+  void step();
+
+  /**
+   * @return This tick's inputs, for recording with InputRecorder.
+   */
+  const InputFrame &getFrame() const;
+
+  bool isConnected() override;
+
+  float getAnalog(okapi::ControllerAnalog ichannel) override;
+
+  bool getDigital(okapi::ControllerDigital ibutton) override;
+
+  okapi::ControllerButton &operator[](okapi::ControllerDigital ibtn) override;
+
+  protected:
+  class Button : public okapi::ControllerButton {
+    public:
+    Button(const ReplayController &icontroller, okapi::ControllerDigital ibtn);
+
+    protected:
+    const ReplayController &controller;
+    std::size_t button;
+
+    bool currentlyPressed() override;
+  };
+
+  std::shared_ptr<InputReplay> replay;
+  InputFrame frame{};
+  bool connected{false};
+  std::array<std::unique_ptr<Button>, InputFrame::buttons> buttons{};
+};
+} // namespace spooder
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "spooder/api/device/vision/abstractGoalCamera.hpp"
+#include <cstdint>
+
+namespace spooder {
+class V5GoalCamera : public AbstractGoalCamera {
+  public:
+  /**
+   * The V5 vision sensor, looking for the objects that match one of its color signatures. The
+   * sensor's zero point is moved to the center of the image.
+   *
+   * @param iport The sensor's port.
+   * @param isignature The goal's signature, 1 to 7, as set up in the vision utility.
+   */
+  V5GoalCamera(std::uint8_t iport, std::uint32_t isignature);
+
+  std::size_t getGoals(GoalDetection *odetections, std::size_t imax) override;
+
+  protected:
+  std::uint8_t port;
+  std::uint32_t signature;
+};
+} // namespace spooder
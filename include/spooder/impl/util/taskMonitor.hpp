@@ -0,0 +1,159 @@
+#pragma once
+
+#include "api.h"
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "spooder/api/util/telemetry.hpp"
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace spooder {
+struct TaskStats {
+  std::string name;
+  pros::task_state_e_t state{pros::E_TASK_STATE_INVALID};
+  std::uint32_t priority{0};
+
+  /**
+   * The fewest free stack words this task has ever had, or -1 if the kernel does not expose stack
+   * high-water marks.
+   */
+  std::int32_t stackHighWater{-1};
+
+  /**
+   * The share of the last sample period this task spent inside a TaskMonitor::BusyScope, in the
+   * range ``[0, 1]``, or NaN if the task is not instrumented.
+   */
+  double cpuShare{NAN};
+};
+
+class TaskMonitor {
+  public:
+  /**
+   * Periodically samples the state, priority, stack high-water mark and CPU share of a set of
+   * tasks. Results are available from getStats(), sent to telemetry on the ``task`` channel, and
+   * cycled through one task per sample on an LCD line.
+   *
+   * The PROS competition tasks are watched by default; other tasks are added with watch().
+   * CPU share is measured for tasks whose loop bodies are wrapped in a BusyScope, since the kernel
+   * does not keep per-task run time statistics.
+   *
+   * @param isamplePeriod The time between samples.
+   * @param ilcdLine The LLEMU line to print to, or -1 to leave the screen alone.
+   * @param itelemetry The telemetry sink samples are sent to.
+   * @param ilogger The logger this instance will log to.
+   */
+  explicit TaskMonitor(
+    okapi::QTime isamplePeriod = 500 * okapi::millisecond,
+    std::int16_t ilcdLine = 3,
+    std::shared_ptr<Telemetry> itelemetry = Telemetry::getDefaultTelemetry(),
+    std::shared_ptr<okapi::Logger> ilogger = okapi::Logger::getDefaultLogger());
+
+  TaskMonitor(const TaskMonitor &) = delete;
+
+  TaskMonitor &operator=(const TaskMonitor &) = delete;
+
+  ~TaskMonitor();
+
+  /**
+   * Adds a task to the watch list. Tasks are looked up by name on every sample because the PROS
+   * competition tasks are recreated on every mode switch.
+   *
+   * @param iname The task name, as given to ``pros::Task``.
+   */
+  void watch(const std::string &iname);
+
+  /**
+   * @return A copy of the most recent sample of every watched task.
+   */
+  std::vector<TaskStats> getStats() const;
+
+  /**
+   * @return The total number of tasks the kernel reported in the most recent sample.
+   */
+  std::uint32_t getTaskCount() const;
+
+  /**
+   * Starts the internal thread. This should be called once, from ``initialize()``.
+   */
+  void startThread();
+
+  /**
+   * Returns the underlying thread handle.
+   *
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  /**
+   * Counts the time between its construction and finish() (or its destruction) as busy time for
+   * the current task. Create one at the top of a control loop and finish it before the delay:
+   *
+   * ```cpp
+   * while (true) {
+   *   TaskMonitor::BusyScope busy(monitor);
+   *   // loop body
+   *   busy.finish();
+   *   pros::delay(10);
+   * }
+   * ```
+   */
+  class BusyScope {
+    public:
+    explicit BusyScope(TaskMonitor &imonitor);
+
+    ~BusyScope();
+
+    /**
+     * Stops counting busy time. Later calls and the destructor do nothing.
+     */
+    void finish();
+
+    protected:
+    TaskMonitor &monitor;
+    std::uint64_t start;
+    bool finished{false};
+  };
+
+  protected:
+  struct WatchedTask {
+    TaskStats stats;
+    pros::task_t handle{nullptr};
+    std::uint64_t busyMicros{0};
+  };
+
+  okapi::QTime samplePeriod;
+  std::int16_t lcdLine;
+  std::shared_ptr<Telemetry> telemetry;
+  std::shared_ptr<okapi::Logger> logger;
+  std::vector<WatchedTask> tasks;
+  std::uint32_t taskCount{0};
+  std::uint64_t lastSampleMicros{0};
+  std::size_t lcdIndex{0};
+  mutable CrossplatformMutex tasksMutex;
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  static void trampoline(void *context);
+  void loop();
+
+  /**
+   * Samples every watched task and publishes the results.
+   */
+  void sample();
+
+  /**
+   * Adds busy time to the watched task with the given handle, or with its name if the handle is
+   * not known yet, watching it first if needed.
+   */
+  void addBusyTime(pros::task_t ihandle, std::uint64_t imicros);
+
+  /**
+   * @return The fewest free stack words the task has ever had, or -1 if unknown.
+   */
+  static std::int32_t readStackHighWater(pros::task_t ihandle);
+};
+} // namespace spooder
@@ -0,0 +1,165 @@
+#include "driverControl.h"
+#include <cmath>
+
+using namespace okapi;
+using namespace okapi::literals;
+using namespace spooder;
+
+namespace
+{
+// InputFrame's buttons and sticks, numbered like okapi::ControllerDigital minus
+// InputFrame::firstButton and okapi::ControllerAnalog, which only build with PROS
+enum FrameButton : std::size_t { L1, L2, R1, R2, up, down, left, right, X, B, Y, A };
+enum FrameAnalog : std::size_t { leftX, leftY, rightX, rightY };
+} // namespace
+
+FlywheelTargeter<5> makeFlywheelTargeter(std::function<QLength()> distance)
+{
+	return FlywheelTargeter<5>(
+		RpmTable<5>({{{24_in, 380}, {48_in, 430}, {72_in, 490}, {96_in, 550}, {120_in, 600}}}),
+		RpmTable<5>({{{24_in, 360}, {48_in, 400}, {72_in, 450}, {96_in, 510}, {120_in, 570}}}),
+		std::move(distance));
+}
+
+IntakeJamParams makeIntakeJamParams()
+{
+	// blue cartridge: under 60 rpm is stopped
+	IntakeJamParams params;
+	params.stallVelocity = 60;
+	params.reverseVoltage = 8000;
+	params.reverseTime = 250_ms;
+	return params;
+}
+
+DriverControl::DriverControl(const InputFrame &frame, DriverRobot robot)
+	: frame(frame),
+	  robot(std::move(robot)),
+	  intakeIn(frame, FrameButton::R2),
+	  intakeOut(frame, FrameButton::R1),
+	  fastFlywheel(frame, FrameButton::A),
+	  slowFlywheel(frame, FrameButton::B),
+	  flywheelStop(frame, FrameButton::up),
+	  angleChange(frame, FrameButton::Y),
+	  fireButton(frame, FrameButton::L1),
+	  rapidFireButton(frame, FrameButton::L2),
+	  aimButton(frame, FrameButton::X),
+	  rollerButton(frame, FrameButton::down)
+{
+}
+
+void DriverControl::start()
+{
+	// the shot sequencer counts shots for the whole program, and opcontrol() starts again on every
+	// enable, so only count shots from here on
+	countedShots = robot.shotSequencer.getShotCount();
+}
+
+void DriverControl::step()
+{
+	// turn to face the goal while aiming, otherwise drive chassis like a tank
+	if (aimButton.isPressed())
+	{
+		robot.turnToGoal.step();
+	}
+	else
+	{
+		robot.drive->tank(frame.getAnalog(FrameAnalog::leftY), frame.getAnalog(FrameAnalog::rightY));
+	}
+
+	// shoot while held, or feed one disc after another with rapid fire
+	if (fireButton.isPressed() || rapidFireButton.isPressed())
+	{
+		robot.shotSequencer.setMode(rapidFireButton.isPressed() ? ShotSequencer::Mode::rapid
+																: ShotSequencer::Mode::precise);
+		robot.shotSequencer.setFiring(true);
+	}
+	else
+	{
+		robot.shotSequencer.setFiring(false);
+	}
+
+	// every shot is a disc gone from the robot
+	const std::size_t shots = robot.shotSequencer.getShotCount();
+	robot.discCounter.remove(static_cast<int>(shots - countedShots));
+	countedShots = shots;
+
+	// intake code, unless the shot sequencer is running it for a burst; it sets the intake again
+	// on every step of one, so a burst starting just after this check still wins
+	if (robot.shotSequencer.getState() == ShotSequencer::State::idle)
+	{
+		if (intakeIn.isPressed())
+		{
+			robot.intakeController.setTarget(12000);
+		}
+		else if (intakeOut.isPressed())
+		{
+			robot.intakeController.setTarget(-12000);
+		}
+		else
+		{
+			robot.intakeController.setTarget(0);
+		}
+	}
+
+	// turn the roller, or stop it if it is already turning
+	if (rollerButton.changedToPressed())
+	{
+		if (robot.rollerController.getState() == RollerController::State::turning)
+		{
+			robot.rollerController.cancel();
+		}
+		else
+		{
+			robot.rollerController.start();
+		}
+	}
+
+	// flywheel
+	if (fastFlywheel.isPressed())
+	{
+		targeting = true; // speed for the distance to the goal, updated every tick below
+		robot.currentBudget.setPriority(robot.flywheelBudget, 3); // shooting, so feed the flywheel first
+	}
+	else if (slowFlywheel.isPressed())
+	{
+		targeting = false;
+		robot.flywheel->moveVelocity(2500/6); // 3k rpm
+		target = 2500/6;
+		robot.shotSequencer.setTarget(target);
+		robot.currentBudget.setPriority(robot.flywheelBudget, 3);
+	}
+	else if (flywheelStop.isPressed())
+	{
+		targeting = false;
+		robot.flywheel->moveVoltage(0); // flywheel is just going to keep on spinning
+		target = 0.0;
+		robot.shotSequencer.setTarget(0);
+		robot.currentBudget.setPriority(robot.flywheelBudget, 1);
+	}
+	if (targeting)
+	{
+		target = robot.flywheelTargeter.step(angled);
+		robot.flywheel->moveVelocity(static_cast<std::int16_t>(std::lround(target)));
+		robot.shotSequencer.setTarget(target);
+	}
+
+	// angle changer
+	if (angleChange.changedToPressed())
+	{
+		angled = !angled;
+		robot.angleChanger(angled);
+	}
+
+	// send this tick's motor commands together
+	robot.motorBatch.flush();
+}
+
+double DriverControl::getFlywheelTarget() const
+{
+	return target;
+}
+
+bool DriverControl::isAngled() const
+{
+	return angled;
+}
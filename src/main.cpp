@@ -1,26 +1,56 @@
 #include "main.h"
+#include "driverControl.h"
+#include "routines.h"
 
-// make controller buttons
-ControllerButton intakeIn(ControllerDigital::R2);
-ControllerButton intakeOut(ControllerDigital::R1);
+// make controller, which can replay a recorded driver session
+ReplayController master;
 
-ControllerButton fastFlywheel(ControllerDigital::A);
-ControllerButton slowFlywheel(ControllerDigital::B);
-ControllerButton flywheelStop(ControllerDigital::up);
+// send telemetry over the serial terminal
+std::shared_ptr<Telemetry> telemetry = std::make_shared<Telemetry>(std::make_unique<Timer>(), stdout);
 
-ControllerButton angleChange(ControllerDigital::Y);
+// hold each tick's motor commands and send them all together at its end
+MotorCommandBatch motorBatch(500_ms, telemetry);
+
+// scale voltage commands for the battery's charge, so speeds match from a full to a low battery
+std::shared_ptr<V5Battery> battery = std::make_shared<V5Battery>();
+VoltageCompensator voltageCompensator(battery, TimeUtilFactory::createDefault());
+
+// watch every motor's temperature and back it off before its firmware cuts its current at 55 C
+MotorHealthMonitor healthMonitor(TimeUtilFactory::createDefault(), MotorHealthParams{}, telemetry);
+
+// make drive motors, kept separate so the current budget and health monitor can read each one
+std::shared_ptr<AbstractMotor> leftDrive[] = {
+	healthMonitor.add("left front", std::make_shared<Motor>(-12)),
+	healthMonitor.add("left middle", std::make_shared<Motor>(-14)),
+	healthMonitor.add("left back", std::make_shared<Motor>(16))};
+std::shared_ptr<AbstractMotor> rightDrive[] = {
+	healthMonitor.add("right front", std::make_shared<Motor>(13)),
+	healthMonitor.add("right middle", std::make_shared<Motor>(15)),
+	healthMonitor.add("right back", std::make_shared<Motor>(-17))};
 
 // make chassis
 std::shared_ptr<OdomChassisController> chassis =
 	ChassisControllerBuilder()
 		.withMotors(
-			{-12, -14, 16},
-			{13, 15, -17})
+			voltageCompensator.compensate(motorBatch.add(
+				std::make_shared<MotorGroup>(MotorGroup({leftDrive[0], leftDrive[1], leftDrive[2]})))),
+			voltageCompensator.compensate(motorBatch.add(
+				std::make_shared<MotorGroup>(MotorGroup({rightDrive[0], rightDrive[1], rightDrive[2]})))))
 		// Green gearset, 4 in wheel diam, 11.5 in wheel track
 		.withDimensions(AbstractMotor::gearset::green, {{3.25_in, 11.5_in}, imev5GreenTPR})
 		.withOdometry()
 		.buildOdometry();
 
+// track the goal with the vision sensor (signature 1), against odometry to undo the frame latency
+std::shared_ptr<GoalTracker> goalTracker = std::make_shared<GoalTracker>(
+	std::make_shared<V5GoalCamera>(6, 1), chassis->getOdometry(), TimeUtilFactory::createDefault(),
+	GoalTrackerParams{}, telemetry);
+TurnToGoalController turnToGoal(
+	TimeUtilFactory::createDefault(), chassis->getModel(), goalTracker, TurnToGoalController::Gains{});
+
+// chain autonomous moves together without stopping between them
+MotionQueue motionQueue(TimeUtilFactory::createDefault(), chassis, MotionQueue::Gains{});
+
 // make path generator | copied from okapi tutorials
 std::shared_ptr<AsyncMotionProfileController> profileController =
 	AsyncMotionProfileControllerBuilder()
@@ -33,12 +63,72 @@ std::shared_ptr<AsyncMotionProfileController> profileController =
 		.buildMotionProfileController();
 
 // make intake and flywheel
-Motor intake(7);
-Motor flywheel(19);
+std::shared_ptr<AbstractMotor> intake = voltageCompensator.compensate(
+	motorBatch.add(healthMonitor.add("intake", std::make_shared<Motor>(7))));
+std::shared_ptr<Motor> flywheelMotor = std::make_shared<Motor>(19);
+
+// run the intake for the driver, backing jammed discs out and trying again
+IntakeController intakeController(intake, TimeUtilFactory::createDefault(), IntakeJamParams{}, telemetry);
+
+// count the discs in the robot with a distance sensor across the intake, so the driver knows when
+// it holds 3; the count can drift, so it only warns and never stops the intake
+DiscCounter discCounter(std::make_shared<DistanceSensor>(3), []() { return intakeController.getDirection(); },
+						TimeUtilFactory::createDefault(), DiscCounterParams{}, telemetry);
+
+// the discs loaded into the robot before a match
+const int preloads = 2;
+
+std::shared_ptr<AbstractMotor> flywheel = voltageCompensator.compensate(
+	motorBatch.add(healthMonitor.add("flywheel", flywheelMotor)));
+
+// flywheel velocity from timestamped encoder readings, smoother than getActualVelocity
+std::shared_ptr<MotorVelocityEstimator<>> flywheelVelocity = std::make_shared<MotorVelocityEstimator<>>(flywheel);
+
+// feed discs with the intake only once the flywheel is back at speed
+ShotSequencer shotSequencer(
+	flywheelVelocity, [](bool feed) { intakeController.setTarget(feed ? 12000 : 0); },
+	TimeUtilFactory::createDefault(), ShotParams{}, telemetry);
+
+// turn the roller to our color, stopped the moment the optical sensor sees it; the roller motor
+// is not batched so the stop goes out straight away
+std::shared_ptr<AbstractMotor> roller = healthMonitor.add("roller", std::make_shared<Motor>(8));
+RollerController rollerController(roller, std::make_shared<OpticalColorSensor>(4),
+								  TimeUtilFactory::createDefault(), RollerParams{}, telemetry);
+
+// share the motor current by priority so the battery does not sag; 16 A keeps it above 11.5 V
+CurrentBudgetParams budgetParams{16000};
+CurrentBudget currentBudget(battery, budgetParams, telemetry);
+std::size_t flywheelBudget = 0;
 
 // make angle changer
-bool angled = false;
-pros::ADIDigitalOut AngleChanger('h', angled);
+pros::ADIDigitalOut AngleChanger('h', false);
+
+// a distance sensor facing the goal
+pros::Distance goalSensor(5);
+
+// flywheel speeds that score from each distance to the goal, with the angle changer down and up
+FlywheelTargeter<5> flywheelTargeter = makeFlywheelTargeter(
+	[]() {
+		// the sensor is better when it can see the goal; odometry drifts but always has an answer
+		const std::int32_t reading = goalSensor.get();
+		if (reading != PROS_ERR && reading > 0 && reading < 2000 && goalSensor.get_confidence() > 45)
+		{
+			return reading * millimeter;
+		}
+		return OdomMath::computeDistanceToPoint(goal, chassis->getState());
+	});
+
+// the driver control loop's decisions, shared with the desktop replay in host/replayDrive.cpp
+DriverControl driverControl(
+	master.getFrame(),
+	{chassis->getModel(), turnToGoal, shotSequencer, intakeController, discCounter, rollerController,
+	 flywheel, flywheelTargeter, currentBudget, flywheelBudget, motorBatch, [](bool angled) {
+		 pros::lcd::set_text(7, "sdfsd");
+		 AngleChanger.set_value(angled);
+	 }});
+
+// watch task stacks and cpu usage, shown on lcd line 3
+TaskMonitor taskMonitor(500_ms, 3, telemetry);
 
 
 /**
@@ -60,6 +150,17 @@ void on_center_button()
 		pros::lcd::clear_line(2);
 	}
 }
+// replay /usd/replay.bin in driver control; armed from the brain, and never in a match
+bool replayArmed = false;
+
+/**
+ * A callback function for LLEMU's left button, which arms or disarms the replay.
+ */
+void on_left_button()
+{
+	replayArmed = !replayArmed;
+	pros::lcd::set_text(7, replayArmed ? "replay armed" : "");
+}
 /**
  * Runs initialization code. This occurs as soon as the program is started.
  *
@@ -70,14 +171,40 @@ void initialize()
 {
 	pros::lcd::initialize();
 	pros::lcd::set_text(1, "Hello PROS User!");
+	pros::lcd::register_btn0_cb(on_left_button);
+
+	Telemetry::setDefaultTelemetry(telemetry);
+	taskMonitor.startThread();
+	motorBatch.startThread(TimeUtilFactory::createDefault().getRate());
+	currentBudget.add(
+		"drive", {leftDrive[0], leftDrive[1], leftDrive[2], rightDrive[0], rightDrive[1], rightDrive[2]}, 2, 1000);
+	flywheelBudget = currentBudget.add("flywheel", {flywheel}, 1, 1000);
+	currentBudget.add("intake", {intake}, 0, 500);
+	currentBudget.startThread(TimeUtilFactory::createDefault().getRate());
+	// Derating scales voltage commands as they are sent, so have the batch send them again
+	healthMonitor.setOnScaleChange([]() { motorBatch.resend(); });
+	healthMonitor.startThread(TimeUtilFactory::createDefault().getRate());
 
 	// pros::lcd::register_btn1_cb(change_piston);
-	intake.setGearing(AbstractMotor::gearset::blue);
-	intake.setBrakeMode(AbstractMotor::brakeMode::hold);
+	intake->setGearing(AbstractMotor::gearset::blue);
+	intake->setBrakeMode(AbstractMotor::brakeMode::hold);
 
-	flywheel.setBrakeMode(AbstractMotor::brakeMode::coast);
-	flywheel.setGearing(AbstractMotor::gearset::blue);
-	flywheel.setVelPID(0.0075,0.25,0,0);
+	// hold keeps a disc in place while it is stopped
+	intakeController.setParams(makeIntakeJamParams());
+	intakeController.startThread(TimeUtilFactory::createDefault().getRate());
+	discCounter.setCount(preloads);
+	discCounter.startThread(TimeUtilFactory::createDefault().getRate());
+	shotSequencer.startThread(TimeUtilFactory::createDefault().getRate());
+	goalTracker->startThread(TimeUtilFactory::createDefault().getRate());
+
+	// hold stops the roller where it is told to instead of letting it coast past the color
+	roller->setBrakeMode(AbstractMotor::brakeMode::hold);
+	rollerController.setTargetColor(RollerColor::red); // our alliance's color, set before each match
+	rollerController.startThread(TimeUtilFactory::createDefault().getRate());
+
+	flywheel->setBrakeMode(AbstractMotor::brakeMode::coast);
+	flywheel->setGearing(AbstractMotor::gearset::blue);
+	flywheelMotor->setVelPID(0.0075,0.25,0,0);
 }
 
 /**
@@ -111,11 +238,30 @@ void competition_initialize() {}
  */
 void autonomous()
 {
-	for (size_t i = 0; i < 4; i++)
-	{
-		chassis->moveDistance(12_in);
-		chassis->turnAngle(90_deg);
-	}
+	// the async controllers command the drive from their own tasks, so flush in the background
+	motorBatch.setAutoFlush(true);
+	discCounter.setCount(preloads);
+
+	// shoot the preloads the moment the chassis settles at the end of the route, with the flywheel
+	// brought up to speed on the way; both waits are bounded so the task is done before opcontrol()
+	motionQueue.getSettleEvent().clear();
+	pros::Task shooter([]() {
+		const double target = flywheelTargeter.step(false);
+		flywheel->moveVelocity(static_cast<std::int16_t>(std::lround(target)));
+		shotSequencer.setTarget(target);
+		if (motionQueue.getSettleEvent().wait(12_s))
+		{
+			const std::size_t shots = shotSequencer.getShotCount();
+			shotSequencer.setMode(ShotSequencer::Mode::precise);
+			shotSequencer.setFiring(true);
+			for (int i = 0; i < 125 && shotSequencer.getShotCount() - shots < static_cast<std::size_t>(preloads); i++)
+			{
+				pros::delay(20);
+			}
+			shotSequencer.setFiring(false);
+		}
+	});
+	squareRoutine(motionQueue);
 }
 
 /**
@@ -133,74 +279,92 @@ void autonomous()
  */
 void opcontrol()
 {
-	// make controller
-	Controller master;
+	// replay the driver session in /usd/replay.bin if armed, and otherwise drop any replay left from
+	// the last time, which would lock the driver out once it ended; record this session to a new
+	// file each time so a re-enable does not overwrite the last one
+	if (replayArmed && !pros::competition::is_connected())
+	{
+		master.loadReplay("/usd/replay.bin");
+	}
+	else
+	{
+		master.setReplay(nullptr);
+	}
+	InputRecorder recorder(InputRecorder::unusedPath("/usd/inputs%03u.bin").c_str());
 
-	int aSpeed = 3600 * 10 / 3;
-	int bSpeed = 3000 * 10 / 3;
+	// flush at the end of each tick instead
+	motorBatch.setAutoFlush(false);
+	driverControl.start();
 
-	double target = 0.0;
+	// what the controller screen shows
+	int shownDiscs = -1;
+	bool rumbled = false;
 
 
 	while (true)
 	{
+		TaskMonitor::BusyScope busy(taskMonitor);
+
+		// read this tick's controller inputs
+		master.step();
+		recorder.record(master.getFrame());
+
 		pros::lcd::print(0, "%d %d %d", (pros::lcd::read_buttons() & LCD_BTN_LEFT) >> 2,
 						 (pros::lcd::read_buttons() & LCD_BTN_CENTER) >> 1,
 						 (pros::lcd::read_buttons() & LCD_BTN_RIGHT) >> 0);
 
-		// drive chassis like a tank
-		chassis->getModel()->tank(master.getAnalog(ControllerAnalog::leftY), master.getAnalog(ControllerAnalog::rightY));
+		// drive, shoot, intake, turn the roller and spin the flywheel, and send the motor commands
+		driverControl.step();
 
-		// intake code
-		if (intakeIn.isPressed())
-		{
-			intake.moveVoltage(12000);
-		}
-		else if (intakeOut.isPressed())
-		{
-			intake.moveVoltage(-12000);
-		}
-		else
-		{
-			intake.moveVoltage(0);
-		}
+		pros::lcd::print(2, "jams %u lost %.1fs", static_cast<unsigned>(intakeController.getJamCount()),
+						 intakeController.getTimeLost().convert(second));
 
-		// flywheel
-		if (fastFlywheel.isPressed())
+		// show the disc count on the controller, and rumble when full so the driver stops intaking;
+		// the controller drops messages sent less than 50 ms apart, so only count one as shown once
+		// it is sent
+		const int discs = discCounter.getCount();
+		const bool full = discCounter.isFull();
+		if (discs != shownDiscs)
 		{
-			flywheel.moveVelocity(600); // max speed
-			target = 600.0;
+			if (master.setText(0, 0, "discs " + std::to_string(discs) + "  ") == 1)
+			{
+				shownDiscs = discs;
+			}
 		}
-		else if (slowFlywheel.isPressed())
+		else if (full && !rumbled)
 		{
-			flywheel.moveVelocity(2500/6); // 3k rpm
-			target = 2500/6;
+			if (master.rumble(".") == 1)
+			{
+				rumbled = true;
+			}
 		}
-		else if (flywheelStop.isPressed())
+		if (!full)
 		{
-			flywheel.moveVoltage(0); // flywheel is just going to keep on spinning
+			rumbled = false;
 		}
-		// change brain color if intake is hot
-		if (intake.getTemperature() > 70)
+
+		pros::lcd::print(1, "roller %.0fms %uus", rollerController.getCycleTime().convert(millisecond),
+						 static_cast<unsigned>(rollerController.getLatency()));
+
+		// change brain color while a motor is too hot and being backed off
+		if (healthMonitor.isDerating())
 		{
 			pros::lcd::set_background_color(255,0,0);
 		}
 
-		// angle changer
-		if (angleChange.changedToPressed()){
-			angled = !angled;
-			pros::lcd::set_text(7,"sdfsd");
-			AngleChanger.set_value(angled);
-		}
-
 		// print flywheel speed
-		pros::lcd::set_text(6,std::to_string(flywheel.getActualVelocity()));
-		pros::lcd::set_text(5,std::to_string(target));
+		pros::lcd::print(6, "%.0f rpm %.1f shots/s", shotSequencer.getVelocity(), shotSequencer.getShotsPerSecond());
+		pros::lcd::print(5, "%.0f %.0fin %s", driverControl.getFlywheelTarget(),
+						 flywheelTargeter.getDistance().convert(inch), shotSequencer.isReady() ? "ready" : "");
 
-		// print intake temperature
-		pros::lcd::set_text(4,std::to_string(intake.getTemperature()));
+		// print the motor closest to overheating
+		const std::size_t worst = healthMonitor.getWorst();
+		const MotorHealth worstHealth = healthMonitor.getHealth(worst);
+		pros::lcd::print(4, "%s %.0fC %.0fs %.0f%%", healthMonitor.getName(worst).c_str(),
+						 worstHealth.temperature, worstHealth.timeToLimit, worstHealth.scale * 100);
 
 		// wait to give time for the processor to do other tasks
+		busy.finish();
 		pros::delay(20);
 	}
 }
@@ -0,0 +1,12 @@
+#include "routines.h"
+
+using namespace okapi::literals;
+
+void squareRoutine(spooder::MotionQueue &queue)
+{
+	for (size_t i = 0; i < 4; i++)
+	{
+		queue.driveDistance(12_in).turnAngle(90_deg);
+	}
+	queue.run();
+}
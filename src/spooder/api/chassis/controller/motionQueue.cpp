@@ -0,0 +1,249 @@
+#include "spooder/api/chassis/controller/motionQueue.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace spooder {
+MotionQueue::MotionQueue(const okapi::TimeUtil &itimeUtil,
+                         std::shared_ptr<okapi::OdomChassisController> ichassis,
+                         const Gains &igains,
+                         std::shared_ptr<okapi::Logger> ilogger)
+  : timeUtil(itimeUtil), chassis(std::move(ichassis)), gains(igains), logger(std::move(ilogger)) {
+}
+
+MotionQueue &MotionQueue::driveDistance(const okapi::QLength idistance,
+                                        const std::optional<okapi::QLength> iexitRadius) {
+  Target target;
+  target.type = TargetType::distance;
+  target.distance = idistance;
+  target.exitRadius = iexitRadius;
+  targets.push_back(target);
+  return *this;
+}
+
+MotionQueue &MotionQueue::driveToPoint(const okapi::Point &ipoint,
+                                       const bool ibackwards,
+                                       const std::optional<okapi::QLength> iexitRadius) {
+  Target target;
+  target.type = TargetType::point;
+  target.point = ipoint;
+  target.backwards = ibackwards;
+  target.exitRadius = iexitRadius;
+  targets.push_back(target);
+  return *this;
+}
+
+MotionQueue &MotionQueue::turnAngle(const okapi::QAngle iangle,
+                                    const std::optional<okapi::QAngle> iexitAngle) {
+  Target target;
+  target.type = TargetType::relativeAngle;
+  target.angle = iangle;
+  target.exitAngle = iexitAngle;
+  targets.push_back(target);
+  return *this;
+}
+
+MotionQueue &MotionQueue::turnToAngle(const okapi::QAngle iangle,
+                                      const std::optional<okapi::QAngle> iexitAngle) {
+  Target target;
+  target.type = TargetType::absoluteAngle;
+  target.angle = iangle;
+  target.exitAngle = iexitAngle;
+  targets.push_back(target);
+  return *this;
+}
+
+void MotionQueue::run() {
+  using namespace okapi;
+
+  if (targets.empty()) {
+    return;
+  }
+
+  const auto segments = resolve(chassis->getState());
+  targets.clear();
+  settled.clear();
+
+  // Stop whatever the chassis controller was doing so its controllers do not fight the queue
+  chassis->stop();
+  const auto model = chassis->getModel();
+  const auto rate = timeUtil.getRate();
+  const auto timer = timeUtil.getTimer();
+
+  const QTime period = 10_ms;
+  const double maxStep = gains.slewRate * period.convert(second);
+  double forward = 0;
+  double turn = 0;
+  const QTime start = timer->millis();
+  bool reached = false; // whether the last target settled rather than timed out
+
+  for (std::size_t i = 0; i < segments.size(); i++) {
+    const auto &segment = segments[i];
+    const bool last = i + 1 == segments.size();
+    const QTime segmentStart = timer->millis();
+    std::optional<QTime> settledSince;
+
+    while (true) {
+      const auto state = chassis->getState();
+      double forwardTarget = 0;
+      double turnTarget = 0;
+      bool inside;
+
+      if (segment.turn) {
+        const QAngle error = wrap(segment.heading - state.theta);
+        turnTarget = gains.angleKp * error.convert(degree);
+        inside = abs(error) < (last ? gains.settleAngle : segment.exitAngle);
+      } else {
+        const double dx = (segment.x - state.x).convert(inch);
+        const double dy = (segment.y - state.y).convert(inch);
+        const double distance = std::hypot(dx, dy);
+
+        QAngle bearing = std::atan2(dy, dx) * radian;
+        if (segment.backwards) {
+          bearing += 180_deg;
+        }
+        const QAngle error = wrap(bearing - state.theta);
+
+        // Drive at the speed that would stop at the end of the straight line this segment starts,
+        // so the robot keeps its speed into the next segment instead of slowing to each target
+        const double along = distance * std::cos(error.convert(radian));
+        forwardTarget = gains.distanceKp * (along + segment.carry.convert(inch));
+        if (segment.backwards) {
+          forwardTarget = -forwardTarget;
+        }
+
+        // The bearing swings wildly right next to the target, so only steer from further out
+        if (distance > gains.exitRadius.convert(inch)) {
+          turnTarget = gains.angleKp * error.convert(degree);
+        }
+
+        inside = distance < (last ? gains.settleRadius : segment.exitRadius).convert(inch);
+      }
+
+      const QTime now = timer->millis();
+      if (inside && !last) {
+        break;
+      } else if (inside) {
+        if (!settledSince) {
+          settledSince = now;
+        } else if (now - *settledSince >= gains.settleTime) {
+          reached = true;
+          break;
+        }
+      } else {
+        settledSince.reset();
+      }
+
+      if (now - segmentStart >= gains.segmentTimeout) {
+        LOG_WARN("MotionQueue: Target " + std::to_string(i) + " timed out");
+        break;
+      }
+
+      forwardTarget = std::clamp(forwardTarget, -gains.maxForward, gains.maxForward);
+      turnTarget = std::clamp(turnTarget, -gains.maxTurn, gains.maxTurn);
+      forward += std::clamp(forwardTarget - forward, -maxStep, maxStep);
+      turn += std::clamp(turnTarget - turn, -maxStep, maxStep);
+      model->driveVector(forward, turn);
+
+      rate->delayUntil(period);
+    }
+
+    const double elapsed = (timer->millis() - segmentStart).convert(millisecond);
+    LOG_INFO("MotionQueue: Left target " + std::to_string(i) + " after " +
+             std::to_string(elapsed) + " ms");
+  }
+
+  model->stop();
+  if (reached) {
+    settled.set();
+  }
+  const double elapsed = (timer->millis() - start).convert(millisecond);
+  LOG_INFO("MotionQueue: Finished " + std::to_string(segments.size()) + " targets in " +
+           std::to_string(elapsed) + " ms");
+}
+
+SettleEvent &MotionQueue::getSettleEvent() {
+  return settled;
+}
+
+void MotionQueue::clear() {
+  targets.clear();
+}
+
+std::size_t MotionQueue::size() const {
+  return targets.size();
+}
+
+std::vector<MotionQueue::Segment> MotionQueue::resolve(const okapi::OdomState &istart) const {
+  using namespace okapi;
+
+  std::vector<Segment> segments;
+  segments.reserve(targets.size());
+
+  QLength x = istart.x;
+  QLength y = istart.y;
+  QAngle heading = istart.theta;
+
+  for (const auto &target : targets) {
+    Segment segment;
+
+    switch (target.type) {
+    case TargetType::distance:
+      x += target.distance * std::cos(heading.convert(radian));
+      y += target.distance * std::sin(heading.convert(radian));
+      segment.backwards = target.distance < 0_m;
+      segment.length = abs(target.distance);
+      break;
+
+    case TargetType::point: {
+      const double dx = (target.point.x - x).convert(meter);
+      const double dy = (target.point.y - y).convert(meter);
+      segment.length = std::hypot(dx, dy) * meter;
+      if (segment.length > 0_m) {
+        heading = std::atan2(dy, dx) * radian + (target.backwards ? 180_deg : 0_deg);
+      }
+      x = target.point.x;
+      y = target.point.y;
+      segment.backwards = target.backwards;
+      break;
+    }
+
+    case TargetType::relativeAngle:
+      heading = wrap(heading + target.angle);
+      segment.turn = true;
+      break;
+
+    case TargetType::absoluteAngle:
+      heading = wrap(target.angle);
+      segment.turn = true;
+      break;
+    }
+
+    segment.x = x;
+    segment.y = y;
+    segment.heading = heading;
+    segment.exitRadius = target.exitRadius.value_or(gains.exitRadius);
+    segment.exitAngle = target.exitAngle.value_or(gains.exitAngle);
+    segments.push_back(segment);
+  }
+
+  // A drive carries its speed into the drives after it, up to the next turn or the last target.
+  // Less speed carries through a corner the sharper it is, and none through a reversal.
+  for (std::size_t i = segments.size(); i-- > 1;) {
+    auto &segment = segments[i - 1];
+    const auto &next = segments[i];
+    if (segment.turn || next.turn) {
+      continue;
+    }
+
+    const QAngle corner = next.heading + (next.backwards ? 180_deg : 0_deg) - segment.heading -
+                          (segment.backwards ? 180_deg : 0_deg);
+    segment.carry = std::max(0.0, std::cos(corner.convert(radian))) * (next.length + next.carry);
+  }
+
+  return segments;
+}
+
+okapi::QAngle MotionQueue::wrap(const okapi::QAngle iangle) {
+  return std::remainder(iangle.convert(okapi::degree), 360) * okapi::degree;
+}
+} // namespace spooder
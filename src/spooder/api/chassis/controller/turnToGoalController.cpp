@@ -0,0 +1,93 @@
+#include "spooder/api/chassis/controller/turnToGoalController.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace spooder {
+TurnToGoalController::TurnToGoalController(const okapi::TimeUtil &itimeUtil,
+                                           std::shared_ptr<okapi::ChassisModel> imodel,
+                                           std::shared_ptr<GoalTracker> itracker,
+                                           const Gains &igains,
+                                           std::shared_ptr<okapi::Logger> ilogger)
+  : timeUtil(itimeUtil),
+    timer(itimeUtil.getTimer()),
+    model(std::move(imodel)),
+    tracker(std::move(itracker)),
+    gains(igains),
+    logger(std::move(ilogger)) {
+}
+
+double TurnToGoalController::step() {
+  using namespace okapi;
+
+  const QTime now = timer->millis();
+  if (!tracker->hasGoal()) {
+    reset();
+    return 0;
+  }
+
+  const double error = tracker->getHeadingError().convert(degree);
+  const bool inside = std::abs(error) < gains.settleAngle.convert(degree);
+
+  double rate = 0;
+  if (lastStep && now > *lastStep) {
+    rate = (error - lastError) / (now - *lastStep).convert(second);
+  }
+  lastStep = now;
+  lastError = error;
+
+  if (inside) {
+    if (!settledSince) {
+      settledSince = now;
+    }
+    settled = now - *settledSince >= gains.settleTime;
+  } else {
+    settledSince.reset();
+    settled = false;
+  }
+
+  double turn = gains.kP * error + gains.kD * rate;
+  if (!inside) {
+    // Never less than what it takes to get the robot moving, or it stalls short of the goal
+    turn = std::copysign(std::max(std::abs(turn), gains.minTurn), error);
+  }
+  turn = std::clamp(turn, -gains.maxTurn, gains.maxTurn);
+
+  model->rotate(turn);
+  return turn;
+}
+
+bool TurnToGoalController::isSettled() const {
+  return settled;
+}
+
+void TurnToGoalController::reset() {
+  model->stop();
+  lastStep.reset();
+  settledSince.reset();
+  settled = false;
+}
+
+bool TurnToGoalController::turnToGoal(const okapi::QTime itimeout) {
+  using namespace okapi;
+
+  reset();
+  const auto rate = timeUtil.getRate();
+  const QTime start = timer->millis();
+
+  while (!settled && timer->millis() - start < itimeout) {
+    step();
+    rate->delayUntil(10_ms);
+  }
+
+  const bool aimed = settled;
+  reset();
+
+  const double elapsed = (timer->millis() - start).convert(millisecond);
+  if (aimed) {
+    LOG_INFO("TurnToGoalController: Aimed in " + std::to_string(elapsed) + " ms");
+  } else {
+    LOG_WARN("TurnToGoalController: Timed out after " + std::to_string(elapsed) + " ms");
+  }
+  return aimed;
+}
+} // namespace spooder
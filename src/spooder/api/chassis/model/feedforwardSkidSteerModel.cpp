@@ -0,0 +1,126 @@
+#include "spooder/api/chassis/model/feedforwardSkidSteerModel.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace spooder {
+FeedforwardSkidSteerModel::Side::Side(const SimpleMotorFeedforward &ifeedforward,
+                                      const VelocityTrimGains &itrim)
+  : controller(ifeedforward, itrim) {
+}
+
+FeedforwardSkidSteerModel::FeedforwardSkidSteerModel(
+  std::shared_ptr<okapi::AbstractMotor> ileftSideMotor,
+  std::shared_ptr<okapi::AbstractMotor> irightSideMotor,
+  std::shared_ptr<okapi::ContinuousRotarySensor> ileftEnc,
+  std::shared_ptr<okapi::ContinuousRotarySensor> irightEnc,
+  const double imaxVelocity,
+  const double imaxVoltage,
+  const SimpleMotorFeedforward &ileftFeedforward,
+  const SimpleMotorFeedforward &irightFeedforward,
+  const VelocityTrimGains &itrim,
+  const okapi::TimeUtil &itimeUtil)
+  : okapi::SkidSteerModel(std::move(ileftSideMotor),
+                          std::move(irightSideMotor),
+                          std::move(ileftEnc),
+                          std::move(irightEnc),
+                          imaxVelocity,
+                          imaxVoltage),
+    timer(itimeUtil.getTimer()),
+    leftSide(ileftFeedforward, itrim),
+    rightSide(irightFeedforward, itrim) {
+}
+
+void FeedforwardSkidSteerModel::forward(const double ispeed) {
+  const double speed = std::clamp(ispeed, -1.0, 1.0);
+  drive(leftSide, *leftSideMotor, speed);
+  drive(rightSide, *rightSideMotor, speed);
+}
+
+void FeedforwardSkidSteerModel::driveVector(const double iySpeed, const double izRotation) {
+  // Same mixing as SkidSteerModel::driveVector
+  const double forwardSpeed = std::clamp(iySpeed, -1.0, 1.0);
+  const double yaw = std::clamp(izRotation, -1.0, 1.0);
+
+  double leftOutput = forwardSpeed + yaw;
+  double rightOutput = forwardSpeed - yaw;
+  if (const double maxInputMag = std::max(std::abs(leftOutput), std::abs(rightOutput));
+      maxInputMag > 1) {
+    leftOutput /= maxInputMag;
+    rightOutput /= maxInputMag;
+  }
+
+  drive(leftSide, *leftSideMotor, leftOutput);
+  drive(rightSide, *rightSideMotor, rightOutput);
+}
+
+void FeedforwardSkidSteerModel::rotate(const double ispeed) {
+  const double speed = std::clamp(ispeed, -1.0, 1.0);
+  drive(leftSide, *leftSideMotor, speed);
+  drive(rightSide, *rightSideMotor, -1 * speed);
+}
+
+void FeedforwardSkidSteerModel::stop() {
+  for (auto *side : {&leftSide, &rightSide}) {
+    side->controller.reset();
+    side->velocity = 0;
+    side->acceleration = 0;
+    side->active = false;
+  }
+
+  okapi::SkidSteerModel::stop();
+}
+
+void FeedforwardSkidSteerModel::left(const double ispeed) {
+  drive(leftSide, *leftSideMotor, ispeed);
+}
+
+void FeedforwardSkidSteerModel::right(const double ispeed) {
+  drive(rightSide, *rightSideMotor, ispeed);
+}
+
+void FeedforwardSkidSteerModel::setVelocity(const double ileftVelocity,
+                                            const double ileftAcceleration,
+                                            const double irightVelocity,
+                                            const double irightAcceleration) {
+  drive(leftSide, *leftSideMotor, ileftVelocity, ileftAcceleration);
+  drive(rightSide, *rightSideMotor, irightVelocity, irightAcceleration);
+}
+
+void FeedforwardSkidSteerModel::drive(Side &iside,
+                                      okapi::AbstractMotor &imotor,
+                                      const double ispeed) {
+  using namespace okapi;
+
+  const double velocity = std::clamp(ispeed, -1.0, 1.0) * maxVelocity;
+  const double dt = (timer->millis() - iside.time).convert(second);
+
+  double acceleration = 0;
+  if (iside.active && dt <= maxCommandPeriod) {
+    // Commands in the same millisecond keep the last acceleration instead of dividing by zero
+    acceleration = (dt > 0) ? (velocity - iside.velocity) / dt : iside.acceleration;
+  }
+
+  drive(iside, imotor, velocity, acceleration);
+}
+
+void FeedforwardSkidSteerModel::drive(Side &iside,
+                                      okapi::AbstractMotor &imotor,
+                                      const double ivelocity,
+                                      const double iacceleration) {
+  using namespace okapi;
+
+  const QTime now = timer->millis();
+  const double dt =
+    iside.active ? std::min((now - iside.time).convert(second), maxCommandPeriod) : 0;
+
+  const double volts =
+    iside.controller.step(ivelocity, iacceleration, imotor.getActualVelocity(), dt);
+  imotor.moveVoltage(
+    static_cast<std::int16_t>(std::clamp(volts * 1000, -1 * maxVoltage, maxVoltage)));
+
+  iside.velocity = ivelocity;
+  iside.acceleration = iacceleration;
+  iside.time = now;
+  iside.active = true;
+}
+} // namespace spooder
@@ -0,0 +1,81 @@
+#include "spooder/api/command/command.hpp"
+
+namespace spooder {
+Command::Command(std::string iname) : name(std::move(iname)) {
+}
+
+bool Command::step(const okapi::QTime inow) {
+  if (state == State::finished) {
+    return true;
+  }
+
+  now = inow;
+  if (state == State::idle) {
+    state = State::running;
+    startTime = inow;
+    initialize();
+  }
+
+  execute();
+  if (!isFinished()) {
+    return false;
+  }
+
+  state = State::finished;
+  endTime = inow;
+  end(false);
+  return true;
+}
+
+void Command::cancel(const okapi::QTime inow) {
+  if (state != State::running) {
+    return;
+  }
+
+  now = inow;
+  state = State::finished;
+  interrupted = true;
+  endTime = inow;
+  end(true);
+}
+
+bool Command::isRunning() const {
+  return state == State::running;
+}
+
+bool Command::hasFinished() const {
+  return state == State::finished;
+}
+
+const std::string &Command::getName() const {
+  return name;
+}
+
+void Command::getTimings(std::vector<CommandTiming> &otimings, const std::size_t idepth) const {
+  CommandTiming timing;
+  timing.name = name;
+  timing.depth = idepth;
+  timing.ran = state != State::idle;
+  timing.interrupted = interrupted;
+  timing.start = startTime;
+  timing.end = state == State::finished ? endTime : now;
+  otimings.push_back(timing);
+}
+
+void Command::initialize() {
+}
+
+void Command::execute() {
+}
+
+void Command::end(bool) {
+}
+
+okapi::QTime Command::getElapsed() const {
+  return now - startTime;
+}
+
+okapi::QTime Command::getTime() const {
+  return now;
+}
+} // namespace spooder
@@ -0,0 +1,88 @@
+#include "spooder/api/command/commandGroup.hpp"
+
+namespace spooder {
+SequentialCommand::SequentialCommand(std::vector<CommandPtr> icommands, std::string iname)
+  : Command(std::move(iname)), commands(std::move(icommands)) {
+}
+
+void SequentialCommand::execute() {
+  while (index < commands.size() && commands[index]->step(getTime())) {
+    index++;
+  }
+}
+
+bool SequentialCommand::isFinished() {
+  return index >= commands.size();
+}
+
+void SequentialCommand::end(const bool iinterrupted) {
+  if (iinterrupted && index < commands.size()) {
+    commands[index]->cancel(getTime());
+  }
+}
+
+void SequentialCommand::getTimings(std::vector<CommandTiming> &otimings,
+                                   const std::size_t idepth) const {
+  Command::getTimings(otimings, idepth);
+  for (const auto &command : commands) {
+    command->getTimings(otimings, idepth + 1);
+  }
+}
+
+ParallelCommand::ParallelCommand(std::vector<CommandPtr> icommands, std::string iname)
+  : Command(std::move(iname)), commands(std::move(icommands)) {
+}
+
+void ParallelCommand::execute() {
+  for (auto &command : commands) {
+    command->step(getTime());
+  }
+}
+
+bool ParallelCommand::isFinished() {
+  for (const auto &command : commands) {
+    if (!command->hasFinished()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ParallelCommand::end(const bool iinterrupted) {
+  if (iinterrupted) {
+    for (auto &command : commands) {
+      command->cancel(getTime());
+    }
+  }
+}
+
+void ParallelCommand::getTimings(std::vector<CommandTiming> &otimings,
+                                 const std::size_t idepth) const {
+  Command::getTimings(otimings, idepth);
+  for (const auto &command : commands) {
+    command->getTimings(otimings, idepth + 1);
+  }
+}
+
+TimeoutCommand::TimeoutCommand(CommandPtr icommand, const okapi::QTime itimeout)
+  : Command(icommand->getName()), command(std::move(icommand)), timeout(itimeout) {
+}
+
+void TimeoutCommand::execute() {
+  command->step(getTime());
+}
+
+bool TimeoutCommand::isFinished() {
+  return command->hasFinished() || getElapsed() >= timeout;
+}
+
+void TimeoutCommand::end(const bool) {
+  // Cancels the command if it timed out, and does nothing if it finished
+  command->cancel(getTime());
+}
+
+void TimeoutCommand::getTimings(std::vector<CommandTiming> &otimings,
+                                const std::size_t idepth) const {
+  command->getTimings(otimings, idepth);
+}
+} // namespace spooder
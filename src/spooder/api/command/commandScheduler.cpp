@@ -0,0 +1,75 @@
+#include "spooder/api/command/commandScheduler.hpp"
+
+namespace spooder {
+CommandScheduler::CommandScheduler(const okapi::TimeUtil &itimeUtil,
+                                   const okapi::QTime iperiod,
+                                   std::shared_ptr<Telemetry> itelemetry,
+                                   std::shared_ptr<okapi::Logger> ilogger)
+  : timeUtil(itimeUtil),
+    period(iperiod),
+    telemetry(std::move(itelemetry)),
+    logger(std::move(ilogger)) {
+}
+
+okapi::QTime CommandScheduler::run(Command &icommand) {
+  const auto timer = timeUtil.getTimer();
+  const auto rate = timeUtil.getRate();
+  overruns = 0;
+
+  // Commands see time relative to the start of the run, so their timings are too
+  const okapi::QTime start = timer->millis();
+  while (true) {
+    const okapi::QTime tickStart = timer->millis();
+    if (icommand.step(tickStart - start)) {
+      break;
+    }
+
+    if (timer->millis() - tickStart > period) {
+      overruns++;
+    }
+    rate->delayUntil(period);
+  }
+
+  const okapi::QTime length = timer->millis() - start;
+  timings.clear();
+  icommand.getTimings(timings);
+  report(length);
+  return length;
+}
+
+const std::vector<CommandTiming> &CommandScheduler::getTimings() const {
+  return timings;
+}
+
+std::size_t CommandScheduler::getOverruns() const {
+  return overruns;
+}
+
+void CommandScheduler::report(const okapi::QTime ilength) {
+  const auto lengthMs = ilength.convert(okapi::millisecond);
+  const auto overrunCount = overruns;
+  LOG_INFO("CommandScheduler: Ran for " + std::to_string(lengthMs) + " ms with " +
+           std::to_string(overrunCount) + " overruns");
+
+  for (const auto &timing : timings) {
+    if (!timing.ran) {
+      continue;
+    }
+
+    const double startMs = timing.start.convert(okapi::millisecond);
+    const double durationMs = (timing.end - timing.start).convert(okapi::millisecond);
+    const std::string line = std::string(2 * timing.depth, ' ') + timing.name + ": " +
+                             std::to_string(startMs) + " ms + " + std::to_string(durationMs) +
+                             " ms" + (timing.interrupted ? " (interrupted)" : "");
+    LOG_INFO("CommandScheduler: " + line);
+
+    telemetry->send("command",
+                    "%s,%zu,%.0f,%.0f,%d",
+                    timing.name.c_str(),
+                    timing.depth,
+                    startMs,
+                    durationMs,
+                    timing.interrupted);
+  }
+}
+} // namespace spooder
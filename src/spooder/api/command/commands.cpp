@@ -0,0 +1,115 @@
+#include "spooder/api/command/commands.hpp"
+#include <cmath>
+
+namespace spooder {
+InstantCommand::InstantCommand(std::string iname, std::function<void()> ifunction)
+  : Command(std::move(iname)), function(std::move(ifunction)) {
+}
+
+void InstantCommand::initialize() {
+  function();
+}
+
+bool InstantCommand::isFinished() {
+  return true;
+}
+
+WaitCommand::WaitCommand(const okapi::QTime itime)
+  : Command("wait " + std::to_string(std::lround(itime.convert(okapi::millisecond))) + " ms"),
+    time(itime) {
+}
+
+bool WaitCommand::isFinished() {
+  return getElapsed() >= time;
+}
+
+WaitUntilCommand::WaitUntilCommand(std::string iname, std::function<bool()> icondition)
+  : Command(std::move(iname)), condition(std::move(icondition)) {
+}
+
+bool WaitUntilCommand::isFinished() {
+  return condition();
+}
+
+DrivePathCommand::DrivePathCommand(
+  std::shared_ptr<okapi::AsyncMotionProfileController> icontroller,
+  std::string ipathId,
+  const bool ibackwards,
+  const bool imirrored)
+  : Command("path " + ipathId),
+    controller(std::move(icontroller)),
+    pathId(std::move(ipathId)),
+    backwards(ibackwards),
+    mirrored(imirrored) {
+}
+
+void DrivePathCommand::initialize() {
+  controller->setTarget(pathId, backwards, mirrored);
+}
+
+bool DrivePathCommand::isFinished() {
+  return controller->isSettled();
+}
+
+void DrivePathCommand::end(const bool iinterrupted) {
+  if (iinterrupted) {
+    controller->reset();
+  }
+}
+
+SpinToVelocityCommand::SpinToVelocityCommand(
+  std::shared_ptr<okapi::AbstractMotor> imotor,
+  const double ivelocity,
+  const double itolerance,
+  const okapi::QTime idwellTime,
+  std::shared_ptr<okapi::ControllerInput<double>> ivelocitySensor)
+  : Command("spin to " + std::to_string(std::lround(ivelocity)) + " rpm"),
+    motor(std::move(imotor)),
+    velocity(ivelocity),
+    tolerance(itolerance),
+    dwellTime(idwellTime),
+    velocitySensor(std::move(ivelocitySensor)) {
+}
+
+void SpinToVelocityCommand::initialize() {
+  motor->moveVelocity(static_cast<std::int16_t>(velocity));
+}
+
+bool SpinToVelocityCommand::isFinished() {
+  const double actual =
+    velocitySensor ? velocitySensor->controllerGet() : motor->getActualVelocity();
+
+  if (std::abs(actual - velocity) > tolerance) {
+    inBand = false;
+    return false;
+  }
+
+  if (!inBand) {
+    inBand = true;
+    inBandSince = getTime();
+  }
+  return getTime() - inBandSince >= dwellTime;
+}
+
+RunUntilCommand::RunUntilCommand(std::string iname,
+                                 std::shared_ptr<okapi::AbstractMotor> imotor,
+                                 const std::int16_t ivoltage,
+                                 std::function<bool()> icondition)
+  : Command(std::move(iname)),
+    motor(std::move(imotor)),
+    voltage(ivoltage),
+    condition(std::move(icondition)) {
+}
+
+void RunUntilCommand::initialize() {
+  motor->moveVoltage(voltage);
+}
+
+bool RunUntilCommand::isFinished() {
+  return condition();
+}
+
+void RunUntilCommand::end(bool) {
+  motor->moveVoltage(0);
+}
+} // namespace spooder
@@ -0,0 +1,145 @@
+#include "spooder/api/command/routine.hpp"
+#include <algorithm>
+#include <optional>
+
+namespace spooder {
+Routine::Routine(std::string iname) : name(std::move(iname)) {
+}
+
+bool Routine::isFinished() const {
+  return wait == Wait::finished;
+}
+
+const std::string &Routine::getName() const {
+  return name;
+}
+
+okapi::QTime Routine::getTime() const {
+  return now;
+}
+
+void Routine::awaitDelay(const okapi::QTime itime) {
+  wait = Wait::delay;
+  deadline = now + itime;
+}
+
+void Routine::awaitEvent(SettleEvent &ievent) {
+  wait = Wait::event;
+  event = &ievent;
+  event->setListener(wake);
+}
+
+void Routine::awaitCondition(std::function<bool()> icondition) {
+  wait = Wait::condition;
+  condition = std::move(icondition);
+}
+
+bool Routine::isReady(const okapi::QTime inow) const {
+  switch (wait) {
+  case Wait::start:
+    return true;
+  case Wait::delay:
+    return inow >= deadline;
+  case Wait::event:
+    return event->isSet();
+  case Wait::condition:
+    return condition();
+  case Wait::finished:
+    return false;
+  }
+  return false;
+}
+
+void Routine::resume(const okapi::QTime inow) {
+  if (wait == Wait::event) {
+    event->setListener(nullptr);
+    event = nullptr;
+  }
+  condition = nullptr;
+  now = inow;
+
+  // If the body returns without awaiting anything, it has reached its end
+  wait = Wait::finished;
+  body();
+}
+
+RoutineRunner::RoutineRunner(std::unique_ptr<okapi::AbstractTimer> itimer,
+                             const okapi::QTime ipollPeriod,
+                             std::shared_ptr<okapi::Logger> ilogger)
+  : timer(std::move(itimer)), pollPeriod(ipollPeriod), logger(std::move(ilogger)) {
+}
+
+void RoutineRunner::add(Routine &iroutine) {
+  iroutine.wake = &wake;
+  routines.push_back(&iroutine);
+}
+
+okapi::QTime RoutineRunner::run() {
+  using namespace okapi;
+
+  wakeups = 0;
+  const QTime start = timer->millis();
+
+  while (true) {
+    // Clear before checking, so an event set during the checks still wakes the next sleep
+    wake.clear();
+
+    bool resumed = false;
+    bool running = false;
+    bool polling = false;
+    std::optional<QTime> nextDeadline;
+
+    for (auto *routine : routines) {
+      const QTime now = timer->millis() - start;
+      if (routine->isReady(now)) {
+        routine->resume(now);
+        resumed = true;
+
+        if (routine->isFinished()) {
+          const double ms = now.convert(millisecond);
+          LOG_INFO("RoutineRunner: " + routine->getName() + " finished at " + std::to_string(ms) +
+                   " ms");
+        }
+      }
+
+      if (routine->isFinished()) {
+        continue;
+      }
+
+      running = true;
+      if (routine->wait == Routine::Wait::delay) {
+        nextDeadline = std::min(nextDeadline.value_or(routine->deadline), routine->deadline);
+      } else if (routine->wait == Routine::Wait::condition) {
+        polling = true;
+      }
+    }
+
+    if (!running) {
+      break;
+    }
+
+    // A routine that just ran may have changed what another one is waiting on
+    if (resumed) {
+      continue;
+    }
+
+    const QTime now = timer->millis() - start;
+    if (nextDeadline || polling) {
+      QTime timeout = nextDeadline ? *nextDeadline - now : pollPeriod;
+      if (polling) {
+        timeout = std::min(timeout, pollPeriod);
+      }
+      wake.wait(timeout);
+    } else {
+      wake.wait();
+    }
+    wakeups++;
+  }
+
+  return timer->millis() - start;
+}
+
+std::size_t RoutineRunner::getWakeups() const {
+  return wakeups;
+}
+} // namespace spooder
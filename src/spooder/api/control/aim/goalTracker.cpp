@@ -0,0 +1,128 @@
+#include "spooder/api/control/aim/goalTracker.hpp"
+#include "okapi/api/odometry/odomMath.hpp"
+#include <cmath>
+
+namespace spooder {
+GoalTracker::GoalTracker(std::shared_ptr<AbstractGoalCamera> icamera,
+                         std::shared_ptr<okapi::Odometry> iodometry,
+                         const okapi::TimeUtil &itimeUtil,
+                         const GoalTrackerParams &iparams,
+                         std::shared_ptr<Telemetry> itelemetry,
+                         std::shared_ptr<okapi::Logger> ilogger)
+  : camera(std::move(icamera)),
+    odometry(std::move(iodometry)),
+    timer(itimeUtil.getTimer()),
+    params(iparams),
+    telemetry(std::move(itelemetry)),
+    logger(std::move(ilogger)),
+    focalLength(iparams.imageWidth / 2 /
+                std::tan(iparams.fieldOfView.convert(okapi::radian) / 2)) {
+}
+
+GoalTracker::~GoalTracker() {
+  dtorCalled.store(true, std::memory_order_release);
+  delete task;
+}
+
+void GoalTracker::step() {
+  std::scoped_lock lock(mutex);
+  const okapi::QTime now = timer->millis();
+  const okapi::OdomState state = odometry->getState();
+  history.record(now, state);
+
+  const std::size_t count = camera->getGoals(detections.data(), detections.size());
+  const okapi::QAngle heading = history.getAt(now - params.latency).value_or(state).theta;
+
+  // Pick the object closest to the track, or the largest if there is no track
+  bool found = false;
+  okapi::QAngle best{0 * okapi::degree};
+  okapi::QAngle bestOffset = params.gate;
+  for (std::size_t i = 0; i < count; i++) {
+    const auto &detection = detections[i];
+    if (detection.width * detection.height < params.minArea) {
+      continue;
+    }
+
+    const okapi::QAngle objectBearing =
+      heading + params.mountYaw + std::atan2(detection.x, focalLength) * okapi::radian;
+    if (!tracking) {
+      best = objectBearing;
+      found = true;
+      break;
+    }
+
+    const okapi::QAngle offset =
+      okapi::abs(okapi::OdomMath::constrainAngle180(objectBearing - bearing));
+    if (offset <= bestOffset) {
+      best = objectBearing;
+      bestOffset = offset;
+      found = true;
+    }
+  }
+
+  if (found) {
+    if (!tracking) {
+      bearing = best;
+      tracking = true;
+      const double degrees = bearing.convert(okapi::degree);
+      LOG_INFO("GoalTracker: Acquired the goal at " + std::to_string(degrees) + " deg");
+    } else {
+      bearing += params.filterGain * okapi::OdomMath::constrainAngle180(best - bearing);
+    }
+    missed = 0;
+  } else if (tracking && ++missed > params.maxMissed) {
+    tracking = false;
+    LOG_INFO_S("GoalTracker: Lost the goal");
+  }
+
+  headingError = okapi::OdomMath::constrainAngle180(bearing - state.theta);
+
+  telemetry->send("vision",
+                  "%zu,%.1f,%.1f,%d",
+                  count,
+                  bearing.convert(okapi::degree),
+                  headingError.convert(okapi::degree),
+                  tracking ? 1 : 0);
+}
+
+bool GoalTracker::hasGoal() const {
+  std::scoped_lock lock(mutex);
+  return tracking;
+}
+
+okapi::QAngle GoalTracker::getBearing() const {
+  std::scoped_lock lock(mutex);
+  return bearing;
+}
+
+okapi::QAngle GoalTracker::getHeadingError() const {
+  std::scoped_lock lock(mutex);
+  return headingError;
+}
+
+void GoalTracker::startThread(std::unique_ptr<okapi::AbstractRate> irate,
+                              const okapi::QTime iperiod) {
+  if (!task) {
+    rate = std::move(irate);
+    threadPeriod = iperiod;
+    task = new CrossplatformThread(trampoline, this, "GoalTracker");
+  }
+}
+
+CrossplatformThread *GoalTracker::getThread() const {
+  return task;
+}
+
+void GoalTracker::trampoline(void *context) {
+  if (context) {
+    static_cast<GoalTracker *>(context)->loop();
+  }
+}
+
+void GoalTracker::loop() {
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    step();
+    rate->delayUntil(threadPeriod);
+  }
+}
+} // namespace spooder
@@ -0,0 +1,38 @@
+#include "spooder/api/control/feedforward/feedforwardVelocityController.hpp"
+#include <algorithm>
+
+namespace spooder {
+FeedforwardVelocityController::FeedforwardVelocityController(
+  const SimpleMotorFeedforward &ifeedforward,
+  const VelocityTrimGains &itrim,
+  const double imaxVoltage)
+  : feedforward(ifeedforward), trim(itrim), maxVoltage(imaxVoltage) {
+}
+
+double FeedforwardVelocityController::step(const double ivelocity,
+                                           const double iacceleration,
+                                           const double imeasured,
+                                           const double idt) {
+  const double error = ivelocity - imeasured;
+
+  if (ivelocity == 0 && iacceleration == 0) {
+    // Holding still is the brake's job; an integral left over from moving would creep the robot
+    integral = 0;
+  } else if (trim.kI != 0) {
+    integral =
+      std::clamp(integral + trim.kI * error * idt, -trim.integralLimit, trim.integralLimit);
+  }
+
+  const double output =
+    feedforward.calculate(ivelocity, iacceleration) + trim.kP * error + integral;
+  return std::clamp(output, -maxVoltage, maxVoltage);
+}
+
+void FeedforwardVelocityController::reset() {
+  integral = 0;
+}
+
+const SimpleMotorFeedforward &FeedforwardVelocityController::getFeedforward() const {
+  return feedforward;
+}
+} // namespace spooder
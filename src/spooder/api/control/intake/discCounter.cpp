@@ -0,0 +1,123 @@
+#include "spooder/api/control/intake/discCounter.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace spooder {
+DiscCounter::DiscCounter(std::shared_ptr<okapi::ControllerInput<double>> isensor,
+                         std::function<int()> idirection,
+                         const okapi::TimeUtil &itimeUtil,
+                         const DiscCounterParams &iparams,
+                         std::shared_ptr<Telemetry> itelemetry,
+                         std::shared_ptr<okapi::Logger> ilogger)
+  : sensor(std::move(isensor)),
+    direction(std::move(idirection)),
+    timer(itimeUtil.getTimer()),
+    params(iparams),
+    telemetry(std::move(itelemetry)),
+    logger(std::move(ilogger)) {
+}
+
+DiscCounter::~DiscCounter() {
+  dtorCalled.store(true, std::memory_order_release);
+  delete task;
+}
+
+void DiscCounter::step() {
+  const double distance = sensor->controllerGet();
+  if (!std::isfinite(distance) || distance >= okapi::OKAPI_PROS_ERR) {
+    return;
+  }
+
+  std::scoped_lock lock(mutex);
+  const okapi::QTime now = timer->millis();
+
+  if (!present) {
+    if (distance >= params.enterBelow) {
+      closeSamples = 0;
+      return;
+    }
+
+    if (closeSamples++ == 0) {
+      arrived = now;
+      arrivedDirection = direction();
+    }
+    present = closeSamples >= params.enterSamples;
+    return;
+  }
+
+  if (distance <= params.exitAbove) {
+    return;
+  }
+
+  // The disc has gone past, in whichever way the intake is moving it
+  present = false;
+  closeSamples = 0;
+  int way = direction();
+  if (way == 0) {
+    way = arrivedDirection;
+  }
+  count = std::max(count + way, 0);
+
+  telemetry->send("disc",
+                  "%d,%d,%ld",
+                  count,
+                  way,
+                  static_cast<long>((now - arrived).convert(okapi::millisecond)));
+
+  if (way > 0 && count > params.capacity) {
+    const int held = count;
+    LOG_WARN("DiscCounter: Holding " + std::to_string(held) + " discs");
+  }
+}
+
+void DiscCounter::remove(const int icount) {
+  std::scoped_lock lock(mutex);
+  count = std::max(count - icount, 0);
+}
+
+void DiscCounter::setCount(const int icount) {
+  std::scoped_lock lock(mutex);
+  count = std::max(icount, 0);
+}
+
+int DiscCounter::getCount() const {
+  std::scoped_lock lock(mutex);
+  return count;
+}
+
+bool DiscCounter::isFull() const {
+  std::scoped_lock lock(mutex);
+  return count >= params.capacity;
+}
+
+bool DiscCounter::isDiscPresent() const {
+  std::scoped_lock lock(mutex);
+  return present;
+}
+
+void DiscCounter::startThread(std::unique_ptr<okapi::AbstractRate> irate,
+                              const okapi::QTime iperiod) {
+  if (!task) {
+    rate = std::move(irate);
+    threadPeriod = iperiod;
+    task = new CrossplatformThread(trampoline, this, "DiscCounter");
+  }
+}
+
+CrossplatformThread *DiscCounter::getThread() const {
+  return task;
+}
+
+void DiscCounter::trampoline(void *context) {
+  if (context) {
+    static_cast<DiscCounter *>(context)->loop();
+  }
+}
+
+void DiscCounter::loop() {
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    step();
+    rate->delayUntil(threadPeriod);
+  }
+}
+} // namespace spooder
@@ -0,0 +1,212 @@
+#include "spooder/api/control/intake/intakeController.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <cmath>
+#include <cstdlib>
+
+namespace spooder {
+IntakeController::IntakeController(std::shared_ptr<okapi::AbstractMotor> imotor,
+                                   const okapi::TimeUtil &itimeUtil,
+                                   const IntakeJamParams &iparams,
+                                   std::shared_ptr<Telemetry> itelemetry,
+                                   std::shared_ptr<okapi::Logger> ilogger)
+  : motor(std::move(imotor)),
+    timer(itimeUtil.getTimer()),
+    params(iparams),
+    telemetry(std::move(itelemetry)),
+    logger(std::move(ilogger)) {
+}
+
+IntakeController::~IntakeController() {
+  dtorCalled.store(true, std::memory_order_release);
+  delete task;
+}
+
+void IntakeController::setTarget(const std::int16_t ivoltage) {
+  std::scoped_lock lock(mutex);
+  if (ivoltage == target) {
+    return;
+  }
+
+  // A new command from the driver ends whatever the intake was doing about a jam
+  const okapi::QTime now = timer->millis();
+  endJam(now);
+  retries = 0;
+  target = ivoltage;
+
+  if (target == 0) {
+    state = State::stopped;
+  } else {
+    run(now);
+  }
+}
+
+void IntakeController::setParams(const IntakeJamParams &iparams) {
+  std::scoped_lock lock(mutex);
+  params = iparams;
+}
+
+void IntakeController::step() {
+  std::scoped_lock lock(mutex);
+  const okapi::QTime now = timer->millis();
+
+  switch (state) {
+  case State::stopped:
+  case State::jammed:
+    motor->moveVoltage(0);
+    return;
+
+  case State::reversing:
+    if (now - stateStart < params.reverseTime) {
+      motor->moveVoltage(static_cast<std::int16_t>(target > 0 ? -params.reverseVoltage
+                                                              : params.reverseVoltage));
+      return;
+    }
+    run(now);
+    break;
+
+  case State::running:
+    break;
+  }
+
+  motor->moveVoltage(target);
+
+  if (std::abs(target) < params.minVoltage || now - stateStart < params.spinUpTime) {
+    stalling = false;
+    return;
+  }
+
+  if (!isStalled()) {
+    stalling = false;
+    endJam(now);
+    if (retries > 0 && now - stateStart >= params.clearTime) {
+      retries = 0;
+    }
+    return;
+  }
+
+  if (!stalling) {
+    stalling = true;
+    stallStart = now;
+    return;
+  }
+
+  if (now - stallStart < params.stallTime) {
+    return;
+  }
+
+  if (!clearing) {
+    clearing = true;
+    jamStart = stallStart;
+  }
+  jamCount++;
+  retries++;
+  stalling = false;
+
+  const std::size_t count = jamCount;
+  const int retry = retries;
+  if (retries > params.maxRetries) {
+    LOG_WARN("IntakeController: Jam " + std::to_string(count) + " did not clear after " +
+             std::to_string(retry - 1) + " retries, stopping");
+    state = State::jammed;
+    motor->moveVoltage(0);
+    endJam(now);
+    return;
+  }
+
+  LOG_INFO("IntakeController: Jam " + std::to_string(count) + ", reversing (retry " +
+           std::to_string(retry) + ")");
+  state = State::reversing;
+  stateStart = now;
+  motor->moveVoltage(
+    static_cast<std::int16_t>(target > 0 ? -params.reverseVoltage : params.reverseVoltage));
+}
+
+bool IntakeController::isStalled() {
+  const double velocity = motor->getActualVelocity();
+  if (!std::isfinite(velocity) || std::abs(velocity) >= params.stallVelocity) {
+    return false;
+  }
+
+  const std::int32_t current = motor->getCurrentDraw();
+  const double torque = motor->getTorque();
+  return (current != okapi::OKAPI_PROS_ERR && current >= params.stallCurrent) ||
+         (std::isfinite(torque) && torque >= params.stallTorque) || motor->isOverCurrent() == 1;
+}
+
+void IntakeController::run(const okapi::QTime inow) {
+  state = State::running;
+  stateStart = inow;
+  stalling = false;
+}
+
+void IntakeController::endJam(const okapi::QTime inow) {
+  if (!clearing) {
+    return;
+  }
+
+  const okapi::QTime lost = inow - jamStart;
+  timeLost += lost;
+  clearing = false;
+
+  telemetry->send("jam",
+                  "%zu,%d,%ld",
+                  jamCount,
+                  retries,
+                  static_cast<long>(lost.convert(okapi::millisecond)));
+}
+
+IntakeController::State IntakeController::getState() const {
+  std::scoped_lock lock(mutex);
+  return state;
+}
+
+int IntakeController::getDirection() const {
+  std::scoped_lock lock(mutex);
+  switch (state) {
+  case State::running:
+    return target > 0 ? 1 : -1;
+  case State::reversing:
+    return target > 0 ? -1 : 1;
+  case State::stopped:
+  case State::jammed:
+    break;
+  }
+  return 0;
+}
+
+std::size_t IntakeController::getJamCount() const {
+  std::scoped_lock lock(mutex);
+  return jamCount;
+}
+
+okapi::QTime IntakeController::getTimeLost() const {
+  std::scoped_lock lock(mutex);
+  return clearing ? timeLost + (timer->millis() - jamStart) : timeLost;
+}
+
+void IntakeController::startThread(std::unique_ptr<okapi::AbstractRate> irate,
+                                   const okapi::QTime iperiod) {
+  if (!task) {
+    rate = std::move(irate);
+    threadPeriod = iperiod;
+    task = new CrossplatformThread(trampoline, this, "IntakeController");
+  }
+}
+
+CrossplatformThread *IntakeController::getThread() const {
+  return task;
+}
+
+void IntakeController::trampoline(void *context) {
+  if (context) {
+    static_cast<IntakeController *>(context)->loop();
+  }
+}
+
+void IntakeController::loop() {
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    step();
+    rate->delayUntil(threadPeriod);
+  }
+}
+} // namespace spooder
@@ -0,0 +1,212 @@
+#include "spooder/api/control/roller/rollerController.hpp"
+#include <algorithm>
+#include <cmath>
+
+#ifdef THREADS_STD
+#include <chrono>
+#endif
+
+namespace spooder {
+namespace {
+std::uint64_t micros() {
+#ifdef THREADS_STD
+  return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                      std::chrono::steady_clock::now().time_since_epoch())
+                                      .count());
+#else
+  return pros::c::micros();
+#endif
+}
+} // namespace
+
+RollerController::RollerController(std::shared_ptr<okapi::AbstractMotor> imotor,
+                                   std::shared_ptr<AbstractColorSensor> isensor,
+                                   const okapi::TimeUtil &itimeUtil,
+                                   const RollerParams &iparams,
+                                   std::shared_ptr<Telemetry> itelemetry,
+                                   std::shared_ptr<okapi::Logger> ilogger)
+  : motor(std::move(imotor)),
+    sensor(std::move(isensor)),
+    timeUtil(itimeUtil),
+    timer(itimeUtil.getTimer()),
+    params(iparams),
+    telemetry(std::move(itelemetry)),
+    logger(std::move(ilogger)) {
+}
+
+RollerController::~RollerController() {
+  dtorCalled.store(true, std::memory_order_release);
+  delete task;
+}
+
+void RollerController::setTargetColor(const RollerColor icolor) {
+  std::scoped_lock lock(mutex);
+  target = icolor;
+}
+
+void RollerController::start() {
+  std::scoped_lock lock(mutex);
+  if (state == State::turning) {
+    return;
+  }
+
+  state = State::turning;
+  turnStart = timer->millis();
+  maxSampleGap = 0;
+  samples = 0;
+  seen = 0;
+  motor->moveVoltage(params.voltage);
+}
+
+void RollerController::cancel() {
+  std::scoped_lock lock(mutex);
+  if (state == State::turning) {
+    motor->moveVelocity(0);
+    state = State::idle;
+  }
+}
+
+bool RollerController::turnRoller() {
+  start();
+  const auto rate = timeUtil.getRate();
+  while (getState() == State::turning) {
+    rate->delayUntil(threadPeriod);
+  }
+  return getState() == State::done;
+}
+
+void RollerController::step() {
+  std::scoped_lock lock(mutex);
+  if (state != State::turning) {
+    return;
+  }
+
+  const std::uint64_t sampleTime = micros();
+  if (samples > 0) {
+    maxSampleGap = std::max(maxSampleGap, static_cast<std::uint32_t>(sampleTime - lastSample));
+  }
+  lastSample = sampleTime;
+  samples++;
+
+  color = readColor();
+  const okapi::QTime now = timer->millis();
+
+  if (color == target && target != RollerColor::none) {
+    if (++seen >= params.confirmSamples) {
+      // Stop before anything else, every microsecond here is more of the roller going past. A
+      // zero voltage only lets it coast; the brake mode acts on a zero velocity command
+      motor->moveVelocity(0);
+      latency = static_cast<std::uint32_t>(micros() - sampleTime);
+      finish(State::done, now);
+    }
+    return;
+  }
+  seen = 0;
+
+  if (now - turnStart >= params.timeout) {
+    motor->moveVelocity(0);
+    finish(State::timedOut, now);
+  }
+}
+
+RollerColor RollerController::readColor() {
+  // The hue of a distant or grey surface is noise, so check there is a color to read first
+  const std::int32_t proximity = sensor->getProximity();
+  if (proximity == okapi::OKAPI_PROS_ERR || proximity < params.minProximity) {
+    return RollerColor::none;
+  }
+
+  const double saturation = sensor->getSaturation();
+  if (!std::isfinite(saturation) || saturation < params.minSaturation) {
+    return RollerColor::none;
+  }
+
+  const double hue = sensor->getHue();
+  if (!std::isfinite(hue)) {
+    return RollerColor::none;
+  }
+  if (hue < params.redBelow || hue > params.redAbove) {
+    return RollerColor::red;
+  }
+  if (hue >= params.blueFrom && hue <= params.blueTo) {
+    return RollerColor::blue;
+  }
+  return RollerColor::none;
+}
+
+void RollerController::finish(const State istate, const okapi::QTime inow) {
+  state = istate;
+  cycleTime = inow - turnStart;
+  turns++;
+
+  const bool found = istate == State::done;
+  const double elapsed = cycleTime.convert(okapi::millisecond);
+  const std::uint32_t stopLatency = latency;
+  if (found) {
+    LOG_INFO("RollerController: Turned the roller in " + std::to_string(elapsed) +
+             " ms, stopped " + std::to_string(stopLatency) + " us after seeing the color");
+  } else {
+    LOG_WARN("RollerController: Did not see the color after " + std::to_string(elapsed) + " ms");
+  }
+
+  telemetry->send("roller",
+                  "%zu,%d,%ld,%lu,%zu,%lu",
+                  turns,
+                  found ? 1 : 0,
+                  static_cast<long>(elapsed),
+                  static_cast<unsigned long>(found ? latency : 0),
+                  samples,
+                  static_cast<unsigned long>(maxSampleGap));
+}
+
+RollerController::State RollerController::getState() const {
+  std::scoped_lock lock(mutex);
+  return state;
+}
+
+RollerColor RollerController::getColor() const {
+  std::scoped_lock lock(mutex);
+  return color;
+}
+
+okapi::QTime RollerController::getCycleTime() const {
+  std::scoped_lock lock(mutex);
+  return cycleTime;
+}
+
+std::uint32_t RollerController::getLatency() const {
+  std::scoped_lock lock(mutex);
+  return latency;
+}
+
+std::uint32_t RollerController::getMaxSampleGap() const {
+  std::scoped_lock lock(mutex);
+  return maxSampleGap;
+}
+
+void RollerController::startThread(std::unique_ptr<okapi::AbstractRate> irate,
+                                   const okapi::QTime iperiod) {
+  if (!task) {
+    rate = std::move(irate);
+    threadPeriod = iperiod;
+    task = new CrossplatformThread(trampoline, this, "RollerController");
+  }
+}
+
+CrossplatformThread *RollerController::getThread() const {
+  return task;
+}
+
+void RollerController::trampoline(void *context) {
+  if (context) {
+    static_cast<RollerController *>(context)->loop();
+  }
+}
+
+void RollerController::loop() {
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    step();
+    rate->delayUntil(threadPeriod);
+  }
+}
+} // namespace spooder
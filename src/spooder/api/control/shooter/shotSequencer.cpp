@@ -0,0 +1,255 @@
+#include "spooder/api/control/shooter/shotSequencer.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace spooder {
+ShotSequencer::ShotSequencer(std::shared_ptr<okapi::ControllerInput<double>> ivelocity,
+                             std::function<void(bool)> iindexer,
+                             const okapi::TimeUtil &itimeUtil,
+                             const ShotParams &iparams,
+                             std::shared_ptr<Telemetry> itelemetry,
+                             std::shared_ptr<okapi::Logger> ilogger)
+  : velocitySensor(std::move(ivelocity)),
+    indexer(std::move(iindexer)),
+    timer(itimeUtil.getTimer()),
+    params(iparams),
+    telemetry(std::move(itelemetry)),
+    logger(std::move(ilogger)) {
+  // Enough for a match, so recording a shot does not allocate mid-burst
+  shots.reserve(64);
+}
+
+ShotSequencer::~ShotSequencer() {
+  dtorCalled.store(true, std::memory_order_release);
+  delete task;
+}
+
+void ShotSequencer::setTarget(const double ivelocity) {
+  std::scoped_lock lock(mutex);
+  // A target that drifts with the robot's distance to the goal only restarts the dwell when it
+  // jumps by more than the band
+  if (std::abs(ivelocity - target) > params.tolerance) {
+    inBand = false;
+  }
+  target = ivelocity;
+}
+
+void ShotSequencer::setMode(const Mode imode) {
+  std::scoped_lock lock(mutex);
+  if (imode != mode) {
+    mode = imode;
+    inBand = false;
+  }
+}
+
+void ShotSequencer::fire(const int ishots) {
+  std::scoped_lock lock(mutex);
+  if (remaining >= 0) {
+    remaining += ishots;
+  }
+}
+
+void ShotSequencer::setFiring(const bool ifiring) {
+  std::scoped_lock lock(mutex);
+  if (ifiring) {
+    remaining = -1;
+    return;
+  }
+
+  remaining = 0;
+  if (state == State::waiting || state == State::feeding) {
+    endBurst();
+  }
+}
+
+void ShotSequencer::step() {
+  std::scoped_lock lock(mutex);
+  const okapi::QTime now = timer->millis();
+  velocity = velocitySensor->controllerGet();
+
+  const double tolerance = mode == Mode::rapid ? params.rapidTolerance : params.tolerance;
+  const bool nowInBand = target > 0 && std::abs(velocity - target) <= tolerance;
+  if (nowInBand && !inBand) {
+    inBandSince = now;
+  }
+  inBand = nowInBand;
+
+  switch (state) {
+  case State::idle:
+    if (remaining != 0) {
+      state = State::waiting;
+    }
+    break;
+
+  case State::waiting:
+    if (remaining == 0) {
+      endBurst();
+    } else if (ready(now)) {
+      feed(now);
+    }
+    break;
+
+  case State::feeding:
+    peak = std::max(peak, velocity);
+    if (peak - velocity >= params.shotDrop) {
+      state = State::firing;
+      minimum = velocity;
+      shotTime = now;
+      if (mode == Mode::precise) {
+        setIndexer(false);
+      }
+    } else if (now - feedStart >= params.feedTimeout) {
+      const double waited = (now - feedStart).convert(okapi::millisecond);
+      LOG_INFO("ShotSequencer: No shot after " + std::to_string(waited) +
+               " ms of feeding, out of discs");
+      endBurst();
+    } else if (mode == Mode::rapid && !inBand) {
+      setIndexer(false);
+      state = State::waiting;
+    }
+    break;
+
+  case State::firing:
+    // The disc has left once the flywheel starts to pick back up
+    minimum = std::min(minimum, velocity);
+    if (velocity >= minimum + params.shotDrop / 2 || now - shotTime >= params.feedTimeout) {
+      finishShot(now);
+    }
+    break;
+  }
+
+  // Own the indexer for the whole burst, from the step it starts: it may share a motor with
+  // something that runs it while the sequencer is idle (such as the driver's intake), which would
+  // otherwise keep running through the wait or override the sequencer between steps
+  if (state != State::idle) {
+    indexer(indexing);
+  }
+}
+
+bool ShotSequencer::ready(const okapi::QTime inow) const {
+  return inBand && (mode == Mode::rapid || inow - inBandSince >= params.dwellTime);
+}
+
+void ShotSequencer::setIndexer(const bool ion) {
+  if (ion != indexing) {
+    indexing = ion;
+    indexer(ion);
+  }
+}
+
+void ShotSequencer::feed(const okapi::QTime inow) {
+  state = State::feeding;
+  feedStart = inow;
+  peak = velocity;
+  setIndexer(true);
+}
+
+void ShotSequencer::finishShot(const okapi::QTime inow) {
+  const okapi::QTime interval =
+    burstShots > 0 ? shotTime - shots.back().time : 0 * okapi::millisecond;
+  shots.push_back({shotTime, target, peak, minimum, interval});
+
+  if (burstShots == 0) {
+    burstStart = shotTime;
+  }
+  burstShots++;
+  if (burstShots > 1) {
+    shotsPerSecond = (burstShots - 1) / (shotTime - burstStart).convert(okapi::second);
+  }
+
+  const std::size_t count = shots.size();
+  const double release = peak;
+  const double drop = peak - minimum;
+  LOG_INFO("ShotSequencer: Shot " + std::to_string(count) + " at " + std::to_string(release) +
+           " rpm, dropped " + std::to_string(drop) + " rpm");
+  telemetry->send("shot",
+                  "%zu,%.0f,%.0f,%.0f,%ld",
+                  count,
+                  target,
+                  peak,
+                  minimum,
+                  static_cast<long>(interval.convert(okapi::millisecond)));
+
+  if (remaining > 0) {
+    remaining--;
+  }
+  if (remaining == 0) {
+    endBurst();
+    return;
+  }
+
+  // Rapid fire keeps the indexer running into the next disc while the flywheel is in band
+  peak = velocity;
+  if (mode == Mode::rapid && inBand) {
+    state = State::feeding;
+    feedStart = inow;
+    setIndexer(true);
+  } else {
+    setIndexer(false);
+    state = State::waiting;
+  }
+}
+
+void ShotSequencer::endBurst() {
+  setIndexer(false);
+  state = State::idle;
+  remaining = 0;
+  burstShots = 0;
+}
+
+bool ShotSequencer::isReady() const {
+  std::scoped_lock lock(mutex);
+  return ready(timer->millis());
+}
+
+ShotSequencer::State ShotSequencer::getState() const {
+  std::scoped_lock lock(mutex);
+  return state;
+}
+
+double ShotSequencer::getVelocity() const {
+  std::scoped_lock lock(mutex);
+  return velocity;
+}
+
+std::vector<ShotSequencer::Shot> ShotSequencer::getShots() const {
+  std::scoped_lock lock(mutex);
+  return shots;
+}
+
+std::size_t ShotSequencer::getShotCount() const {
+  std::scoped_lock lock(mutex);
+  return shots.size();
+}
+
+double ShotSequencer::getShotsPerSecond() const {
+  std::scoped_lock lock(mutex);
+  return shotsPerSecond;
+}
+
+void ShotSequencer::startThread(std::unique_ptr<okapi::AbstractRate> irate,
+                                const okapi::QTime iperiod) {
+  if (!task) {
+    rate = std::move(irate);
+    threadPeriod = iperiod;
+    task = new CrossplatformThread(trampoline, this, "ShotSequencer");
+  }
+}
+
+CrossplatformThread *ShotSequencer::getThread() const {
+  return task;
+}
+
+void ShotSequencer::trampoline(void *context) {
+  if (context) {
+    static_cast<ShotSequencer *>(context)->loop();
+  }
+}
+
+void ShotSequencer::loop() {
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    step();
+    rate->delayUntil(threadPeriod);
+  }
+}
+} // namespace spooder
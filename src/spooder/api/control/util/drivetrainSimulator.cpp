@@ -0,0 +1,364 @@
+#include "spooder/api/control/util/drivetrainSimulator.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace spooder {
+namespace {
+constexpr double gravity = 9.80665;                // m/s^2
+constexpr double radPerSecToRpm = 9.5492965855137; // 60 / (2 pi)
+constexpr double radToDeg = 57.295779513082;       // 180 / pi
+
+/**
+ * Steps a velocity under a drive and a Coulomb friction that can stop it but not reverse it.
+ */
+double frictionStep(const double ivelocity,
+                    const double idrive,
+                    const double ifriction,
+                    const double iinertia,
+                    const double idt) {
+  if (ivelocity == 0 && std::abs(idrive) <= ifriction) {
+    return 0;
+  }
+
+  const double direction =
+    (ivelocity != 0) ? std::copysign(1.0, ivelocity) : std::copysign(1.0, idrive);
+  const double velocity = ivelocity + (idrive - ifriction * direction) / iinertia * idt;
+  return (velocity * direction < 0) ? 0 : velocity;
+}
+} // namespace
+
+DrivetrainSimulator::DrivetrainSimulator(const Parameters &iparams, const okapi::QTime itimestep)
+  : params(iparams),
+    dt(itimestep.convert(okapi::second)),
+    sensorPeriodSteps(std::max<std::int64_t>(1, std::llround(0.01 / dt))),
+    freeSpeed(okapi::toUnderlyingType(iparams.gearset.internalGearset) / radPerSecToRpm),
+    stallTorque(redStallTorque * 100 / okapi::toUnderlyingType(iparams.gearset.internalGearset)),
+    normalForce(iparams.mass * gravity / 2),
+    motors(2 * iparams.motorsPerSide) {
+}
+
+DrivetrainSimulator::DrivetrainSimulator() : DrivetrainSimulator(Parameters{}) {
+}
+
+DrivetrainSimulator::~DrivetrainSimulator() {
+  dtorCalled.store(true, std::memory_order_release);
+  delete task;
+}
+
+void DrivetrainSimulator::step(const okapi::QTime idt) {
+  std::scoped_lock lock(mutex);
+  const std::int64_t count = std::llround(idt.convert(okapi::second) / dt);
+  for (std::int64_t i = 0; i < count; i++) {
+    stepOnce();
+  }
+}
+
+okapi::QTime DrivetrainSimulator::getTime() const {
+  std::scoped_lock lock(mutex);
+  return steps * dt * okapi::second;
+}
+
+void DrivetrainSimulator::advanceTo(const okapi::QTime itime) {
+  std::scoped_lock lock(mutex);
+  const double end = itime.convert(okapi::second);
+  while ((steps + 0.5) * dt < end) {
+    stepOnce();
+  }
+}
+
+void DrivetrainSimulator::reset(const okapi::OdomState &ipose) {
+  std::scoped_lock lock(mutex);
+  x = ipose.x.convert(okapi::meter);
+  y = ipose.y.convert(okapi::meter);
+  theta = ipose.theta.convert(okapi::radian);
+  linearVelocity = 0;
+  angularVelocity = 0;
+  left = Side{};
+  right = Side{};
+
+  const okapi::QTime now = steps * dt * okapi::second;
+  for (auto &motor : motors) {
+    motor.command = MotorCommand{};
+    motor.integral = 0;
+    motor.holding = false;
+    motor.voltage = 0;
+    motor.current = 0;
+    motor.torque = 0;
+    motor.reading = MotorReading{};
+    motor.reading.timestamp = now;
+  }
+}
+
+okapi::OdomState DrivetrainSimulator::getPose() const {
+  std::scoped_lock lock(mutex);
+  return {x * okapi::meter, y * okapi::meter, theta * okapi::radian};
+}
+
+okapi::QSpeed DrivetrainSimulator::getLinearVelocity() const {
+  std::scoped_lock lock(mutex);
+  return linearVelocity * okapi::mps;
+}
+
+okapi::QAngularSpeed DrivetrainSimulator::getAngularVelocity() const {
+  std::scoped_lock lock(mutex);
+  return angularVelocity * okapi::radps;
+}
+
+bool DrivetrainSimulator::isSlipping(const bool ileft) const {
+  std::scoped_lock lock(mutex);
+  return ileft ? left.slipping : right.slipping;
+}
+
+void DrivetrainSimulator::setTraction(const double imuStatic, const double imuKinetic) {
+  std::scoped_lock lock(mutex);
+  params.muStatic = imuStatic;
+  params.muKinetic = imuKinetic;
+}
+
+DrivetrainSimulator::Parameters DrivetrainSimulator::getParameters() const {
+  std::scoped_lock lock(mutex);
+  return params;
+}
+
+std::size_t DrivetrainSimulator::getMotorCount() const {
+  return motors.size();
+}
+
+void DrivetrainSimulator::setCommand(const std::size_t imotor, const MotorCommand &icommand) {
+  std::scoped_lock lock(mutex);
+  auto &motor = motors.at(imotor);
+  if (icommand.mode != motor.command.mode) {
+    motor.integral = 0;
+  }
+  motor.command = icommand;
+  motor.holding = false;
+}
+
+void DrivetrainSimulator::setBrakeMode(const std::size_t imotor,
+                                       const okapi::AbstractMotor::brakeMode imode) {
+  std::scoped_lock lock(mutex);
+  motors.at(imotor).brakeMode = imode;
+}
+
+void DrivetrainSimulator::setCurrentLimit(const std::size_t imotor, const double ilimit) {
+  std::scoped_lock lock(mutex);
+  motors.at(imotor).currentLimit = std::clamp(ilimit, 0.0, stallCurrent);
+}
+
+void DrivetrainSimulator::setVoltageLimit(const std::size_t imotor, const double ilimit) {
+  std::scoped_lock lock(mutex);
+  motors.at(imotor).voltageLimit = std::clamp(ilimit, 0.0, nominalVoltage);
+}
+
+DrivetrainSimulator::MotorReading DrivetrainSimulator::getReading(const std::size_t imotor) const {
+  std::scoped_lock lock(mutex);
+  return motors.at(imotor).reading;
+}
+
+void DrivetrainSimulator::startThread(std::unique_ptr<okapi::AbstractRate> irate,
+                                      const okapi::QTime iperiod) {
+  if (!task) {
+    rate = std::move(irate);
+    threadPeriod = iperiod;
+    task = new CrossplatformThread(trampoline, this, "DrivetrainSimulator");
+  }
+}
+
+CrossplatformThread *DrivetrainSimulator::getThread() const {
+  return task;
+}
+
+void DrivetrainSimulator::trampoline(void *context) {
+  if (context) {
+    static_cast<DrivetrainSimulator *>(context)->loop();
+  }
+}
+
+void DrivetrainSimulator::loop() {
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    step(threadPeriod);
+    rate->delayUntil(threadPeriod);
+  }
+}
+
+void DrivetrainSimulator::stepOnce() {
+  const double radius = params.wheelDiameter / 2;
+  const double ratio = params.gearset.ratio;
+  const double halfTrack = params.trackWidth / 2;
+
+  // The field moves under each side at the body velocity plus the turning velocity
+  const double leftGround = linearVelocity + angularVelocity * halfTrack;
+  const double rightGround = linearVelocity - angularVelocity * halfTrack;
+  if (!left.slipping) {
+    left.velocity = leftGround;
+  }
+  if (!right.slipping) {
+    right.velocity = rightGround;
+  }
+
+  const double leftSpeed = left.velocity / radius * ratio;
+  const double rightSpeed = right.velocity / radius * ratio;
+  const double leftPosition = left.position / radius * ratio * radToDeg;
+  const double rightPosition = right.position / radius * ratio * radToDeg;
+
+  double leftTorque = 0;
+  double rightTorque = 0;
+  for (std::size_t i = 0; i < motors.size(); i++) {
+    if (i < params.motorsPerSide) {
+      leftTorque += motorTorque(motors[i], leftSpeed, leftPosition);
+    } else {
+      rightTorque += motorTorque(motors[i], rightSpeed, rightPosition);
+    }
+  }
+
+  const double leftForce = contactForce(left, leftTorque * ratio / radius, leftGround);
+  const double rightForce = contactForce(right, rightTorque * ratio / radius, rightGround);
+
+  // A gripping side's spinning parts move with the robot, so they add to its inertia
+  const double sideMass = params.sideInertia / (radius * radius);
+  const double gripping = (left.slipping ? 0 : 1) + (right.slipping ? 0 : 1);
+  const double mass = params.mass + sideMass * gripping;
+  const double inertia = params.momentOfInertia + sideMass * halfTrack * halfTrack * gripping;
+
+  // The wheels at the ends of the drive slide sideways when turning. With the weight spread
+  // evenly along the wheelbase, the average lever arm is a quarter of it.
+  const double weight = params.mass * gravity;
+  const double rolling = params.rollingFriction * weight;
+  const double scrub = params.scrubFriction * weight * params.wheelbase / 4;
+
+  linearVelocity = frictionStep(linearVelocity, leftForce + rightForce, rolling, mass, dt);
+  angularVelocity =
+    frictionStep(angularVelocity, (leftForce - rightForce) * halfTrack, scrub, inertia, dt);
+
+  const double midTheta = theta + angularVelocity * dt / 2;
+  x += linearVelocity * std::cos(midTheta) * dt;
+  y += linearVelocity * std::sin(midTheta) * dt;
+  theta += angularVelocity * dt;
+
+  if (!left.slipping) {
+    left.velocity = linearVelocity + angularVelocity * halfTrack;
+  }
+  if (!right.slipping) {
+    right.velocity = linearVelocity - angularVelocity * halfTrack;
+  }
+  left.position += left.velocity * dt;
+  right.position += right.velocity * dt;
+
+  steps++;
+  if (steps % sensorPeriodSteps == 0) {
+    const okapi::QTime now = steps * dt * okapi::second;
+    for (std::size_t i = 0; i < motors.size(); i++) {
+      const Side &side = (i < params.motorsPerSide) ? left : right;
+      auto &reading = motors[i].reading;
+      reading.position = side.position / radius * ratio * radToDeg;
+      reading.velocity = side.velocity / radius * ratio * radPerSecToRpm;
+      reading.voltage = motors[i].voltage;
+      reading.current = motors[i].current;
+      reading.torque = motors[i].torque;
+      reading.timestamp = now;
+    }
+  }
+}
+
+double DrivetrainSimulator::motorTorque(Motor &imotor,
+                                        const double ispeed,
+                                        const double iposition) {
+  // Internal controller gains, scaled to the cartridge like the motor's own
+  const double freeRpm = freeSpeed * radPerSecToRpm;
+  const double kF = nominalVoltage / freeRpm; // V / RPM
+  const double kP = 2 * kF;                   // V / RPM
+  const double kI = 20 * kF;                  // V / (RPM s)
+  const double kPosition = 4;                 // RPM / degree
+
+  const double rpm = ispeed * radPerSecToRpm;
+  const auto &command = imotor.command;
+  const bool zero = command.mode != MotorMode::position && command.target == 0;
+
+  double targetRpm = 0;
+  bool closedLoop = true;
+  double voltage = 0;
+
+  if (zero) {
+    switch (imotor.brakeMode) {
+    case okapi::AbstractMotor::brakeMode::coast:
+      imotor.voltage = 0;
+      imotor.current = 0;
+      imotor.torque = 0;
+      imotor.integral = 0;
+      return 0;
+    case okapi::AbstractMotor::brakeMode::hold:
+      if (!imotor.holding) {
+        imotor.holding = true;
+        imotor.holdPosition = iposition;
+        imotor.integral = 0;
+      }
+      targetRpm = std::clamp(kPosition * (imotor.holdPosition - iposition), -freeRpm, freeRpm);
+      break;
+    default:
+      // Shorting the windings brakes against the back EMF
+      closedLoop = false;
+      imotor.integral = 0;
+      break;
+    }
+  } else if (command.mode == MotorMode::voltage) {
+    closedLoop = false;
+    voltage = command.target;
+  } else if (command.mode == MotorMode::velocity) {
+    targetRpm = command.target;
+  } else {
+    const double maxRpm = std::min(std::abs(command.maxVelocity), freeRpm);
+    targetRpm = std::clamp(kPosition * (command.target - iposition), -maxRpm, maxRpm);
+  }
+
+  if (closedLoop) {
+    const double error = targetRpm - rpm;
+    imotor.integral =
+      std::clamp(imotor.integral + kI * error * dt, -nominalVoltage, nominalVoltage);
+    voltage = kF * targetRpm + kP * error + imotor.integral;
+  }
+
+  const double maxVoltage = std::min(imotor.voltageLimit, params.supplyVoltage);
+  voltage = std::clamp(voltage, -maxVoltage, maxVoltage);
+
+  // Linear torque-speed curve, with the current limit capping the torque
+  double torque = stallTorque * (voltage / nominalVoltage - ispeed / freeSpeed);
+  const double maxTorque = stallTorque * imotor.currentLimit / stallCurrent;
+  torque = std::clamp(torque, -maxTorque, maxTorque);
+
+  imotor.voltage = voltage;
+  imotor.torque = torque;
+  imotor.current = torque / stallTorque * stallCurrent;
+  return torque;
+}
+
+double DrivetrainSimulator::contactForce(Side &iside,
+                                         const double idriveForce,
+                                         const double igroundSpeed) {
+  if (!iside.slipping) {
+    if (std::abs(idriveForce) <= params.muStatic * normalForce) {
+      return idriveForce;
+    }
+    iside.slipping = true;
+  }
+
+  // Kinetic friction opposes the wheel sliding over the field
+  const double slip = iside.velocity - igroundSpeed;
+  const double direction =
+    (slip != 0) ? std::copysign(1.0, slip) : std::copysign(1.0, idriveForce);
+  const double force = params.muKinetic * normalForce * direction;
+
+  const double radius = params.wheelDiameter / 2;
+  const double sideMass = params.sideInertia / (radius * radius);
+  iside.velocity += (idriveForce - force) / sideMass * dt;
+
+  // Grip again once the wheel has caught up with the field
+  if ((iside.velocity - igroundSpeed) * direction <= 0) {
+    iside.velocity = igroundSpeed;
+    iside.slipping = false;
+  }
+
+  return force;
+}
+} // namespace spooder
@@ -0,0 +1,43 @@
+#include "spooder/api/control/util/notifyingSettledUtil.hpp"
+
+namespace spooder {
+NotifyingSettledUtil::NotifyingSettledUtil(std::shared_ptr<SettleEvent> ievent,
+                                           std::unique_ptr<okapi::AbstractTimer> iatTargetTimer,
+                                           const double iatTargetError,
+                                           const double iatTargetDerivative,
+                                           const okapi::QTime iatTargetTime)
+  : okapi::SettledUtil(
+      std::move(iatTargetTimer), iatTargetError, iatTargetDerivative, iatTargetTime),
+    event(std::move(ievent)) {
+}
+
+bool NotifyingSettledUtil::isSettled(const double ierror) {
+  const bool settled = okapi::SettledUtil::isSettled(ierror);
+  if (settled) {
+    event->set();
+  } else {
+    event->clear();
+  }
+  return settled;
+}
+
+void NotifyingSettledUtil::reset() {
+  okapi::SettledUtil::reset();
+  event->clear();
+}
+
+okapi::TimeUtil createNotifyingTimeUtil(const okapi::TimeUtil &itimeUtil,
+                                        const std::shared_ptr<SettleEvent> &ievent,
+                                        const double iatTargetError,
+                                        const double iatTargetDerivative,
+                                        const okapi::QTime iatTargetTime) {
+  const auto timerSupplier = itimeUtil.getTimerSupplier();
+  return okapi::TimeUtil(
+    timerSupplier,
+    itimeUtil.getRateSupplier(),
+    okapi::Supplier<std::unique_ptr<okapi::SettledUtil>>([=]() {
+      return std::make_unique<NotifyingSettledUtil>(
+        ievent, timerSupplier.get(), iatTargetError, iatTargetDerivative, iatTargetTime);
+    }));
+}
+} // namespace spooder
@@ -0,0 +1,177 @@
+#include "spooder/api/control/util/simulatedPidTuner.hpp"
+#include "spooder/api/util/parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace spooder {
+SimulatedPIDTuner::SimulatedPIDTuner(
+  std::function<std::unique_ptr<SimulatedPlant>()> iplantSupplier,
+  const okapi::QTime itimeout,
+  const double igoal,
+  const double ikPMin,
+  const double ikPMax,
+  const double ikIMin,
+  const double ikIMax,
+  const double ikDMin,
+  const double ikDMax,
+  const std::size_t inumIterations,
+  const std::size_t inumParticles,
+  const double ikSettle,
+  const double ikITAE,
+  const std::uint32_t iseed)
+  : plantSupplier(std::move(iplantSupplier)),
+    timeout(itimeout),
+    goal(igoal),
+    kPMin(ikPMin),
+    kPMax(ikPMax),
+    kIMin(ikIMin),
+    kIMax(ikIMax),
+    kDMin(ikDMin),
+    kDMax(ikDMax),
+    numIterations(inumIterations),
+    numParticles(inumParticles),
+    kSettle(ikSettle),
+    kITAE(ikITAE),
+    seed(iseed) {
+}
+
+SimulatedPIDTuner::Output SimulatedPIDTuner::autotune() {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<double> dist(0, 1);
+
+  std::vector<ParticleSet> particles;
+  particles.reserve(numParticles);
+  for (std::size_t i = 0; i < numParticles; i++) {
+    ParticleSet set{};
+    set.kP.pos = kPMin + (kPMax - kPMin) * dist(gen);
+    set.kI.pos = kIMin + (kIMax - kIMin) * dist(gen);
+    set.kD.pos = kDMin + (kDMax - kDMin) * dist(gen);
+    set.kP.best = set.kP.pos;
+    set.kI.best = set.kI.pos;
+    set.kD.best = set.kD.pos;
+    set.bestError = std::numeric_limits<double>::max();
+    particles.push_back(set);
+  }
+
+  ParticleSet global{};
+  global.bestError = std::numeric_limits<double>::max();
+
+  std::vector<double> costs(numParticles);
+  for (std::size_t iteration = 0; iteration < numIterations; iteration++) {
+    // Score every particle. Each call only writes its own cost, so they can run concurrently.
+    parallelFor(
+      numParticles,
+      [&](const std::size_t i) {
+        const auto &particle = particles[i];
+        costs[i] = evaluate({particle.kP.pos, particle.kI.pos, particle.kD.pos});
+      },
+      threads);
+
+    for (std::size_t i = 0; i < numParticles; i++) {
+      auto &particle = particles[i];
+      if (costs[i] < particle.bestError) {
+        particle.kP.best = particle.kP.pos;
+        particle.kI.best = particle.kI.pos;
+        particle.kD.best = particle.kD.pos;
+        particle.bestError = costs[i];
+
+        if (costs[i] < global.bestError) {
+          global = particle;
+        }
+      }
+    }
+
+    auto move = [&](Particle &p, const double iglobalBest, const double imin, const double imax) {
+      p.vel = inertia * p.vel + confSelf * dist(gen) * (p.best - p.pos) +
+              confSwarm * dist(gen) * (iglobalBest - p.pos);
+      p.pos = std::clamp(p.pos + p.vel, imin, imax);
+    };
+
+    for (auto &particle : particles) {
+      move(particle.kP, global.kP.best, kPMin, kPMax);
+      move(particle.kI, global.kI.best, kIMin, kIMax);
+      move(particle.kD, global.kD.best, kDMin, kDMax);
+    }
+  }
+
+  bestCost = global.bestError;
+  return {global.kP.best, global.kI.best, global.kD.best};
+}
+
+double SimulatedPIDTuner::evaluate(const Output &igains) const {
+  const auto plant = plantSupplier();
+  plant->reset();
+
+  // Same gain scaling as okapi::IterativePosPIDController
+  const double dt = sampleTime.convert(okapi::second);
+  const double kP = igains.kP;
+  const double kI = igains.kI * dt;
+  const double kD = igains.kD / dt;
+
+  double reading = 0;
+  double lastReading = 0;
+  double lastError = goal;
+  double integral = 0;
+  double itae = 0;
+  double atTargetFor = -1; // seconds, or -1 when not at the target
+  double settleTime = timeout.convert(okapi::second);
+
+  const double end = timeout.convert(okapi::second);
+  const double targetTime = atTargetTime.convert(okapi::second);
+  for (double t = dt; t <= end; t += dt) {
+    const double error = goal - reading;
+
+    integral += kI * error;
+    if (std::copysign(1.0, error) != std::copysign(1.0, lastError)) {
+      integral = 0;
+    }
+    integral = std::clamp(integral, -1.0, 1.0);
+
+    const double out =
+      std::clamp(kP * error + integral - kD * (reading - lastReading), -1.0, 1.0);
+
+    lastReading = reading;
+    reading = plant->step(out, sampleTime);
+
+    itae += t * std::abs(error) * dt;
+
+    // Same condition as okapi::SettledUtil
+    if (std::abs(error) <= atTargetError && std::abs(error - lastError) <= atTargetDerivative) {
+      atTargetFor = (atTargetFor < 0) ? 0 : atTargetFor + dt;
+      if (atTargetFor >= targetTime) {
+        settleTime = t;
+        break;
+      }
+    } else {
+      atTargetFor = -1;
+    }
+
+    lastError = error;
+  }
+
+  return kSettle * settleTime * 1000 + kITAE * itae;
+}
+
+double SimulatedPIDTuner::getBestCost() const {
+  return bestCost;
+}
+
+void SimulatedPIDTuner::setSettledParams(const double iatTargetError,
+                                         const double iatTargetDerivative,
+                                         const okapi::QTime iatTargetTime) {
+  atTargetError = iatTargetError;
+  atTargetDerivative = iatTargetDerivative;
+  atTargetTime = iatTargetTime;
+}
+
+void SimulatedPIDTuner::setSampleTime(const okapi::QTime isampleTime) {
+  sampleTime = isampleTime;
+}
+
+void SimulatedPIDTuner::setThreads(const std::size_t ithreads) {
+  threads = ithreads;
+}
+} // namespace spooder
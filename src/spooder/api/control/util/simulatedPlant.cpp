@@ -0,0 +1,64 @@
+#include "spooder/api/control/util/simulatedPlant.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace spooder {
+MotorModelPlant::MotorModelPlant(const double ikS,
+                                 const double ikV,
+                                 const double ikA,
+                                 const bool ioutputPosition,
+                                 const double imaxVoltage)
+  : kS(ikS), kV(ikV), kA(ikA), outputPosition(ioutputPosition), maxVoltage(imaxVoltage) {
+}
+
+void MotorModelPlant::reset() {
+  position = 0;
+  velocity = 0;
+}
+
+double MotorModelPlant::step(const double icontrol, const okapi::QTime idt) {
+  const double dt = idt.convert(okapi::second);
+  const double voltage = std::clamp(icontrol, -1.0, 1.0) * maxVoltage;
+
+  if (velocity == 0 && std::abs(voltage) <= kS) {
+    // Static friction holds
+    return outputPosition ? position : velocity;
+  }
+
+  const double direction =
+    (velocity != 0) ? std::copysign(1.0, velocity) : std::copysign(1.0, voltage);
+  const double drive = voltage - kS * direction;
+
+  double newVelocity;
+  if (kV > 0 && kA > 0) {
+    // Exact solution for a constant voltage over the step, so large steps stay stable
+    const double steady = drive / kV;
+    const double tau = kA / kV;
+    const double decay = std::exp(-dt / tau);
+    newVelocity = steady + (velocity - steady) * decay;
+    position += steady * dt + (velocity - steady) * tau * (1 - decay);
+  } else if (kA > 0) {
+    newVelocity = velocity + drive / kA * dt;
+    position += (velocity + newVelocity) / 2 * dt;
+  } else {
+    newVelocity = (kV > 0) ? drive / kV : 0;
+    position += newVelocity * dt;
+  }
+
+  if (newVelocity * direction < 0) {
+    // Friction can stop the mechanism but not reverse it
+    newVelocity = (std::abs(voltage) <= kS) ? 0 : newVelocity;
+  }
+
+  velocity = newVelocity;
+  return outputPosition ? position : velocity;
+}
+
+double MotorModelPlant::getPosition() const {
+  return position;
+}
+
+double MotorModelPlant::getVelocity() const {
+  return velocity;
+}
+} // namespace spooder
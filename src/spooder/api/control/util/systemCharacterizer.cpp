@@ -0,0 +1,189 @@
+#include "spooder/api/control/util/systemCharacterizer.hpp"
+#include "spooder/api/util/matrix.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace spooder {
+SystemCharacterizer::SystemCharacterizer(std::vector<std::shared_ptr<okapi::AbstractMotor>> imotors,
+                                         const okapi::TimeUtil &itimeUtil,
+                                         const double iratio,
+                                         std::shared_ptr<Telemetry> itelemetry,
+                                         std::shared_ptr<okapi::Logger> ilogger)
+  : logger(std::move(ilogger)),
+    telemetry(std::move(itelemetry)),
+    timeUtil(itimeUtil),
+    motors(std::move(imotors)),
+    samples(motors.size()) {
+  estimators.reserve(motors.size());
+  for (const auto &motor : motors) {
+    estimators.emplace_back(motor, iratio);
+  }
+}
+
+void SystemCharacterizer::runQuasistatic(const double irampRate,
+                                         const double imaxVoltage,
+                                         const bool ireverse,
+                                         const okapi::QTime itimeout) {
+  LOG_INFO("SystemCharacterizer: Quasistatic test at " + std::to_string(irampRate) + " V/s");
+
+  const double direction = ireverse ? -1 : 1;
+  const okapi::QTime rampTime = (imaxVoltage / irampRate) * okapi::second;
+  runTest([&](const double t) { return direction * std::min(irampRate * t, imaxVoltage); },
+          std::min(rampTime, itimeout));
+  stop();
+}
+
+void SystemCharacterizer::runDynamic(const double istepVoltage,
+                                     const okapi::QTime iduration,
+                                     const bool ireverse) {
+  LOG_INFO("SystemCharacterizer: Dynamic test at " + std::to_string(istepVoltage) + " V");
+
+  const double voltage = ireverse ? -istepVoltage : istepVoltage;
+  runTest([&](double) { return voltage; }, iduration);
+  stop();
+}
+
+void SystemCharacterizer::runTest(const std::function<double(double)> &ivoltage,
+                                  const okapi::QTime iduration) {
+  auto timer = timeUtil.getTimer();
+  auto rate = timeUtil.getRate();
+  const okapi::QTime start = timer->millis();
+
+  for (auto &estimator : estimators) {
+    estimator.step();
+  }
+
+  while (true) {
+    const double t = (timer->millis() - start).convert(okapi::second);
+    if (t >= iduration.convert(okapi::second)) {
+      break;
+    }
+
+    const double voltage = std::clamp(ivoltage(t), -12.0, 12.0);
+    for (std::size_t i = 0; i < motors.size(); i++) {
+      motors[i]->moveVoltage(static_cast<std::int16_t>(voltage * 1000));
+
+      const double velocity = estimators[i].step().convert(okapi::rpm);
+      const double acceleration = estimators[i].getAccel().convert(okapi::rpm / okapi::second);
+      const double measuredVoltage = motors[i]->getVoltage() / 1000.0;
+
+      samples[i].push_back({t, measuredVoltage, velocity, acceleration});
+      telemetry->send(
+        "sysid", "%zu,%.3f,%.3f,%.2f,%.1f", i, t, measuredVoltage, velocity, acceleration);
+    }
+
+    rate->delayUntil(samplePeriod);
+  }
+}
+
+void SystemCharacterizer::stop() {
+  for (const auto &motor : motors) {
+    motor->moveVoltage(0);
+  }
+
+  // Let the mechanism coast to rest so the next test starts from zero velocity
+  auto timer = timeUtil.getTimer();
+  auto rate = timeUtil.getRate();
+  const okapi::QTime start = timer->millis();
+  while (timer->millis() - start < 5 * okapi::second) {
+    bool stopped = true;
+    for (auto &estimator : estimators) {
+      stopped &= std::abs(estimator.step().convert(okapi::rpm)) < minFitVelocity;
+    }
+
+    if (stopped) {
+      break;
+    }
+
+    rate->delayUntil(samplePeriod);
+  }
+}
+
+std::vector<SimpleMotorFeedforward> SystemCharacterizer::fit() const {
+  std::vector<SimpleMotorFeedforward> out;
+  out.reserve(samples.size());
+
+  for (std::size_t i = 0; i < samples.size(); i++) {
+    const auto gains = fit(samples[i], minFitVelocity);
+    out.push_back(gains);
+
+    LOG_INFO("SystemCharacterizer: Motor " + std::to_string(i) + " kS=" + std::to_string(gains.kS) +
+             " kV=" + std::to_string(gains.kV) + " kA=" + std::to_string(gains.kA));
+    telemetry->send("sysidfit",
+                    "%zu,%.5f,%.7f,%.7f,%.4f",
+                    i,
+                    gains.kS,
+                    gains.kV,
+                    gains.kA,
+                    gains.timeConstant());
+  }
+
+  return out;
+}
+
+SimpleMotorFeedforward SystemCharacterizer::fit(const std::vector<Sample> &isamples,
+                                                const double iminVelocity) {
+  // Fit the model one sample period at a time, v' = alpha v + beta V + gamma sgn(v), rather than
+  // V = kS sgn(v) + kV v + kA a directly. The acceleration estimate lags a voltage step by most of
+  // the estimator's window, which on a drivetrain is longer than its time constant and biases kA
+  // low; consecutive velocities only share the velocity estimate's lag.
+  // Normal equations X'X b = X'y with rows x = [v, V, sgn(v)] and y = v'
+  Matrix<3, 3> xtx;
+  Vector<3> xty;
+  std::size_t used = 0;
+  double totalDt = 0;
+
+  for (std::size_t i = 0; i + 1 < isamples.size(); i++) {
+    const auto &sample = isamples[i];
+    const auto &next = isamples[i + 1];
+
+    // Time restarts at each test, and the pair across a boundary is not one period apart
+    if (next.time <= sample.time || std::abs(sample.velocity) < iminVelocity ||
+        std::abs(next.velocity) < iminVelocity) {
+      continue;
+    }
+
+    const double x[3] = {sample.velocity, sample.voltage, std::copysign(1.0, sample.velocity)};
+    for (std::size_t r = 0; r < 3; r++) {
+      for (std::size_t c = 0; c < 3; c++) {
+        xtx(r, c) += x[r] * x[c];
+      }
+      xty[r] += x[r] * next.velocity;
+    }
+    totalDt += next.time - sample.time;
+    used++;
+  }
+
+  Vector<3> b;
+  if (used < 3 || !xtx.solve(xty, b)) {
+    return {};
+  }
+
+  // alpha = exp(-dt kV / kA) and beta = (1 - alpha) / kV, so alpha must be in (0, 1)
+  const double alpha = b[0];
+  const double beta = b[1];
+  const double gamma = b[2];
+  if (alpha <= 0 || alpha >= 1 || beta <= 0) {
+    return {};
+  }
+
+  const double dt = totalDt / used;
+  const double kV = (1 - alpha) / beta;
+  return {-gamma / beta, kV, -dt * kV / std::log(alpha)};
+}
+
+const std::vector<SystemCharacterizer::Sample> &
+SystemCharacterizer::getSamples(const std::size_t imotor) const {
+  return samples.at(imotor);
+}
+
+void SystemCharacterizer::clear() {
+  for (auto &recording : samples) {
+    recording.clear();
+  }
+}
+
+void SystemCharacterizer::setSamplePeriod(const okapi::QTime isamplePeriod) {
+  samplePeriod = isamplePeriod;
+}
+} // namespace spooder
@@ -0,0 +1,13 @@
+#include "spooder/api/device/button/inputFrameButton.hpp"
+
+namespace spooder {
+InputFrameButton::InputFrameButton(const InputFrame &iframe,
+                                   const std::size_t ibutton,
+                                   const bool iinverted)
+  : ButtonBase(iinverted), frame(iframe), button(ibutton) {
+}
+
+bool InputFrameButton::currentlyPressed() {
+  return frame.getDigital(button);
+}
+} // namespace spooder
@@ -0,0 +1,186 @@
+#include "spooder/api/device/motor/currentBudget.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+
+namespace spooder {
+CurrentBudget::CurrentBudget(std::shared_ptr<AbstractBattery> ibattery,
+                             const CurrentBudgetParams &iparams,
+                             std::shared_ptr<Telemetry> itelemetry,
+                             std::shared_ptr<okapi::Logger> ilogger)
+  : battery(std::move(ibattery)),
+    params(iparams),
+    telemetry(std::move(itelemetry)),
+    logger(std::move(ilogger)),
+    budget(iparams.budget) {
+}
+
+CurrentBudget::~CurrentBudget() {
+  dtorCalled.store(true, std::memory_order_release);
+  delete task;
+}
+
+std::size_t CurrentBudget::add(std::string iname,
+                               std::vector<std::shared_ptr<okapi::AbstractMotor>> imotors,
+                               const int ipriority,
+                               const std::int32_t iminLimit,
+                               const std::int32_t imaxLimit) {
+  std::scoped_lock lock(mutex);
+  subsystems.push_back(
+    {std::move(iname), std::move(imotors), ipriority, iminLimit, imaxLimit, imaxLimit, 0});
+  return subsystems.size() - 1;
+}
+
+void CurrentBudget::setPriority(const std::size_t isubsystem, const int ipriority) {
+  std::scoped_lock lock(mutex);
+  subsystems.at(isubsystem).priority = ipriority;
+}
+
+void CurrentBudget::step() {
+  std::scoped_lock lock(mutex);
+
+  const std::int32_t voltage = battery->getVoltage();
+  const std::int32_t current = battery->getCurrent();
+  if (voltage != okapi::OKAPI_PROS_ERR) {
+    minVoltage = std::min(minVoltage, voltage);
+
+    const std::int32_t floor = params.budget * params.minBudgetShare / 100;
+    if (voltage < params.sagVoltage) {
+      budget = std::max(floor, budget - params.cutStep);
+    } else if (voltage > params.sagVoltage + params.sagRecovery) {
+      budget = std::min(params.budget, budget + params.recoverStep);
+    }
+  }
+
+  std::int32_t totalDraw = 0;
+  for (auto &subsystem : subsystems) {
+    std::int32_t hungriest = 0;
+    for (const auto &motor : subsystem.motors) {
+      const std::int32_t draw = motor->getCurrentDraw();
+      if (draw != okapi::OKAPI_PROS_ERR) {
+        hungriest = std::max(hungriest, draw);
+        totalDraw += draw;
+      }
+    }
+    subsystem.draw += drawFilterGain * (hungriest - subsystem.draw);
+  }
+
+  std::vector<std::size_t> order(subsystems.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](const std::size_t a, const std::size_t b) {
+    return subsystems[a].priority > subsystems[b].priority;
+  });
+
+  // Everyone gets their minimum first
+  std::vector<std::int32_t> limits(subsystems.size());
+  std::int64_t remaining = budget;
+  for (std::size_t i = 0; i < subsystems.size(); i++) {
+    limits[i] = subsystems[i].minLimit;
+    remaining -= static_cast<std::int64_t>(limits[i]) * subsystems[i].motors.size();
+  }
+
+  // Then what each is using, highest priority first, then whatever is left
+  for (const bool leftover : {false, true}) {
+    for (const std::size_t i : order) {
+      const auto &subsystem = subsystems[i];
+      const auto count =
+        static_cast<std::int64_t>(std::max<std::size_t>(1, subsystem.motors.size()));
+
+      std::int32_t want = subsystem.maxLimit;
+      if (!leftover && subsystem.draw < subsystem.limit - params.headroom) {
+        want = std::clamp(static_cast<std::int32_t>(subsystem.draw) + params.headroom,
+                          subsystem.minLimit,
+                          subsystem.maxLimit);
+      }
+
+      const auto extra = static_cast<std::int32_t>(
+        std::clamp<std::int64_t>(std::min<std::int64_t>(want - limits[i], remaining / count),
+                                 0,
+                                 subsystem.maxLimit - limits[i]));
+      limits[i] += extra;
+      remaining -= static_cast<std::int64_t>(extra) * count;
+    }
+  }
+
+  for (std::size_t i = 0; i < subsystems.size(); i++) {
+    apply(subsystems[i], limits[i], voltage);
+  }
+
+  telemetry->send("power",
+                  "%ld,%ld,%ld,%ld",
+                  static_cast<long>(voltage),
+                  static_cast<long>(current),
+                  static_cast<long>(totalDraw),
+                  static_cast<long>(budget));
+}
+
+void CurrentBudget::apply(Subsystem &isubsystem,
+                          const std::int32_t ilimit,
+                          const std::int32_t ivoltage) {
+  // Small changes are not worth a write, but reaching either end always is
+  const bool atEnd = ilimit == isubsystem.minLimit || ilimit == isubsystem.maxLimit;
+  if (ilimit == isubsystem.limit ||
+      (std::abs(ilimit - isubsystem.limit) < params.changeThreshold && !atEnd)) {
+    return;
+  }
+
+  for (const auto &motor : isubsystem.motors) {
+    motor->setCurrentLimit(ilimit);
+  }
+
+  const std::int32_t previous = isubsystem.limit;
+  isubsystem.limit = ilimit;
+
+  const std::string name = isubsystem.name;
+  LOG_INFO("CurrentBudget: " + name + " limit " + std::to_string(previous) + " -> " +
+           std::to_string(ilimit) + " mA, battery " + std::to_string(ivoltage) + " mV");
+  telemetry->send("powerlimit",
+                  "%s,%ld,%ld,%ld",
+                  isubsystem.name.c_str(),
+                  static_cast<long>(previous),
+                  static_cast<long>(ilimit),
+                  static_cast<long>(ivoltage));
+}
+
+std::int32_t CurrentBudget::getLimit(const std::size_t isubsystem) const {
+  std::scoped_lock lock(mutex);
+  return subsystems.at(isubsystem).limit;
+}
+
+std::int32_t CurrentBudget::getBudget() const {
+  std::scoped_lock lock(mutex);
+  return budget;
+}
+
+std::int32_t CurrentBudget::getMinVoltage() const {
+  std::scoped_lock lock(mutex);
+  return minVoltage;
+}
+
+void CurrentBudget::startThread(std::unique_ptr<okapi::AbstractRate> irate,
+                                const okapi::QTime iperiod) {
+  if (!task) {
+    rate = std::move(irate);
+    threadPeriod = iperiod;
+    task = new CrossplatformThread(trampoline, this, "CurrentBudget");
+  }
+}
+
+CrossplatformThread *CurrentBudget::getThread() const {
+  return task;
+}
+
+void CurrentBudget::trampoline(void *context) {
+  if (context) {
+    static_cast<CurrentBudget *>(context)->loop();
+  }
+}
+
+void CurrentBudget::loop() {
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    step();
+    rate->delayUntil(threadPeriod);
+  }
+}
+} // namespace spooder
@@ -0,0 +1,155 @@
+#include "spooder/api/device/motor/forwardingMotor.hpp"
+
+namespace spooder {
+ForwardingMotor::ForwardingMotor(std::shared_ptr<okapi::AbstractMotor> imotor)
+  : motor(std::move(imotor)) {
+}
+
+std::int32_t ForwardingMotor::moveAbsolute(const double iposition, const std::int32_t ivelocity) {
+  return motor->moveAbsolute(iposition, ivelocity);
+}
+
+std::int32_t ForwardingMotor::moveRelative(const double iposition, const std::int32_t ivelocity) {
+  return motor->moveRelative(iposition, ivelocity);
+}
+
+std::int32_t ForwardingMotor::moveVelocity(const std::int16_t ivelocity) {
+  return motor->moveVelocity(ivelocity);
+}
+
+std::int32_t ForwardingMotor::moveVoltage(const std::int16_t ivoltage) {
+  return motor->moveVoltage(ivoltage);
+}
+
+std::int32_t ForwardingMotor::modifyProfiledVelocity(const std::int32_t ivelocity) {
+  return motor->modifyProfiledVelocity(ivelocity);
+}
+
+double ForwardingMotor::getTargetPosition() {
+  return motor->getTargetPosition();
+}
+
+double ForwardingMotor::getPosition() {
+  return motor->getPosition();
+}
+
+std::int32_t ForwardingMotor::tarePosition() {
+  return motor->tarePosition();
+}
+
+std::int32_t ForwardingMotor::getTargetVelocity() {
+  return motor->getTargetVelocity();
+}
+
+double ForwardingMotor::getActualVelocity() {
+  return motor->getActualVelocity();
+}
+
+std::int32_t ForwardingMotor::getCurrentDraw() {
+  return motor->getCurrentDraw();
+}
+
+std::int32_t ForwardingMotor::getDirection() {
+  return motor->getDirection();
+}
+
+double ForwardingMotor::getEfficiency() {
+  return motor->getEfficiency();
+}
+
+std::int32_t ForwardingMotor::isOverCurrent() {
+  return motor->isOverCurrent();
+}
+
+std::int32_t ForwardingMotor::isOverTemp() {
+  return motor->isOverTemp();
+}
+
+std::int32_t ForwardingMotor::isStopped() {
+  return motor->isStopped();
+}
+
+std::int32_t ForwardingMotor::getZeroPositionFlag() {
+  return motor->getZeroPositionFlag();
+}
+
+uint32_t ForwardingMotor::getFaults() {
+  return motor->getFaults();
+}
+
+uint32_t ForwardingMotor::getFlags() {
+  return motor->getFlags();
+}
+
+std::int32_t ForwardingMotor::getRawPosition(std::uint32_t *timestamp) {
+  return motor->getRawPosition(timestamp);
+}
+
+double ForwardingMotor::getPower() {
+  return motor->getPower();
+}
+
+double ForwardingMotor::getTemperature() {
+  return motor->getTemperature();
+}
+
+double ForwardingMotor::getTorque() {
+  return motor->getTorque();
+}
+
+std::int32_t ForwardingMotor::getVoltage() {
+  return motor->getVoltage();
+}
+
+std::int32_t ForwardingMotor::setBrakeMode(const brakeMode imode) {
+  return motor->setBrakeMode(imode);
+}
+
+okapi::AbstractMotor::brakeMode ForwardingMotor::getBrakeMode() {
+  return motor->getBrakeMode();
+}
+
+std::int32_t ForwardingMotor::setCurrentLimit(const std::int32_t ilimit) {
+  return motor->setCurrentLimit(ilimit);
+}
+
+std::int32_t ForwardingMotor::getCurrentLimit() {
+  return motor->getCurrentLimit();
+}
+
+std::int32_t ForwardingMotor::setEncoderUnits(const encoderUnits iunits) {
+  return motor->setEncoderUnits(iunits);
+}
+
+okapi::AbstractMotor::encoderUnits ForwardingMotor::getEncoderUnits() {
+  return motor->getEncoderUnits();
+}
+
+std::int32_t ForwardingMotor::setGearing(const gearset igearset) {
+  return motor->setGearing(igearset);
+}
+
+okapi::AbstractMotor::gearset ForwardingMotor::getGearing() {
+  return motor->getGearing();
+}
+
+std::int32_t ForwardingMotor::setReversed(const bool ireverse) {
+  return motor->setReversed(ireverse);
+}
+
+std::int32_t ForwardingMotor::setVoltageLimit(const std::int32_t ilimit) {
+  return motor->setVoltageLimit(ilimit);
+}
+
+std::shared_ptr<okapi::ContinuousRotarySensor> ForwardingMotor::getEncoder() {
+  return motor->getEncoder();
+}
+
+void ForwardingMotor::controllerSet(const double ivalue) {
+  motor->controllerSet(ivalue);
+}
+
+std::shared_ptr<okapi::AbstractMotor> ForwardingMotor::getMotor() const {
+  return motor;
+}
+} // namespace spooder
@@ -0,0 +1,244 @@
+#include "spooder/api/device/motor/motorCommandBatch.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <algorithm>
+#include <cmath>
+
+#ifdef THREADS_STD
+#include <chrono>
+#endif
+
+namespace spooder {
+namespace {
+std::uint64_t micros() {
+#ifdef THREADS_STD
+  return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                      std::chrono::steady_clock::now().time_since_epoch())
+                                      .count());
+#else
+  return pros::c::micros();
+#endif
+}
+} // namespace
+
+MotorCommandBatch::MotorCommandBatch(const okapi::QTime iresendPeriod,
+                                     std::shared_ptr<Telemetry> itelemetry,
+                                     std::shared_ptr<okapi::Logger> ilogger)
+  : resendMicros(
+      static_cast<std::uint64_t>(std::llround(iresendPeriod.convert(okapi::millisecond) * 1000))),
+    telemetry(std::move(itelemetry)),
+    logger(std::move(ilogger)) {
+}
+
+MotorCommandBatch::~MotorCommandBatch() {
+  dtorCalled.store(true, std::memory_order_release);
+  delete task;
+}
+
+std::shared_ptr<BatchedMotor>
+MotorCommandBatch::add(std::shared_ptr<okapi::AbstractMotor> imotor) {
+  std::scoped_lock lock(mutex);
+  slots.push_back({imotor, {}, {}, 0});
+  return std::make_shared<BatchedMotor>(*this, slots.size() - 1, std::move(imotor));
+}
+
+void MotorCommandBatch::set(const std::size_t islot, const Command &icommand) {
+  std::scoped_lock lock(mutex);
+  auto &pending = slots[islot].pending;
+  if (icommand.type == CommandType::relative && pending.type == CommandType::relative) {
+    pending.position += icommand.position;
+    pending.velocity = icommand.velocity;
+  } else {
+    pending = icommand;
+  }
+}
+
+std::int32_t MotorCommandBatch::reconfigure(const std::size_t islot,
+                                            const std::function<std::int32_t()> &ichange) {
+  std::scoped_lock lock(mutex);
+  slots[islot].sent = {};
+  return ichange();
+}
+
+void MotorCommandBatch::flush() {
+  std::scoped_lock lock(mutex);
+
+  std::size_t flushWritten = 0;
+  std::size_t flushSkipped = 0;
+  std::uint64_t firstWrite = 0;
+  std::uint64_t lastWrite = 0;
+
+  for (auto &slot : slots) {
+    const Command command = slot.pending;
+    slot.pending = {};
+    if (command.type == CommandType::none) {
+      continue;
+    }
+
+    // Relative moves are new moves every time, so they are never the same as the last one
+    const std::uint64_t now = micros();
+    if (command.type != CommandType::relative && command.type == slot.sent.type &&
+        command.position == slot.sent.position && command.velocity == slot.sent.velocity &&
+        now - slot.sentMicros < resendMicros) {
+      flushSkipped++;
+      continue;
+    }
+
+    if (flushWritten == 0) {
+      firstWrite = now;
+    }
+
+    const std::int32_t result = send(*slot.motor, command);
+    lastWrite = micros();
+    flushWritten++;
+
+    if (result == okapi::OKAPI_PROS_ERR) {
+      // Forget what was sent so the next flush tries again instead of skipping it
+      slot.sent = {};
+    } else {
+      slot.sent = command;
+      slot.sentMicros = now;
+    }
+  }
+
+  written += flushWritten;
+  skipped += flushSkipped;
+
+  if (flushWritten > 0) {
+    lastSkew = static_cast<std::uint32_t>(lastWrite - firstWrite);
+    maxSkew = std::max(maxSkew, lastSkew);
+  }
+
+  if (flushWritten > 0 || flushSkipped > 0) {
+    telemetry->send("motorbatch",
+                    "%zu,%zu,%lu",
+                    flushWritten,
+                    flushSkipped,
+                    static_cast<unsigned long>(flushWritten > 0 ? lastSkew : 0));
+  }
+}
+
+void MotorCommandBatch::resend() {
+  std::scoped_lock lock(mutex);
+  for (auto &slot : slots) {
+    if (slot.pending.type == CommandType::none && slot.sent.type != CommandType::relative) {
+      slot.pending = slot.sent;
+    }
+    slot.sent = {};
+  }
+}
+
+std::int32_t MotorCommandBatch::send(okapi::AbstractMotor &imotor, const Command &icommand) {
+  switch (icommand.type) {
+  case CommandType::absolute:
+    return imotor.moveAbsolute(icommand.position, icommand.velocity);
+  case CommandType::relative:
+    return imotor.moveRelative(icommand.position, icommand.velocity);
+  case CommandType::velocity:
+    return imotor.moveVelocity(static_cast<std::int16_t>(icommand.velocity));
+  case CommandType::voltage:
+    return imotor.moveVoltage(static_cast<std::int16_t>(icommand.velocity));
+  case CommandType::none:
+    break;
+  }
+  return 1;
+}
+
+std::uint32_t MotorCommandBatch::getLastSkew() const {
+  std::scoped_lock lock(mutex);
+  return lastSkew;
+}
+
+std::uint32_t MotorCommandBatch::getMaxSkew() const {
+  std::scoped_lock lock(mutex);
+  return maxSkew;
+}
+
+std::size_t MotorCommandBatch::getWritten() const {
+  std::scoped_lock lock(mutex);
+  return written;
+}
+
+std::size_t MotorCommandBatch::getSkipped() const {
+  std::scoped_lock lock(mutex);
+  return skipped;
+}
+
+void MotorCommandBatch::startThread(std::unique_ptr<okapi::AbstractRate> irate,
+                                    const okapi::QTime iperiod) {
+  if (!task) {
+    rate = std::move(irate);
+    threadPeriod = iperiod;
+    task = new CrossplatformThread(trampoline, this, "MotorCommandBatch");
+  }
+}
+
+void MotorCommandBatch::setAutoFlush(const bool ienabled) {
+  autoFlush.store(ienabled, std::memory_order_release);
+}
+
+CrossplatformThread *MotorCommandBatch::getThread() const {
+  return task;
+}
+
+void MotorCommandBatch::trampoline(void *context) {
+  if (context) {
+    static_cast<MotorCommandBatch *>(context)->loop();
+  }
+}
+
+void MotorCommandBatch::loop() {
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    if (autoFlush.load(std::memory_order_acquire)) {
+      flush();
+    }
+    rate->delayUntil(threadPeriod);
+  }
+}
+
+BatchedMotor::BatchedMotor(MotorCommandBatch &ibatch,
+                           const std::size_t islot,
+                           std::shared_ptr<okapi::AbstractMotor> imotor)
+  : ForwardingMotor(std::move(imotor)), batch(ibatch), slot(islot) {
+}
+
+std::int32_t BatchedMotor::moveAbsolute(const double iposition, const std::int32_t ivelocity) {
+  batch.set(slot, {MotorCommandBatch::CommandType::absolute, iposition, ivelocity});
+  return 1;
+}
+
+std::int32_t BatchedMotor::moveRelative(const double iposition, const std::int32_t ivelocity) {
+  batch.set(slot, {MotorCommandBatch::CommandType::relative, iposition, ivelocity});
+  return 1;
+}
+
+std::int32_t BatchedMotor::moveVelocity(const std::int16_t ivelocity) {
+  batch.set(slot, {MotorCommandBatch::CommandType::velocity, 0, ivelocity});
+  return 1;
+}
+
+std::int32_t BatchedMotor::moveVoltage(const std::int16_t ivoltage) {
+  batch.set(slot, {MotorCommandBatch::CommandType::voltage, 0, ivoltage});
+  return 1;
+}
+
+std::int32_t BatchedMotor::tarePosition() {
+  return batch.reconfigure(slot, [this]() { return motor->tarePosition(); });
+}
+
+std::int32_t BatchedMotor::setEncoderUnits(const encoderUnits iunits) {
+  return batch.reconfigure(slot, [&]() { return motor->setEncoderUnits(iunits); });
+}
+
+std::int32_t BatchedMotor::setGearing(const gearset igearset) {
+  return batch.reconfigure(slot, [&]() { return motor->setGearing(igearset); });
+}
+
+std::int32_t BatchedMotor::setReversed(const bool ireverse) {
+  return batch.reconfigure(slot, [&]() { return motor->setReversed(ireverse); });
+}
+
+void BatchedMotor::controllerSet(const double ivalue) {
+  // Same as okapi::Motor::controllerSet
+  moveVelocity(static_cast<std::int16_t>(ivalue * okapi::toUnderlyingType(getGearing())));
+}
+} // namespace spooder
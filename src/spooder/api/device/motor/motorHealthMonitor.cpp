@@ -0,0 +1,292 @@
+#include "spooder/api/device/motor/motorHealthMonitor.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace spooder {
+MotorHealthMonitor::MotorHealthMonitor(const okapi::TimeUtil &itimeUtil,
+                                       const MotorHealthParams &iparams,
+                                       std::shared_ptr<Telemetry> itelemetry,
+                                       std::shared_ptr<okapi::Logger> ilogger)
+  : timer(itimeUtil.getTimer()),
+    params(iparams),
+    telemetry(std::move(itelemetry)),
+    logger(std::move(ilogger)) {
+}
+
+MotorHealthMonitor::~MotorHealthMonitor() {
+  dtorCalled.store(true, std::memory_order_release);
+  delete task;
+}
+
+std::shared_ptr<DeratedMotor>
+MotorHealthMonitor::add(std::string iname, std::shared_ptr<okapi::AbstractMotor> imotor) {
+  std::scoped_lock lock(mutex);
+  entries.push_back({std::move(iname), imotor, {}});
+  return std::make_shared<DeratedMotor>(*this, entries.size() - 1, std::move(imotor));
+}
+
+void MotorHealthMonitor::setOnScaleChange(std::function<void()> icallback) {
+  std::scoped_lock lock(mutex);
+  onScaleChange = std::move(icallback);
+}
+
+void MotorHealthMonitor::step() {
+  bool scaleChanged = false;
+  std::function<void()> callback;
+  {
+    std::scoped_lock lock(mutex);
+    scaleChanged = stepLocked();
+    callback = onScaleChange;
+  }
+
+  // Outside the lock, since sending a voltage command asks this monitor for its scale
+  if (scaleChanged && callback) {
+    callback();
+  }
+}
+
+bool MotorHealthMonitor::stepLocked() {
+  const okapi::QTime now = timer->millis();
+  const double dt = stepped ? (now - lastStep).convert(okapi::second) : 0;
+  lastStep = now;
+  stepped = true;
+
+  bool scaleChanged = false;
+  for (auto &entry : entries) {
+    scaleChanged |= update(entry, dt);
+
+    const auto &health = entry.health;
+    telemetry->send("health",
+                    "%s,%.0f,%.1f,%ld,%.0f,%lu,%.1f,%.2f",
+                    entry.name.c_str(),
+                    health.temperature,
+                    health.estimate,
+                    static_cast<long>(health.current),
+                    health.efficiency,
+                    static_cast<unsigned long>(health.faults),
+                    health.timeToLimit,
+                    health.scale);
+  }
+  return scaleChanged;
+}
+
+bool MotorHealthMonitor::update(Entry &ientry, const double idt) {
+  auto &health = ientry.health;
+  auto &motor = *ientry.motor;
+
+  const double temperature = motor.getTemperature();
+  const std::int32_t current = motor.getCurrentDraw();
+  const double efficiency = motor.getEfficiency();
+  const std::uint32_t faults = motor.getFaults();
+  const std::int32_t overTemp = motor.isOverTemp();
+  const std::int32_t overCurrent = motor.isOverCurrent();
+
+  if (std::isfinite(temperature)) {
+    health.temperature = temperature;
+  }
+  if (current != okapi::OKAPI_PROS_ERR) {
+    health.current = current;
+  }
+  if (std::isfinite(efficiency)) {
+    health.efficiency = efficiency;
+  }
+  if (overTemp != okapi::OKAPI_PROS_ERR) {
+    health.overTemp = overTemp == 1;
+  }
+  if (overCurrent != okapi::OKAPI_PROS_ERR) {
+    health.overCurrent = overCurrent == 1;
+  }
+
+  const std::string name = ientry.name;
+  if (faults != static_cast<std::uint32_t>(okapi::OKAPI_PROS_ERR) && faults != health.faults) {
+    LOG_INFO("MotorHealthMonitor: " + name + " faults " + std::to_string(health.faults) + " -> " +
+             std::to_string(faults));
+    health.faults = faults;
+  }
+
+  if (!ientry.seeded) {
+    if (!std::isfinite(temperature)) {
+      return false;
+    }
+    health.estimate = temperature;
+    ientry.seeded = true;
+  }
+
+  const double amps = health.current / 1000.0;
+  const double steady = params.ambient + params.heatingRate * amps * amps;
+  health.estimate += (steady - health.estimate) * (1 - std::exp(-idt / params.timeConstant));
+
+  // The reported temperature only moves in steps, so the model fills in between them but is never
+  // allowed to leave the step the motor reports
+  health.estimate =
+    std::clamp(health.estimate, health.temperature, health.temperature + temperatureStep);
+
+  health.timeToLimit = predictTimeToLimit(health.estimate, amps);
+
+  const double previous = health.scale;
+  const double target = targetScale(health);
+  if (target < health.scale) {
+    health.scale = std::max(target, health.scale - params.derateRate * idt);
+  } else {
+    health.scale = std::min(target, health.scale + params.recoverRate * idt);
+  }
+
+  if (previous == 1 && health.scale < 1) {
+    const double estimate = health.estimate;
+    const double timeToLimit = health.timeToLimit;
+    LOG_INFO("MotorHealthMonitor: Derating " + name + " at " + std::to_string(estimate) +
+             " C, " + std::to_string(timeToLimit) + " s to the limit");
+  } else if (previous < 1 && health.scale == 1) {
+    LOG_INFO("MotorHealthMonitor: " + name + " recovered");
+  }
+
+  applyLimit(ientry);
+  return health.scale != previous;
+}
+
+double MotorHealthMonitor::predictTimeToLimit(const double iestimate, const double iamps) const {
+  if (iestimate >= params.limit) {
+    return 0;
+  }
+
+  const double steady = params.ambient + params.heatingRate * iamps * iamps;
+  if (steady <= params.limit) {
+    return std::numeric_limits<double>::infinity();
+  }
+
+  // Solve steady - (steady - estimate) * e^(-t / tau) = limit for t
+  return params.timeConstant * std::log((steady - iestimate) / (steady - params.limit));
+}
+
+double MotorHealthMonitor::targetScale(const MotorHealth &ihealth) const {
+  const double range = 1 - params.minScale;
+
+  const double heat = std::clamp(
+    (ihealth.estimate - params.derateStart) / (params.limit - params.derateStart), 0.0, 1.0);
+  double scale = 1 - range * heat;
+
+  if (ihealth.timeToLimit < params.warningTime) {
+    scale = std::min(scale, 1 - range * (1 - ihealth.timeToLimit / params.warningTime));
+  }
+
+  return scale;
+}
+
+void MotorHealthMonitor::applyLimit(Entry &ientry) {
+  const auto limit =
+    static_cast<std::int32_t>(std::lround(ientry.requestedLimit * ientry.health.scale));
+
+  // Small changes are not worth a write, but getting back to the full limit always is
+  if (limit == ientry.appliedLimit ||
+      (std::abs(limit - ientry.appliedLimit) < limitThreshold && limit != ientry.requestedLimit)) {
+    return;
+  }
+
+  if (ientry.motor->setCurrentLimit(limit) != okapi::OKAPI_PROS_ERR) {
+    ientry.appliedLimit = limit;
+  }
+}
+
+std::int16_t MotorHealthMonitor::scaleVoltage(const std::size_t imotor,
+                                              const std::int16_t ivoltage) const {
+  std::scoped_lock lock(mutex);
+  return static_cast<std::int16_t>(std::lround(ivoltage * entries.at(imotor).health.scale));
+}
+
+std::int32_t MotorHealthMonitor::setRequestedLimit(const std::size_t imotor,
+                                                   const std::int32_t ilimit) {
+  std::scoped_lock lock(mutex);
+  auto &entry = entries.at(imotor);
+  entry.requestedLimit = ilimit;
+
+  const auto limit = static_cast<std::int32_t>(std::lround(ilimit * entry.health.scale));
+  const std::int32_t result = entry.motor->setCurrentLimit(limit);
+  if (result != okapi::OKAPI_PROS_ERR) {
+    entry.appliedLimit = limit;
+  }
+  return result;
+}
+
+std::int32_t MotorHealthMonitor::getRequestedLimit(const std::size_t imotor) const {
+  std::scoped_lock lock(mutex);
+  return entries.at(imotor).requestedLimit;
+}
+
+MotorHealth MotorHealthMonitor::getHealth(const std::size_t imotor) const {
+  std::scoped_lock lock(mutex);
+  return entries.at(imotor).health;
+}
+
+std::string MotorHealthMonitor::getName(const std::size_t imotor) const {
+  std::scoped_lock lock(mutex);
+  return entries.at(imotor).name;
+}
+
+std::size_t MotorHealthMonitor::getWorst() const {
+  std::scoped_lock lock(mutex);
+  std::size_t worst = 0;
+  for (std::size_t i = 1; i < entries.size(); i++) {
+    const auto &health = entries[i].health;
+    const auto &worstHealth = entries[worst].health;
+    if (health.timeToLimit < worstHealth.timeToLimit ||
+        (health.timeToLimit == worstHealth.timeToLimit &&
+         health.estimate > worstHealth.estimate)) {
+      worst = i;
+    }
+  }
+  return worst;
+}
+
+bool MotorHealthMonitor::isDerating() const {
+  std::scoped_lock lock(mutex);
+  return std::any_of(entries.begin(), entries.end(), [](const Entry &entry) {
+    return entry.health.scale < 1;
+  });
+}
+
+void MotorHealthMonitor::startThread(std::unique_ptr<okapi::AbstractRate> irate,
+                                     const okapi::QTime iperiod) {
+  if (!task) {
+    rate = std::move(irate);
+    threadPeriod = iperiod;
+    task = new CrossplatformThread(trampoline, this, "MotorHealthMonitor");
+  }
+}
+
+CrossplatformThread *MotorHealthMonitor::getThread() const {
+  return task;
+}
+
+void MotorHealthMonitor::trampoline(void *context) {
+  if (context) {
+    static_cast<MotorHealthMonitor *>(context)->loop();
+  }
+}
+
+void MotorHealthMonitor::loop() {
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    step();
+    rate->delayUntil(threadPeriod);
+  }
+}
+
+DeratedMotor::DeratedMotor(MotorHealthMonitor &imonitor,
+                           const std::size_t iindex,
+                           std::shared_ptr<okapi::AbstractMotor> imotor)
+  : ForwardingMotor(std::move(imotor)), monitor(imonitor), index(iindex) {
+}
+
+std::int32_t DeratedMotor::moveVoltage(const std::int16_t ivoltage) {
+  return motor->moveVoltage(monitor.scaleVoltage(index, ivoltage));
+}
+
+std::int32_t DeratedMotor::setCurrentLimit(const std::int32_t ilimit) {
+  return monitor.setRequestedLimit(index, ilimit);
+}
+
+std::int32_t DeratedMotor::getCurrentLimit() {
+  return monitor.getRequestedLimit(index);
+}
+} // namespace spooder
@@ -0,0 +1,244 @@
+#include "spooder/api/device/motor/simulatedMotor.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include "spooder/api/device/rotarysensor/simulatedEncoder.hpp"
+#include <cmath>
+
+namespace spooder {
+SimulatedMotor::SimulatedMotor(std::shared_ptr<DrivetrainSimulator> isimulator,
+                               std::vector<std::size_t> imotors,
+                               const bool ireversed,
+                               const gearset igearset,
+                               const encoderUnits iencoderUnits)
+  : simulator(std::move(isimulator)),
+    motors(std::move(imotors)),
+    offsets(motors.size(), 0),
+    reversed(ireversed ? -1 : 1),
+    gearing(igearset),
+    units(iencoderUnits) {
+}
+
+std::int32_t SimulatedMotor::moveAbsolute(const double iposition, const std::int32_t ivelocity) {
+  targetPosition = iposition;
+  profiledVelocity = std::abs(ivelocity) / gearingScale();
+  for (std::size_t i = 0; i < motors.size(); i++) {
+    simulator->setCommand(motors[i],
+                          {DrivetrainSimulator::MotorMode::position,
+                           fromUnits(iposition) * reversed + offsets[i],
+                           profiledVelocity});
+  }
+  return 1;
+}
+
+std::int32_t SimulatedMotor::moveRelative(const double iposition, const std::int32_t ivelocity) {
+  return moveAbsolute(getPosition() + iposition, ivelocity);
+}
+
+std::int32_t SimulatedMotor::moveVelocity(const std::int16_t ivelocity) {
+  targetVelocity = ivelocity;
+  send(DrivetrainSimulator::MotorMode::velocity, ivelocity / gearingScale() * reversed);
+  return 1;
+}
+
+std::int32_t SimulatedMotor::moveVoltage(const std::int16_t ivoltage) {
+  send(DrivetrainSimulator::MotorMode::voltage, ivoltage / 1000.0 * reversed);
+  return 1;
+}
+
+std::int32_t SimulatedMotor::modifyProfiledVelocity(const std::int32_t ivelocity) {
+  return moveAbsolute(targetPosition, ivelocity);
+}
+
+double SimulatedMotor::getTargetPosition() {
+  return targetPosition;
+}
+
+double SimulatedMotor::getPosition() {
+  return toUnits((simulator->getReading(motors.front()).position - offsets.front()) * reversed);
+}
+
+std::int32_t SimulatedMotor::tarePosition() {
+  for (std::size_t i = 0; i < motors.size(); i++) {
+    offsets[i] = simulator->getReading(motors[i]).position;
+  }
+  return 1;
+}
+
+std::int32_t SimulatedMotor::getTargetVelocity() {
+  return targetVelocity;
+}
+
+double SimulatedMotor::getActualVelocity() {
+  return simulator->getReading(motors.front()).velocity * gearingScale() * reversed;
+}
+
+std::int32_t SimulatedMotor::getCurrentDraw() {
+  return static_cast<std::int32_t>(std::abs(simulator->getReading(motors.front()).current) * 1000);
+}
+
+std::int32_t SimulatedMotor::getDirection() {
+  return (getActualVelocity() < 0) ? -1 : 1;
+}
+
+double SimulatedMotor::getEfficiency() {
+  const auto reading = simulator->getReading(motors.front());
+  const double in = reading.voltage * reading.current;
+  const double out = reading.torque * reading.velocity / 9.5492965855137;
+  return (in > 0 && out > 0) ? 100 * out / in : 0;
+}
+
+std::int32_t SimulatedMotor::isOverCurrent() {
+  const double current = std::abs(simulator->getReading(motors.front()).current) * 1000;
+  return current >= currentLimit ? 1 : 0;
+}
+
+std::int32_t SimulatedMotor::isOverTemp() {
+  return 0;
+}
+
+std::int32_t SimulatedMotor::isStopped() {
+  return simulator->getReading(motors.front()).velocity == 0 ? 1 : 0;
+}
+
+std::int32_t SimulatedMotor::getZeroPositionFlag() {
+  return getPosition() == 0 ? 1 : 0;
+}
+
+uint32_t SimulatedMotor::getFaults() {
+  return 0;
+}
+
+uint32_t SimulatedMotor::getFlags() {
+  return 0;
+}
+
+std::int32_t SimulatedMotor::getRawPosition(std::uint32_t *timestamp) {
+  const auto reading = simulator->getReading(motors.front());
+  if (timestamp) {
+    *timestamp = static_cast<std::uint32_t>(reading.timestamp.convert(okapi::millisecond));
+  }
+
+  const double tpr = okapi::gearsetToTPR(simulator->getParameters().gearset.internalGearset);
+  return static_cast<std::int32_t>(std::lround(reading.position / 360 * tpr * reversed));
+}
+
+double SimulatedMotor::getPower() {
+  const auto reading = simulator->getReading(motors.front());
+  return std::abs(reading.voltage * reading.current);
+}
+
+double SimulatedMotor::getTemperature() {
+  return 25;
+}
+
+double SimulatedMotor::getTorque() {
+  return simulator->getReading(motors.front()).torque * reversed;
+}
+
+std::int32_t SimulatedMotor::getVoltage() {
+  return static_cast<std::int32_t>(simulator->getReading(motors.front()).voltage * 1000 * reversed);
+}
+
+std::int32_t SimulatedMotor::setBrakeMode(const brakeMode imode) {
+  brake = imode;
+  for (const auto motor : motors) {
+    simulator->setBrakeMode(motor, imode);
+  }
+  return 1;
+}
+
+okapi::AbstractMotor::brakeMode SimulatedMotor::getBrakeMode() {
+  return brake;
+}
+
+std::int32_t SimulatedMotor::setCurrentLimit(const std::int32_t ilimit) {
+  currentLimit = ilimit;
+  for (const auto motor : motors) {
+    simulator->setCurrentLimit(motor, ilimit / 1000.0);
+  }
+  return 1;
+}
+
+std::int32_t SimulatedMotor::getCurrentLimit() {
+  return currentLimit;
+}
+
+std::int32_t SimulatedMotor::setEncoderUnits(const encoderUnits iunits) {
+  units = iunits;
+  return 1;
+}
+
+okapi::AbstractMotor::encoderUnits SimulatedMotor::getEncoderUnits() {
+  return units;
+}
+
+std::int32_t SimulatedMotor::setGearing(const gearset igearset) {
+  if (igearset == gearset::invalid) {
+    return okapi::OKAPI_PROS_ERR;
+  }
+
+  gearing = igearset;
+  return 1;
+}
+
+okapi::AbstractMotor::gearset SimulatedMotor::getGearing() {
+  return gearing;
+}
+
+std::int32_t SimulatedMotor::setReversed(const bool ireverse) {
+  reversed = ireverse ? -1 : 1;
+  return 1;
+}
+
+std::int32_t SimulatedMotor::setVoltageLimit(const std::int32_t ilimit) {
+  voltageLimit = ilimit;
+  for (const auto motor : motors) {
+    simulator->setVoltageLimit(motor, ilimit / 1000.0);
+  }
+  return 1;
+}
+
+std::shared_ptr<okapi::ContinuousRotarySensor> SimulatedMotor::getEncoder() {
+  return std::make_shared<SimulatedEncoder>(simulator, motors.front(), reversed < 0);
+}
+
+void SimulatedMotor::controllerSet(const double ivalue) {
+  moveVelocity(static_cast<std::int16_t>(ivalue * okapi::toUnderlyingType(gearing)));
+}
+
+double SimulatedMotor::gearingScale() const {
+  const auto physical = simulator->getParameters().gearset.internalGearset;
+  return static_cast<double>(okapi::gearsetToTPR(physical)) / okapi::gearsetToTPR(gearing);
+}
+
+double SimulatedMotor::toUnits(const double idegrees) const {
+  switch (units) {
+  case encoderUnits::rotations:
+    return idegrees * gearingScale() / 360;
+  case encoderUnits::counts:
+    return idegrees / 360 *
+           okapi::gearsetToTPR(simulator->getParameters().gearset.internalGearset);
+  default:
+    return idegrees * gearingScale();
+  }
+}
+
+double SimulatedMotor::fromUnits(const double iposition) const {
+  switch (units) {
+  case encoderUnits::rotations:
+    return iposition * 360 / gearingScale();
+  case encoderUnits::counts:
+    return iposition * 360 /
+           okapi::gearsetToTPR(simulator->getParameters().gearset.internalGearset);
+  default:
+    return iposition / gearingScale();
+  }
+}
+
+void SimulatedMotor::send(const DrivetrainSimulator::MotorMode imode,
+                          const double itarget,
+                          const double imaxVelocity) {
+  for (const auto motor : motors) {
+    simulator->setCommand(motor, {imode, itarget, imaxVelocity});
+  }
+}
+} // namespace spooder
@@ -0,0 +1,70 @@
+#include "spooder/api/device/motor/voltageCompensator.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace spooder {
+VoltageCompensator::VoltageCompensator(std::shared_ptr<AbstractBattery> ibattery,
+                                       const okapi::TimeUtil &itimeUtil,
+                                       const std::int32_t inominalVoltage,
+                                       const okapi::QTime ifilterTime,
+                                       const okapi::QTime isamplePeriod,
+                                       std::shared_ptr<okapi::Logger> ilogger)
+  : battery(std::move(ibattery)),
+    timer(itimeUtil.getTimer()),
+    nominalVoltage(inominalVoltage),
+    filterTime(ifilterTime.convert(okapi::second)),
+    samplePeriod(isamplePeriod.convert(okapi::second)),
+    logger(std::move(ilogger)) {
+}
+
+std::shared_ptr<CompensatedMotor>
+VoltageCompensator::compensate(std::shared_ptr<okapi::AbstractMotor> imotor) {
+  return std::make_shared<CompensatedMotor>(*this, std::move(imotor));
+}
+
+std::int16_t VoltageCompensator::scale(const std::int16_t ivoltage) {
+  const double voltage = getFilteredVoltage();
+  const double scaled = ivoltage * nominalVoltage / voltage;
+  return static_cast<std::int16_t>(std::lround(std::clamp(scaled, -12000.0, 12000.0)));
+}
+
+double VoltageCompensator::getFilteredVoltage() {
+  std::scoped_lock lock(mutex);
+  update();
+  return seeded ? filtered : nominalVoltage;
+}
+
+void VoltageCompensator::update() {
+  const okapi::QTime now = timer->millis();
+  const double dt = (now - lastRead).convert(okapi::second);
+  if (seeded && dt < samplePeriod) {
+    return;
+  }
+
+  const std::int32_t reading = battery->getVoltage();
+  if (reading == okapi::OKAPI_PROS_ERR || reading <= 0) {
+    return;
+  }
+
+  lastRead = now;
+  if (!seeded) {
+    filtered = reading;
+    seeded = true;
+    LOG_INFO("VoltageCompensator: Battery at " + std::to_string(reading) + " mV");
+    return;
+  }
+
+  // Exponential filter with the gain for this dt, so a late read is weighted for how late it is
+  filtered += (dt / (filterTime + dt)) * (reading - filtered);
+}
+
+CompensatedMotor::CompensatedMotor(VoltageCompensator &icompensator,
+                                   std::shared_ptr<okapi::AbstractMotor> imotor)
+  : ForwardingMotor(std::move(imotor)), compensator(icompensator) {
+}
+
+std::int32_t CompensatedMotor::moveVoltage(const std::int16_t ivoltage) {
+  return motor->moveVoltage(compensator.scale(ivoltage));
+}
+} // namespace spooder
@@ -0,0 +1,22 @@
+#include "spooder/api/device/rotarysensor/simulatedEncoder.hpp"
+
+namespace spooder {
+SimulatedEncoder::SimulatedEncoder(std::shared_ptr<DrivetrainSimulator> isimulator,
+                                   const std::size_t imotor,
+                                   const bool ireversed)
+  : simulator(std::move(isimulator)), motor(imotor), reversed(ireversed ? -1 : 1) {
+}
+
+double SimulatedEncoder::get() const {
+  return (simulator->getReading(motor).position - offset) * reversed;
+}
+
+std::int32_t SimulatedEncoder::reset() {
+  offset = simulator->getReading(motor).position;
+  return 1;
+}
+
+double SimulatedEncoder::controllerGet() {
+  return get();
+}
+} // namespace spooder
@@ -0,0 +1,164 @@
+#include "spooder/api/util/inputLog.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace spooder {
+static constexpr std::uint8_t magic[4] = {'S', 'P', 'I', 'L'};
+static constexpr std::uint8_t version = 1;
+
+float InputFrame::getAnalog(const std::size_t ichannel) const {
+  return ichannel < analogChannels ? analog[ichannel] / 127.0f : 0;
+}
+
+bool InputFrame::getDigital(const std::size_t ibutton) const {
+  return ibutton < buttons && (digital >> ibutton) & 1;
+}
+
+void InputFrame::setDigital(const std::size_t ibutton, const bool ipressed) {
+  if (ibutton >= buttons) {
+    return;
+  }
+
+  if (ipressed) {
+    digital |= static_cast<std::uint16_t>(1u << ibutton);
+  } else {
+    digital &= static_cast<std::uint16_t>(~(1u << ibutton));
+  }
+}
+
+bool InputFrame::operator==(const InputFrame &other) const {
+  return analog == other.analog && digital == other.digital;
+}
+
+bool InputLog::read(FILE *ifile, InputLog &olog) {
+  std::uint8_t header[headerSize];
+  if (!ifile || fread(header, 1, headerSize, ifile) != headerSize ||
+      !std::equal(magic, magic + 4, header) || header[4] != version) {
+    return false;
+  }
+
+  olog.tickPeriod = (header[6] | header[7] << 8) * okapi::millisecond;
+  olog.frames.clear();
+
+  std::uint8_t bytes[frameSize];
+  while (fread(bytes, 1, frameSize, ifile) == frameSize) {
+    InputFrame frame;
+    for (std::size_t i = 0; i < InputFrame::analogChannels; i++) {
+      frame.analog[i] = static_cast<std::int8_t>(bytes[i]);
+    }
+    frame.digital = static_cast<std::uint16_t>(bytes[4] | bytes[5] << 8);
+    olog.frames.push_back(frame);
+  }
+
+  return true;
+}
+
+std::shared_ptr<InputLog> InputLog::load(const char *ipath) {
+  FILE *file = fopen(ipath, "rb");
+  if (!file) {
+    return nullptr;
+  }
+
+  auto log = std::make_shared<InputLog>();
+  const bool ok = read(file, *log);
+  fclose(file);
+  return ok ? log : nullptr;
+}
+
+InputRecorder::InputRecorder(const char *ipath,
+                             const okapi::QTime itickPeriod,
+                             const std::size_t iflushFrames)
+  : file(fopen(ipath, "wb")), flushFrames(std::max<std::size_t>(1, iflushFrames)) {
+  if (!file) {
+    return;
+  }
+
+  const auto period = static_cast<std::uint16_t>(
+    std::clamp(std::lround(itickPeriod.convert(okapi::millisecond)), 1l, 65535l));
+  const std::uint8_t header[InputLog::headerSize] = {magic[0],
+                                                     magic[1],
+                                                     magic[2],
+                                                     magic[3],
+                                                     version,
+                                                     0,
+                                                     static_cast<std::uint8_t>(period & 0xff),
+                                                     static_cast<std::uint8_t>(period >> 8)};
+  fwrite(header, 1, sizeof(header), file);
+  fflush(file);
+}
+
+InputRecorder::~InputRecorder() {
+  if (file) {
+    fclose(file);
+  }
+}
+
+std::string InputRecorder::unusedPath(const char *ipattern, const unsigned imax) {
+  char path[64];
+  for (unsigned i = 0; i < imax; i++) {
+    std::snprintf(path, sizeof(path), ipattern, i);
+    FILE *existing = fopen(path, "rb");
+    if (!existing) {
+      return path;
+    }
+    fclose(existing);
+  }
+  return {};
+}
+
+bool InputRecorder::isEnabled() const {
+  return file != nullptr;
+}
+
+void InputRecorder::record(const InputFrame &iframe) {
+  if (!file) {
+    return;
+  }
+
+  const std::uint8_t bytes[InputLog::frameSize] = {
+    static_cast<std::uint8_t>(iframe.analog[0]),
+    static_cast<std::uint8_t>(iframe.analog[1]),
+    static_cast<std::uint8_t>(iframe.analog[2]),
+    static_cast<std::uint8_t>(iframe.analog[3]),
+    static_cast<std::uint8_t>(iframe.digital & 0xff),
+    static_cast<std::uint8_t>(iframe.digital >> 8)};
+  fwrite(bytes, 1, sizeof(bytes), file);
+
+  if (++frameCount % flushFrames == 0) {
+    fflush(file);
+  }
+}
+
+std::size_t InputRecorder::getFrameCount() const {
+  return frameCount;
+}
+
+InputReplay::InputReplay(std::shared_ptr<const InputLog> ilog) : log(std::move(ilog)) {
+}
+
+bool InputReplay::step() {
+  if (tick >= log->frames.size()) {
+    frame = InputFrame{};
+    return false;
+  }
+
+  frame = log->frames[tick++];
+  return true;
+}
+
+const InputFrame &InputReplay::getFrame() const {
+  return frame;
+}
+
+bool InputReplay::isFinished() const {
+  return tick >= log->frames.size();
+}
+
+std::size_t InputReplay::getTick() const {
+  return tick;
+}
+
+const InputLog &InputReplay::getLog() const {
+  return *log;
+}
+} // namespace spooder
@@ -0,0 +1,113 @@
+#include "spooder/api/util/settleEvent.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace spooder {
+#ifdef THREADS_STD
+SettleEvent::SettleEvent() = default;
+
+SettleEvent::~SettleEvent() = default;
+
+void SettleEvent::set() {
+  {
+    std::scoped_lock lock(mutex);
+    if (flag) {
+      return;
+    }
+    flag = true;
+  }
+  cv.notify_all();
+
+  if (const auto next = listener.load(std::memory_order_acquire)) {
+    next->set();
+  }
+}
+
+void SettleEvent::clear() {
+  std::scoped_lock lock(mutex);
+  flag = false;
+}
+
+bool SettleEvent::isSet() const {
+  std::scoped_lock lock(mutex);
+  return flag;
+}
+
+void SettleEvent::wait() {
+  std::unique_lock lock(mutex);
+  cv.wait(lock, [&] { return flag; });
+}
+
+bool SettleEvent::wait(const okapi::QTime itimeout) {
+  const auto timeout = std::chrono::microseconds(
+    std::llround(std::max(0.0, itimeout.convert(okapi::millisecond)) * 1000));
+  std::unique_lock lock(mutex);
+  return cv.wait_for(lock, timeout, [&] { return flag; });
+}
+#else
+SettleEvent::SettleEvent() : sem(pros::c::sem_binary_create()) {
+}
+
+SettleEvent::~SettleEvent() {
+  pros::c::sem_delete(sem);
+}
+
+void SettleEvent::set() {
+  // Only post on the transition so a controller reporting settled every step costs nothing
+  if (!flag.exchange(true, std::memory_order_acq_rel)) {
+    pros::c::sem_post(sem);
+
+    if (const auto next = listener.load(std::memory_order_acquire)) {
+      next->set();
+    }
+  }
+}
+
+void SettleEvent::clear() {
+  if (flag.exchange(false, std::memory_order_acq_rel)) {
+    pros::c::sem_wait(sem, 0);
+  }
+}
+
+bool SettleEvent::isSet() const {
+  return flag.load(std::memory_order_acquire);
+}
+
+void SettleEvent::wait() {
+  waitMillis(TIMEOUT_MAX);
+}
+
+bool SettleEvent::wait(const okapi::QTime itimeout) {
+  const double timeout = std::max(0.0, itimeout.convert(okapi::millisecond));
+  return waitMillis(timeout >= TIMEOUT_MAX ? TIMEOUT_MAX - 1
+                                           : static_cast<std::uint32_t>(std::ceil(timeout)));
+}
+
+bool SettleEvent::waitMillis(const std::uint32_t itimeout) {
+  const std::uint32_t start = pros::c::millis();
+  while (!flag.load(std::memory_order_acquire)) {
+    std::uint32_t remaining = TIMEOUT_MAX;
+    if (itimeout != TIMEOUT_MAX) {
+      const std::uint32_t elapsed = pros::c::millis() - start;
+      if (elapsed >= itimeout) {
+        return false;
+      }
+      remaining = itimeout - elapsed;
+    }
+
+    if (!pros::c::sem_wait(sem, remaining)) {
+      return flag.load(std::memory_order_acquire);
+    }
+  }
+
+  // The semaphore wakes one task at a time, so pass the wakeup on to the next waiting task. A post
+  // left over after the flag is cleared only causes one spurious wakeup, which the loop absorbs.
+  pros::c::sem_post(sem);
+  return true;
+}
+#endif
+void SettleEvent::setListener(SettleEvent *ilistener) {
+  listener.store(ilistener, std::memory_order_release);
+}
+} // namespace spooder
@@ -0,0 +1,46 @@
+#include "spooder/api/util/simulatedTime.hpp"
+
+namespace spooder {
+SimulatedTimer::SimulatedTimer(std::shared_ptr<SimulationClock> iclock)
+  : okapi::AbstractTimer(iclock->getTime()), clock(std::move(iclock)) {
+}
+
+okapi::QTime SimulatedTimer::millis() const {
+  return clock->getTime();
+}
+
+SimulatedRate::SimulatedRate(std::shared_ptr<SimulationClock> iclock)
+  : clock(std::move(iclock)), lastTime(clock->getTime()) {
+}
+
+void SimulatedRate::delay(const okapi::QFrequency ihz) {
+  delayUntil(okapi::second / ihz.convert(okapi::Hz));
+}
+
+void SimulatedRate::delayUntil(const okapi::QTime itime) {
+  // Like task_delay_until, the wake time advances by exactly itime even if the caller ran late
+  lastTime += itime;
+  clock->advanceTo(lastTime);
+}
+
+void SimulatedRate::delayUntil(const uint32_t ims) {
+  delayUntil(ims * okapi::millisecond);
+}
+
+okapi::TimeUtil createSimulatedTimeUtil(const std::shared_ptr<SimulationClock> &iclock,
+                                        const double iatTargetError,
+                                        const double iatTargetDerivative,
+                                        const okapi::QTime iatTargetTime) {
+  return okapi::TimeUtil(
+    okapi::Supplier<std::unique_ptr<okapi::AbstractTimer>>(
+      [=]() { return std::make_unique<SimulatedTimer>(iclock); }),
+    okapi::Supplier<std::unique_ptr<okapi::AbstractRate>>(
+      [=]() { return std::make_unique<SimulatedRate>(iclock); }),
+    okapi::Supplier<std::unique_ptr<okapi::SettledUtil>>([=]() {
+      return std::make_unique<okapi::SettledUtil>(std::make_unique<SimulatedTimer>(iclock),
+                                                  iatTargetError,
+                                                  iatTargetDerivative,
+                                                  iatTargetTime);
+    }));
+}
+} // namespace spooder
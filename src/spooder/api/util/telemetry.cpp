@@ -0,0 +1,48 @@
+#include "spooder/api/util/telemetry.hpp"
+#include <mutex>
+
+namespace spooder {
+// Function-local so that global subsystems constructed before main can still read the default
+static std::shared_ptr<Telemetry> &defaultTelemetry() {
+  static std::shared_ptr<Telemetry> telemetry = std::make_shared<Telemetry>();
+  return telemetry;
+}
+
+Telemetry::Telemetry() noexcept : timer(nullptr), file(nullptr) {
+}
+
+Telemetry::Telemetry(std::unique_ptr<okapi::AbstractTimer> itimer, FILE *ifile) noexcept
+  : timer(std::move(itimer)), file(ifile) {
+}
+
+bool Telemetry::isEnabled() const noexcept {
+  return file && timer;
+}
+
+void Telemetry::send(const char *ichannel, const char *iformat, ...) noexcept {
+  if (!isEnabled()) {
+    return;
+  }
+
+  va_list args;
+  va_start(args, iformat);
+
+  std::scoped_lock lock(fileMutex);
+  fprintf(file,
+          "%ld,%s,",
+          static_cast<long>(timer->millis().convert(okapi::millisecond)),
+          ichannel);
+  vfprintf(file, iformat, args);
+  fputc('\n', file);
+
+  va_end(args);
+}
+
+std::shared_ptr<Telemetry> Telemetry::getDefaultTelemetry() {
+  return defaultTelemetry();
+}
+
+void Telemetry::setDefaultTelemetry(std::shared_ptr<Telemetry> itelemetry) {
+  defaultTelemetry() = std::move(itelemetry);
+}
+} // namespace spooder
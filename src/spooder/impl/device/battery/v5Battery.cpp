@@ -0,0 +1,12 @@
+#include "spooder/impl/device/battery/v5Battery.hpp"
+#include "api.h"
+
+namespace spooder {
+std::int32_t V5Battery::getVoltage() {
+  return pros::c::battery_get_voltage();
+}
+
+std::int32_t V5Battery::getCurrent() {
+  return pros::c::battery_get_current();
+}
+} // namespace spooder
@@ -0,0 +1,25 @@
+#include "spooder/impl/device/optical/opticalColorSensor.hpp"
+#include "api.h"
+
+namespace spooder {
+OpticalColorSensor::OpticalColorSensor(const std::uint8_t iport,
+                                       const okapi::QTime iintegrationTime,
+                                       const std::uint8_t iledPower)
+  : sensor(iport) {
+  // OpticalSensor has no call for the integration time, so set it through PROS
+  pros::c::optical_set_integration_time(iport, iintegrationTime.convert(okapi::millisecond));
+  sensor.setLedPWM(iledPower);
+}
+
+double OpticalColorSensor::getHue() {
+  return sensor.getHue();
+}
+
+double OpticalColorSensor::getSaturation() {
+  return sensor.getSaturation();
+}
+
+std::int32_t OpticalColorSensor::getProximity() {
+  return sensor.getProximity();
+}
+} // namespace spooder
@@ -0,0 +1,94 @@
+#include "spooder/impl/device/replayController.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+
+namespace spooder {
+ReplayController::ReplayController(const okapi::ControllerId iid) : okapi::Controller(iid) {
+}
+
+void ReplayController::setReplay(std::shared_ptr<InputReplay> ireplay) {
+  replay = std::move(ireplay);
+}
+
+bool ReplayController::loadReplay(const char *ipath) {
+  // Whatever happens, the last replay must not keep driving: once it ends it locks the driver out
+  setReplay(nullptr);
+
+  // A replay drives the robot with the driver locked out, so never in a match
+  if (pros::competition::is_connected()) {
+    return false;
+  }
+
+  auto log = InputLog::load(ipath);
+  if (!log) {
+    return false;
+  }
+
+  setReplay(std::make_shared<InputReplay>(std::move(log)));
+  return true;
+}
+
+bool ReplayController::isReplaying() const {
+  return replay != nullptr;
+}
+
+void ReplayController::step() {
+  if (replay) {
+    replay->step();
+    frame = replay->getFrame();
+    connected = true;
+    return;
+  }
+
+  // Like okapi::Controller, a disconnected controller reads as centered and released
+  frame = InputFrame{};
+  connected = pros::c::controller_is_connected(prosId);
+  if (!connected) {
+    return;
+  }
+
+  for (std::size_t i = 0; i < InputFrame::analogChannels; i++) {
+    frame.analog[i] = static_cast<std::int8_t>(
+      pros::c::controller_get_analog(prosId, static_cast<pros::controller_analog_e_t>(i)));
+  }
+
+  for (std::size_t i = 0; i < InputFrame::buttons; i++) {
+    const auto button = static_cast<pros::controller_digital_e_t>(i + InputFrame::firstButton);
+    frame.setDigital(i, pros::c::controller_get_digital(prosId, button));
+  }
+}
+
+const InputFrame &ReplayController::getFrame() const {
+  return frame;
+}
+
+bool ReplayController::isConnected() {
+  return connected;
+}
+
+float ReplayController::getAnalog(const okapi::ControllerAnalog ichannel) {
+  return frame.getAnalog(okapi::toUnderlyingType(ichannel));
+}
+
+bool ReplayController::getDigital(const okapi::ControllerDigital ibutton) {
+  return frame.getDigital(okapi::toUnderlyingType(ibutton) - InputFrame::firstButton);
+}
+
+okapi::ControllerButton &ReplayController::operator[](const okapi::ControllerDigital ibtn) {
+  auto &button = buttons.at(okapi::toUnderlyingType(ibtn) - InputFrame::firstButton);
+  if (!button) {
+    button = std::make_unique<Button>(*this, ibtn);
+  }
+  return *button;
+}
+
+ReplayController::Button::Button(const ReplayController &icontroller,
+                                 const okapi::ControllerDigital ibtn)
+  : okapi::ControllerButton(icontroller.okapiId, ibtn),
+    controller(icontroller),
+    button(okapi::toUnderlyingType(ibtn) - InputFrame::firstButton) {
+}
+
+bool ReplayController::Button::currentlyPressed() {
+  return controller.frame.getDigital(button);
+}
+} // namespace spooder
@@ -0,0 +1,27 @@
+#include "spooder/impl/device/vision/v5GoalCamera.hpp"
+#include "api.h"
+
+namespace spooder {
+V5GoalCamera::V5GoalCamera(const std::uint8_t iport, const std::uint32_t isignature)
+  : port(iport), signature(isignature) {
+  pros::c::vision_set_zero_point(port, pros::E_VISION_ZERO_CENTER);
+}
+
+std::size_t V5GoalCamera::getGoals(GoalDetection *odetections, const std::size_t imax) {
+  std::size_t count = 0;
+  for (; count < imax; count++) {
+    // Objects come largest first, and reading past the last one gives an error object
+    const pros::vision_object_s_t object =
+      pros::c::vision_get_by_sig(port, static_cast<std::uint32_t>(count), signature);
+    if (object.signature == VISION_OBJECT_ERR_SIG) {
+      break;
+    }
+
+    odetections[count] = {static_cast<double>(object.x_middle_coord),
+                          static_cast<double>(object.y_middle_coord),
+                          static_cast<double>(object.width),
+                          static_cast<double>(object.height)};
+  }
+  return count;
+}
+} // namespace spooder
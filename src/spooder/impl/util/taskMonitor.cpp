@@ -0,0 +1,227 @@
+#include "spooder/impl/util/taskMonitor.hpp"
+#include "okapi/impl/util/rate.hpp"
+#include <algorithm>
+
+// The kernel's FreeRTOS port keeps stack high-water marks but does not declare them in the public
+// headers. Reference them weakly so that a kernel without them still links, in which case the
+// marks are reported as unknown.
+extern "C" {
+std::uint32_t uxTaskGetStackHighWaterMark(pros::task_t) __attribute__((weak));
+std::uint32_t task_get_stack_high_water_mark(pros::task_t) __attribute__((weak));
+}
+
+namespace spooder {
+static const char *const competitionTaskNames[] = {"User Initialization (PROS)",
+                                                   "User Comp. Init. (PROS)",
+                                                   "User Disabled (PROS)",
+                                                   "User Autonomous (PROS)",
+                                                   "User Operator Control (PROS)"};
+
+static char stateLetter(const pros::task_state_e_t istate) {
+  switch (istate) {
+  case pros::E_TASK_STATE_RUNNING:
+    return 'X';
+  case pros::E_TASK_STATE_READY:
+    return 'R';
+  case pros::E_TASK_STATE_BLOCKED:
+    return 'B';
+  case pros::E_TASK_STATE_SUSPENDED:
+    return 'S';
+  case pros::E_TASK_STATE_DELETED:
+    return 'D';
+  default:
+    return '?';
+  }
+}
+
+TaskMonitor::TaskMonitor(const okapi::QTime isamplePeriod,
+                         const std::int16_t ilcdLine,
+                         std::shared_ptr<Telemetry> itelemetry,
+                         std::shared_ptr<okapi::Logger> ilogger)
+  : samplePeriod(isamplePeriod),
+    lcdLine(ilcdLine),
+    telemetry(std::move(itelemetry)),
+    logger(std::move(ilogger)) {
+  for (const char *name : competitionTaskNames) {
+    watch(name);
+  }
+}
+
+TaskMonitor::~TaskMonitor() {
+  dtorCalled.store(true, std::memory_order_release);
+  delete task;
+}
+
+void TaskMonitor::watch(const std::string &iname) {
+  std::scoped_lock lock(tasksMutex);
+  const auto existing = std::find_if(
+    tasks.begin(), tasks.end(), [&](const WatchedTask &t) { return t.stats.name == iname; });
+  if (existing == tasks.end()) {
+    WatchedTask watched;
+    watched.stats.name = iname;
+    tasks.push_back(std::move(watched));
+  }
+}
+
+std::vector<TaskStats> TaskMonitor::getStats() const {
+  std::scoped_lock lock(tasksMutex);
+  std::vector<TaskStats> out;
+  out.reserve(tasks.size());
+  for (const auto &watched : tasks) {
+    out.push_back(watched.stats);
+  }
+  return out;
+}
+
+std::uint32_t TaskMonitor::getTaskCount() const {
+  std::scoped_lock lock(tasksMutex);
+  return taskCount;
+}
+
+void TaskMonitor::startThread() {
+  if (!task) {
+    task = new CrossplatformThread(trampoline, this, "TaskMonitor");
+  }
+}
+
+CrossplatformThread *TaskMonitor::getThread() const {
+  return task;
+}
+
+void TaskMonitor::trampoline(void *context) {
+  if (context) {
+    static_cast<TaskMonitor *>(context)->loop();
+  }
+}
+
+void TaskMonitor::loop() {
+  okapi::Rate rate;
+  lastSampleMicros = pros::c::micros();
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    rate.delayUntil(samplePeriod);
+    sample();
+  }
+}
+
+void TaskMonitor::sample() {
+  std::scoped_lock lock(tasksMutex);
+
+  const std::uint64_t now = pros::c::micros();
+  const double period = static_cast<double>(now - lastSampleMicros);
+  lastSampleMicros = now;
+  taskCount = pros::c::task_get_count();
+
+  for (auto &watched : tasks) {
+    auto &stats = watched.stats;
+    watched.handle = pros::c::task_get_by_name(stats.name.c_str());
+
+    if (watched.handle) {
+      stats.state = pros::c::task_get_state(watched.handle);
+      stats.priority = pros::c::task_get_priority(watched.handle);
+      stats.stackHighWater = readStackHighWater(watched.handle);
+    } else {
+      stats.state = pros::E_TASK_STATE_INVALID;
+      stats.priority = 0;
+      stats.stackHighWater = -1;
+    }
+
+    if (watched.busyMicros > 0 && period > 0) {
+      stats.cpuShare = std::min(1.0, static_cast<double>(watched.busyMicros) / period);
+    } else if (!std::isnan(stats.cpuShare)) {
+      // Instrumented before but idle for this whole period
+      stats.cpuShare = 0;
+    }
+    watched.busyMicros = 0;
+
+    if (stats.stackHighWater >= 0 && stats.stackHighWater < 64) {
+      LOG_WARN("TaskMonitor: " + stats.name + " has only " +
+               std::to_string(stats.stackHighWater) + " stack words left");
+    }
+
+    if (watched.handle) {
+      telemetry->send("task",
+                      "%s,%c,%lu,%ld,%.3f",
+                      stats.name.c_str(),
+                      stateLetter(stats.state),
+                      static_cast<unsigned long>(stats.priority),
+                      static_cast<long>(stats.stackHighWater),
+                      stats.cpuShare);
+    }
+  }
+
+  telemetry->send("tasks", "%lu", static_cast<unsigned long>(taskCount));
+
+  if (lcdLine >= 0 && !tasks.empty()) {
+    // Show one live task per sample so a single line cycles through all of them
+    for (std::size_t i = 0; i < tasks.size(); i++) {
+      lcdIndex = (lcdIndex + 1) % tasks.size();
+      if (tasks[lcdIndex].handle) {
+        break;
+      }
+    }
+
+    const auto &stats = tasks[lcdIndex].stats;
+    pros::lcd::print(lcdLine,
+                     "%.16s %c p%lu stk%ld cpu%.0f%% (%lu)",
+                     stats.name.c_str(),
+                     stateLetter(stats.state),
+                     static_cast<unsigned long>(stats.priority),
+                     static_cast<long>(stats.stackHighWater),
+                     std::isnan(stats.cpuShare) ? 0.0 : stats.cpuShare * 100,
+                     static_cast<unsigned long>(taskCount));
+  }
+}
+
+void TaskMonitor::addBusyTime(pros::task_t ihandle, const std::uint64_t imicros) {
+  std::scoped_lock lock(tasksMutex);
+
+  for (auto &watched : tasks) {
+    if (watched.handle == ihandle) {
+      watched.busyMicros += imicros;
+      return;
+    }
+  }
+
+  // The handle may not be resolved yet, or be stale because the competition task was recreated on
+  // a mode switch, so match by name before treating the task as a new one
+  const std::string name = pros::c::task_get_name(ihandle);
+  for (auto &watched : tasks) {
+    if (watched.stats.name == name) {
+      watched.handle = ihandle;
+      watched.busyMicros += imicros;
+      return;
+    }
+  }
+
+  // An instrumented task nobody asked to watch; start watching it now
+  WatchedTask watched;
+  watched.stats.name = name;
+  watched.handle = ihandle;
+  watched.busyMicros = imicros;
+  tasks.push_back(std::move(watched));
+}
+
+std::int32_t TaskMonitor::readStackHighWater(pros::task_t ihandle) {
+  if (task_get_stack_high_water_mark) {
+    return static_cast<std::int32_t>(task_get_stack_high_water_mark(ihandle));
+  } else if (uxTaskGetStackHighWaterMark) {
+    return static_cast<std::int32_t>(uxTaskGetStackHighWaterMark(ihandle));
+  }
+  return -1;
+}
+
+TaskMonitor::BusyScope::BusyScope(TaskMonitor &imonitor)
+  : monitor(imonitor), start(pros::c::micros()) {
+}
+
+TaskMonitor::BusyScope::~BusyScope() {
+  finish();
+}
+
+void TaskMonitor::BusyScope::finish() {
+  if (!finished) {
+    finished = true;
+    monitor.addBusyTime(pros::c::task_get_current(), pros::c::micros() - start);
+  }
+}
+} // namespace spooder